@@ -22,6 +22,9 @@ out Vertex {
 	vec3 normal;
 } vertex;
 
+// Same depth in the depth pre-pass and the shading passes
+invariant gl_Position;
+
 
 // Main function
 void main() {
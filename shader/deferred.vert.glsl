@@ -0,0 +1,8 @@
+#version 330 core
+
+// Main function
+void main() {
+	// Triangle covering the screen
+	vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(corner * 2.0F - 1.0F, 0.0F, 1.0F);
+}
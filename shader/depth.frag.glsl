@@ -0,0 +1,5 @@
+#version 330 core
+
+// Main function, only the depth is written
+void main() {
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "vertex.glsl"
+
+#if defined(GBUFFER)
+// G-buffer targets, each program stores its BRDF inputs in them
+layout (location = 0) out vec4 gbuffer_albedo;
+layout (location = 1) out vec4 gbuffer_normal;
+layout (location = 2) out vec4 gbuffer_specular;
+layout (location = 3) out vec4 gbuffer_ambient;
+
+#elif defined(DEFERRED_LIGHTING)
+// G-buffer textures
+uniform sampler2D gbuffer_albedo;
+uniform sampler2D gbuffer_normal;
+uniform sampler2D gbuffer_specular;
+uniform sampler2D gbuffer_ambient;
+uniform sampler2D gbuffer_depth;
+
+// Inverse of the view projection matrix and the viewport corner and size in the window
+uniform mat4 gbuffer_inverse;
+uniform vec4 gbuffer_viewport;
+
+// Out color
+out vec4 color;
+
+
+// Read the position and normal of the pixel
+void read_vertex(ivec2 pixel) {
+	float depth = texelFetch(gbuffer_depth, pixel, 0).r;
+	vec2 coord = (gl_FragCoord.xy - gbuffer_viewport.xy) / gbuffer_viewport.zw;
+	vec4 position = gbuffer_inverse * vec4(vec3(coord, depth) * 2.0F - 1.0F, 1.0F);
+
+	vertex.position = position.xyz / position.w;
+	vertex.uv_coord = vec2(0.0F);
+	vertex.normal = texelFetch(gbuffer_normal, pixel, 0).xyz;
+}
+
+#elif defined(TRANSPARENCY)
+// Transparency targets, the weighted colors with the revealed background and the sum of the weights
+layout (location = 0) out vec4 transparency_accum;
+layout (location = 1) out vec4 transparency_weight;
+
+
+// Accumulate a transparent fragment, the nearest ones weigh more
+void accumulate(vec3 color, float alpha) {
+	float depth = 1.0F / gl_FragCoord.w;
+	float weight = alpha * clamp(10.0F / (1e-5F + pow(depth / 5.0F, 2.0F) + pow(depth / 200.0F, 6.0F)), 1e-2F, 3e3F);
+
+	transparency_accum  = vec4(color * weight, alpha);
+	transparency_weight = vec4(weight, 0.0F, 0.0F, 0.0F);
+}
+
+#else
+// Out color
+out vec4 color;
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+// Light struct
+struct Light {
+	uint type;
+	vec3 direction;
+
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+
+	float ambient_level;
+	float specular_level;
+	float shininess;
+
+	vec3 position;
+	vec3 attenuation;
+	vec2 cutoff;
+
+	int shadow;
+	int shadow_layer;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "light.glsl"
+#include "vertex.glsl"
+#include "shadows.glsl"
+
+// Packed lights, offset and count of the lights of each cluster, and light indices
+uniform samplerBuffer light_data;
+uniform usamplerBuffer light_cluster;
+uniform usamplerBuffer light_index;
+
+// Number of directional lights, they are the first ones and are not clustered
+uniform uint directional_size;
+
+// Clusters grid size, clusters per pixel, and depth slices scale and bias
+uniform uvec3 cluster_size;
+uniform vec2 cluster_scale;
+uniform vec2 cluster_depth;
+uniform vec2 cluster_offset;
+
+// View matrix for the cluster depth
+uniform mat4 view_mat;
+
+
+// Light contribution, defined by the including shader
+vec3 shade(Light light, uint type);
+
+
+// Read a light, each one takes seven texels
+Light get_light(uint i) {
+	int texel = int(i) * 7;
+	vec4 position_type      = texelFetch(light_data, texel);
+	vec4 direction_inner    = texelFetch(light_data, texel + 1);
+	vec4 ambient_level      = texelFetch(light_data, texel + 2);
+	vec4 diffuse_specular   = texelFetch(light_data, texel + 3);
+	vec4 specular_shininess = texelFetch(light_data, texel + 4);
+	vec4 attenuation_outer  = texelFetch(light_data, texel + 5);
+	vec4 shadow_layer       = texelFetch(light_data, texel + 6);
+
+	Light light;
+	light.type           = uint(position_type.w);
+	light.direction      = direction_inner.xyz;
+	light.ambient        = ambient_level.rgb;
+	light.diffuse        = diffuse_specular.rgb;
+	light.specular       = specular_shininess.rgb;
+	light.ambient_level  = ambient_level.w;
+	light.specular_level = diffuse_specular.w;
+	light.shininess      = specular_shininess.w;
+	light.position       = position_type.xyz;
+	light.attenuation    = attenuation_outer.xyz;
+	light.cutoff         = vec2(direction_inner.w, attenuation_outer.w);
+	light.shadow         = int(shadow_layer.x);
+	light.shadow_layer   = int(shadow_layer.y);
+	return light;
+}
+
+// Attenuation and spotlight intensity of a light, the type is a constant in the variants
+vec2 light_falloff(Light light, uint type) {
+	// Default attenuation and intensity
+	float attenuation = 1.0F;
+	float intensity = 1.0F;
+
+	// Attenunation for non directional lights
+	if (type != 0U) {
+		vec3 light_dir = light.position - vertex.position;
+		float dist = length(light_dir);
+		attenuation = 1.0F / (light.attenuation[0] + light.attenuation[1] * dist + light.attenuation[2] * dist * dist);
+
+		// Spotlight intensity
+		if (type == 2U) {
+			float theta = dot(normalize(light_dir), light.direction);
+			float epsilon = light.cutoff[0] - light.cutoff[1];
+			intensity = clamp((theta - light.cutoff[1]) / epsilon, 0.0F, 1.0F);
+		}
+	}
+
+#ifdef SHADOWS
+	// Only the ambient component reaches the shadowed fragments
+	if (intensity > 0.0F)
+		intensity *= light_shadow(light, type);
+#endif
+
+	return vec2(attenuation, intensity);
+}
+
+#ifndef GBUFFER
+// Contribution of the directional lights and the lights of the fragment cluster
+vec3 shade_lights() {
+	vec3 lighting = vec3(0.0F);
+
+	// Directional lights
+#ifdef VARIANT
+	for (uint i = 0U; i < DIRECTIONAL_LIGHTS; i++)
+#else
+	for (uint i = 0U; i < directional_size; i++)
+#endif
+		lighting += shade(get_light(i), 0U);
+
+#if !defined(VARIANT) || defined(HAS_POINT_LIGHTS) || defined(HAS_SPOT_LIGHTS)
+	// Cluster of the fragment
+	float depth = -(view_mat * vec4(vertex.position, 1.0F)).z;
+	uvec3 cluster = uvec3(uvec2((gl_FragCoord.xy - cluster_offset) * cluster_scale), uint(max(log(depth) * cluster_depth.x + cluster_depth.y, 0.0F)));
+	cluster = min(cluster, cluster_size - 1U);
+	uvec2 lights = texelFetch(light_cluster, int(cluster.x + cluster_size.x * (cluster.y + cluster_size.y * cluster.z))).xy;
+
+	// Point and spot lights, the variants with only one of them use a constant type
+	for (uint i = lights.x; i < lights.x + lights.y; i++) {
+		Light light = get_light(texelFetch(light_index, int(i)).r);
+#if defined(VARIANT) && !defined(HAS_SPOT_LIGHTS)
+		lighting += shade(light, 1U);
+#elif defined(VARIANT) && !defined(HAS_POINT_LIGHTS)
+		lighting += shade(light, 2U);
+#else
+		lighting += shade(light, light.type);
+#endif
+	}
+#endif
+
+	return lighting;
+}
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "light.glsl"
+#include "vertex.glsl"
+
+#ifdef SHADOWS
+// Cascades of the directional lights, atlas of the point and spot lights, and the matrices of both
+uniform sampler2DArrayShadow shadow_cascades;
+uniform sampler2DShadow shadow_atlas;
+uniform samplerBuffer shadow_data;
+
+
+// Read a shadow matrix, each one takes four texels
+mat4 get_shadow_matrix(int i) {
+	int texel = i * 4;
+	return mat4(texelFetch(shadow_data, texel),
+	            texelFetch(shadow_data, texel + 1),
+	            texelFetch(shadow_data, texel + 2),
+	            texelFetch(shadow_data, texel + 3));
+}
+
+// Filtered visibility of a cascade, three by three bilinear comparisons
+float filter_cascade(vec3 coord, int layer) {
+	vec2 texel = 1.0F / vec2(textureSize(shadow_cascades, 0).xy);
+	float visibility = 0.0F;
+	for (int y = -1; y <= 1; y++)
+		for (int x = -1; x <= 1; x++)
+			visibility += texture(shadow_cascades, vec4(coord.xy + vec2(x, y) * texel, float(layer), coord.z));
+
+	return visibility / 9.0F;
+}
+
+// Filtered visibility of an atlas tile, the tiles keep a border for the filter
+float filter_atlas(vec3 coord) {
+	vec2 texel = 1.0F / vec2(textureSize(shadow_atlas, 0));
+	float visibility = 0.0F;
+	for (int y = -1; y <= 1; y++)
+		for (int x = -1; x <= 1; x++)
+			visibility += texture(shadow_atlas, vec3(coord.xy + vec2(x, y) * texel, coord.z));
+
+	return visibility / 9.0F;
+}
+
+// Visibility of the fragment from a light, the type is a constant in the variants
+float light_shadow(Light light, uint type) {
+	// Light without shadow map
+	if (light.shadow < 0)
+		return 1.0F;
+
+	// First cascade that contains the fragment with room for the filter
+	if (type == 0U) {
+		vec2 border = 2.0F / vec2(textureSize(shadow_cascades, 0).xy);
+		for (int i = 0; i < SHADOW_CASCADES; i++) {
+			vec3 coord = (get_shadow_matrix(light.shadow + i) * vec4(vertex.position, 1.0F)).xyz;
+			if (all(greaterThan(coord.xy, border)) && all(lessThan(coord.xy, 1.0F - border)) && (coord.z < 1.0F))
+				return filter_cascade(coord, light.shadow_layer + i);
+		}
+
+		return 1.0F;
+	}
+
+	// Cube face of the point lights, in the order +X, -X, +Y, -Y, +Z and -Z
+	int face = 0;
+	if (type == 1U) {
+		vec3 light_dir = vertex.position - light.position;
+		vec3 axis = abs(light_dir);
+		if ((axis.x >= axis.y) && (axis.x >= axis.z))
+			face = (light_dir.x < 0.0F ? 1 : 0);
+		else if (axis.y >= axis.z)
+			face = (light_dir.y < 0.0F ? 3 : 2);
+		else
+			face = (light_dir.z < 0.0F ? 5 : 4);
+	}
+
+	// Fragments behind the light or farther than its range are not shadowed
+	vec4 coord = get_shadow_matrix(light.shadow + face) * vec4(vertex.position, 1.0F);
+	if (coord.w <= 0.0F)
+		return 1.0F;
+
+	coord.xyz /= coord.w;
+	return (coord.z < 1.0F ? filter_atlas(coord.xyz) : 1.0F);
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+#ifdef DEFERRED_LIGHTING
+// Vertex of the pixel, read from the G-buffer
+struct Vertex {
+	vec3 position;
+	vec2 uv_coord;
+	vec3 normal;
+};
+
+Vertex vertex;
+#else
+// In variables
+in Vertex {
+	vec3 position;
+	vec2 uv_coord;
+	vec3 normal;
+} vertex;
+#endif
@@ -1,30 +1,7 @@
 #version 330 core
 
-// Light struct
-struct Light {
-	uint type;
-	vec3 direction;
-
-	vec3 ambient;
-	vec3 diffuse;
-	vec3 specular;
-
-	float ambient_level;
-	float specular_level;
-	float shininess;
-
-	vec3 position;
-	vec3 attenuation;
-	vec2 cutoff;
-};
-
-
-// In variables
-in Vertex {
-	vec3 position;
-	vec2 uv_coord;
-	vec3 normal;
-} vertex;
+#include "include/light.glsl"
+#include "include/vertex.glsl"
 
 
 // Lights data
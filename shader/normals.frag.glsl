@@ -1,11 +1,6 @@
 #version 330 core
 
-// In variables
-in Vertex {
-	vec3 position;
-	vec2 uv_coord;
-	vec3 normal;
-} vertex;
+#include "include/vertex.glsl"
 
 // Out color
 out vec4 color;
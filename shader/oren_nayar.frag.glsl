@@ -1,20 +1,7 @@
 #version 330 core
-#define LIGHTS 5U
 
-// Light struct
-struct Light {
-	uint type;
-	vec3 direction;
-
-	vec3 ambient;
-	vec3 diffuse;
-
-	float ambient_level;
-
-	vec3 position;
-	vec3 attenuation;
-	vec2 cutoff;
-};
+#include "include/lights.glsl"
+#include "include/gbuffer.glsl"
 
 // Material struct
 struct Material {
@@ -23,24 +10,14 @@ struct Material {
 	vec3 specular_color;
 
 	float roughness;
+	float alpha;
 
 	sampler2D ambient_map;
 	sampler2D diffuse_map;
+	sampler2D alpha_map;
 };
 
 
-// In variables
-in Vertex {
-	vec3 position;
-	vec2 uv_coord;
-	vec3 normal;
-} vertex;
-
-
-// Lights data
-uniform Light light[LIGHTS];
-uniform uint light_size;
-
 // Materials
 uniform Material material;
 
@@ -48,61 +25,93 @@ uniform Material material;
 uniform vec3 view_pos;
 
 
-// Out color
-out vec4 color;
+// Material colors, roughness and view direction
+vec3 ambient_tex;
+vec3 diffuse_tex;
+float roughness;
+vec3 view_dir;
+
+
+// Light contribution, the type is a constant in the variants
+vec3 shade(Light light, uint type) {
+	// Attenuation and spotlight intensity
+	vec2 falloff = light_falloff(light, type);
+	float attenuation = falloff.x;
+	float intensity = falloff.y;
+
+	// Dot products
+	float nl = dot(vertex.normal, light.direction);
+	float nv = dot(vertex.normal, view_dir);
+
+	// Oren-Nayar
+	float a = 1.0F - 0.50F * roughness / (roughness + 0.57F);
+	float b =        0.45F * roughness / (roughness + 0.09F);
+	float cos_phi = dot(normalize(view_dir - nv * vertex.normal), normalize(light.direction - nl * vertex.normal));
+	float phi_i   = acos(nl);
+	float phi_r   = acos(nv);
+	float oren_nayar = max(nl, 0.0F) * (a + max(cos_phi, 0.0F) * b * sin(max(phi_i, phi_r)) * tan(min(phi_i, phi_r)));
+
+	// Calcule components colors
+	vec3 ambient  = light.ambient_level * light.ambient * ambient_tex;
+	vec3 diffuse  = oren_nayar          * light.diffuse * diffuse_tex;
+
+	// Light contribution
+	return attenuation * (ambient + intensity * diffuse);
+}
 
 
 // Main function
 void main() {
-	// Texture mapping
-	vec3 ambient_tex    = material.ambient_color  * texture(material.ambient_map,   vertex.uv_coord).rgb;
-    vec3 diffuse_tex    = material.diffuse_color  * texture(material.diffuse_map,   vertex.uv_coord).rgb;
-
-	// View direction and initial color
-	vec3 view_dir = normalize(view_pos - vertex.position);
-	vec3 lighting = vec3(0.0F);
-
-
-	// For each light
-	for (uint i = 0U; i < light_size; i++) {
-		// Default attenuation and intensity
-		float attenuation = 1.0F;
-		float intensity = 1.0F;
-
-		// Attenunation for non directional lights
-		if (light[i].type != 0U) {
-			vec3 light_dir = light[i].position - vertex.position;
-			float dist = length(light_dir);
-			attenuation = 1.0F / (light[i].attenuation[0] + light[i].attenuation[1] * dist + light[i].attenuation[2] * dist * dist);
-
-			// Spotlight intensity
-			if (light[i].type == 2U) {
-				float theta = dot(normalize(light_dir), light[i].direction);
-				float epsilon = light[i].cutoff[0] - light[i].cutoff[1];
-				intensity = clamp((theta - light[i].cutoff[1]) / epsilon, 0.0F, 1.0F);
-			}
-		}
-
-		// Dot products
-		float nl = dot(vertex.normal, light[i].direction);
-		float nv = dot(vertex.normal, view_dir);
-
-		// Oren-Nayar
-		float a = 1.0F - 0.50F * material.roughness / (material.roughness + 0.57F);
-		float b =        0.45F * material.roughness / (material.roughness + 0.09F);
-		float cos_phi = dot(normalize(view_dir - nv * vertex.normal), normalize(light[i].direction - nl * vertex.normal));
-		float phi_i   = acos(nl);
-		float phi_r   = acos(nv);
-		float oren_nayar = max(nl, 0.0F) * (a + max(cos_phi, 0.0F) * b * sin(max(phi_i, phi_r)) * tan(min(phi_i, phi_r)));
-
-		// Calcule components colors
-		vec3 ambient  = light[i].ambient_level * light[i].ambient * ambient_tex;
-		vec3 diffuse  = oren_nayar             * light[i].diffuse * diffuse_tex;
-	
-		// Light contribution
-		lighting += attenuation * (ambient + intensity * diffuse);
-	}
-
-	// Set color
+#ifdef DEFERRED_LIGHTING
+	// Vertex, material colors and roughness of the pixel
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	read_vertex(pixel);
+
+	ambient_tex = texelFetch(gbuffer_ambient, pixel, 0).rgb;
+	diffuse_tex = texelFetch(gbuffer_albedo,  pixel, 0).rgb;
+	roughness   = texelFetch(gbuffer_normal,  pixel, 0).a;
+#else
+	// Alpha test, the transparent variant blends the fragments instead
+#if defined(ALPHA_TEST) || defined(TRANSPARENCY)
+	float alpha = material.alpha;
+#ifdef HAS_ALPHA_MAP
+	alpha *= texture(material.alpha_map, vertex.uv_coord).r;
+#endif
+#ifndef TRANSPARENCY
+	if (alpha < 0.5F)
+		discard;
+#endif
+#endif
+
+	// Material colors, the variants only sample the real texture maps
+	ambient_tex = material.ambient_color;
+	diffuse_tex = material.diffuse_color;
+	roughness   = material.roughness;
+
+#if !defined(VARIANT) || defined(HAS_AMBIENT_MAP)
+	ambient_tex *= texture(material.ambient_map, vertex.uv_coord).rgb;
+#endif
+#if !defined(VARIANT) || defined(HAS_DIFFUSE_MAP)
+	diffuse_tex *= texture(material.diffuse_map, vertex.uv_coord).rgb;
+#endif
+#endif
+
+#ifdef GBUFFER
+	// Store the material colors, normal and roughness
+	gbuffer_albedo   = vec4(diffuse_tex, 1.0F);
+	gbuffer_normal   = vec4(vertex.normal, roughness);
+	gbuffer_specular = vec4(0.0F);
+	gbuffer_ambient  = vec4(ambient_tex, 1.0F);
+#else
+	// View direction and lights contribution
+	view_dir = normalize(view_pos - vertex.position);
+	vec3 lighting = shade_lights();
+
+	// Set color, the transparent fragments are accumulated
+#ifdef TRANSPARENCY
+	accumulate(lighting, alpha);
+#else
 	color = vec4(lighting, 1.0F);
-}
\ No newline at end of file
+#endif
+#endif
+}
@@ -0,0 +1,20 @@
+#version 330 core
+
+// Weighted sum of the transparent colors with the revealed background, and sum of the weights
+uniform sampler2D transparency_accum;
+uniform sampler2D transparency_weight;
+
+// Out color
+out vec4 color;
+
+
+// Main function, the alpha is the revealed background for the blending
+void main() {
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	vec4 accum = texelFetch(transparency_accum, pixel, 0);
+	if (accum.a >= 1.0F)
+		discard;
+
+	float weight = texelFetch(transparency_weight, pixel, 0).r;
+	color = vec4(accum.rgb / max(weight, 1e-5F), accum.a);
+}
@@ -0,0 +1,299 @@
+#include "filewatcher.hpp"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdlib>
+#include <cerrno>
+#endif
+
+#include <iostream>
+#include <cstring>
+
+// File watcher constructor
+FileWatcher::FileWatcher(const double &debounce_time) {
+    enabled = true;
+    debounce = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(debounce_time));
+    last_poll = clock::now();
+
+    // Use inotify when available and poll the modification times otherwise
+#ifdef __linux__
+    instance = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (instance == -1)
+        std::cerr << "warning: could not initialize inotify (" << std::strerror(errno) << "), the files will be polled" << std::endl;
+#else
+    instance = -1;
+#endif
+}
+
+
+// Add a path, the modification time is kept for the polling fallback and the rescans
+void FileWatcher::add(const std::string &path) {
+    path_stock.insert(path);
+    modified[path] = FileWatcher::getModified(path);
+
+    // Polling fallback
+    if (instance == -1)
+        return;
+
+    // Retry later if the directory does not exist yet
+    if (!watch(path)) {
+        std::cerr << "warning: could not watch the directory of `" << path << "' (" << std::strerror(errno) << "), it will be retried" << std::endl;
+        failed.insert(path);
+    }
+}
+
+// Watch the directory of a path, editors usually replace the files instead of writing them
+bool FileWatcher::watch(const std::string &path) {
+#ifdef __linux__
+    std::string directory = FileWatcher::getDirectory(path);
+    char canonical[PATH_MAX];
+    if (realpath(directory.c_str(), canonical) != nullptr)
+        directory = canonical;
+
+    std::map<std::string, directory_data>::iterator watched = directory_stock.find(directory);
+    if (watched == directory_stock.end()) {
+        const int descriptor = inotify_add_watch(instance, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (descriptor == -1)
+            return false;
+
+        watched = directory_stock.emplace(directory, directory_data{descriptor, {}}).first;
+    }
+
+    watched->second.file[FileWatcher::getName(path)].insert(path);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// Remove a path
+void FileWatcher::remove(const std::string &path) {
+    path_stock.erase(path);
+    modified.erase(path);
+    changed.erase(path);
+    failed.erase(path);
+
+    // Remove the path from its directory and the directory if it was the last one
+    const std::string name = FileWatcher::getName(path);
+    for (std::map<std::string, directory_data>::iterator directory = directory_stock.begin(); directory != directory_stock.end(); directory++) {
+        std::map<std::string, std::set<std::string> >::iterator file = directory->second.file.find(name);
+        if ((file == directory->second.file.end()) || (file->second.erase(path) == 0U))
+            continue;
+
+        if (file->second.empty())
+            directory->second.file.erase(file);
+
+#ifdef __linux__
+        if (directory->second.file.empty()) {
+            inotify_rm_watch(instance, directory->second.descriptor);
+            directory_stock.erase(directory);
+        }
+#endif
+        return;
+    }
+}
+
+
+// Read the pending inotify events
+void FileWatcher::read() {
+#ifdef __linux__
+    // Events are aligned to the event struct
+    alignas(inotify_event) char buffer[4096];
+    const clock::time_point now = clock::now();
+
+    ssize_t length;
+    bool overflow = false;
+    while ((length = ::read(instance, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < length; ) {
+            const inotify_event *const event = (const inotify_event *)(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            // Events were lost when the queue overflowed
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            // Skip the events of the directory itself
+            if (event->len == 0U)
+                continue;
+
+            // Find the watched paths of the file, the number of directories is small
+            for (const std::pair<const std::string, directory_data> &directory : directory_stock) {
+                if (directory.second.descriptor != event->wd)
+                    continue;
+
+                const std::map<std::string, std::set<std::string> >::const_iterator file = directory.second.file.find(event->name);
+                if (file != directory.second.file.end())
+                    for (const std::string &path : file->second)
+                        changed[path] = now;
+                break;
+            }
+        }
+    }
+
+    // Compare the modification times of every path to find the lost changes
+    if (overflow) {
+        std::cerr << "warning: the inotify queue overflowed, the watched files will be rescanned" << std::endl;
+        rescan();
+    }
+#endif
+}
+
+// Compare the modification times once per debounce interval
+void FileWatcher::poll() {
+    const clock::time_point now = clock::now();
+    if (now - last_poll < debounce)
+        return;
+    last_poll = now;
+
+    rescan();
+}
+
+// Watch again the paths whose directory could not be watched once per debounce interval, the files that appeared meanwhile are changed
+void FileWatcher::retry() {
+    const clock::time_point now = clock::now();
+    if (failed.empty() || (now - last_poll < debounce))
+        return;
+    last_poll = now;
+
+    for (std::set<std::string>::iterator path = failed.begin(); path != failed.end(); ) {
+        if (!watch(*path)) {
+            path++;
+            continue;
+        }
+
+        const long long time = FileWatcher::getModified(*path);
+        if (time != modified[*path]) {
+            modified[*path] = time;
+            changed[*path] = now;
+        }
+        path = failed.erase(path);
+    }
+}
+
+// Mark the paths whose modification time differs from the last known one
+void FileWatcher::rescan() {
+    const clock::time_point now = clock::now();
+    for (std::pair<const std::string, long long> &file : modified) {
+        const long long time = FileWatcher::getModified(file.first);
+        if (time != file.second) {
+            file.second = time;
+            changed[file.first] = now;
+        }
+    }
+}
+
+
+// Get the directory of a path
+std::string FileWatcher::getDirectory(const std::string &path) {
+    const std::size_t separator = path.find_last_of("/\\");
+    if (separator == std::string::npos)
+        return ".";
+
+    return separator == 0U ? path.substr(0U, 1U) : path.substr(0U, separator);
+}
+
+// Get the file name of a path
+std::string FileWatcher::getName(const std::string &path) {
+    return path.substr(path.find_last_of("/\\") + 1U);
+}
+
+// Get the modification time of a file
+long long FileWatcher::getModified(const std::string &path) {
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+        return -1LL;
+
+    return (long long)status.st_mtime;
+}
+
+
+// Get the paths that changed and had no events during the debounce time
+std::vector<std::string> FileWatcher::update() {
+    std::vector<std::string> result;
+
+    // Collect the events
+    if (instance != -1) {
+        read();
+        retry();
+    }
+    else
+        poll();
+
+    // Drop the changes while disabled
+    if (!enabled) {
+        changed.clear();
+        return result;
+    }
+
+    // Report the settled changes
+    const clock::time_point now = clock::now();
+    for (std::unordered_map<std::string, clock::time_point>::iterator path = changed.begin(); path != changed.end(); ) {
+        if (now - path->second < debounce) {
+            path++;
+            continue;
+        }
+
+        // Keep the modification time for the next rescan
+        modified[path->first] = FileWatcher::getModified(path->first);
+        result.push_back(path->first);
+        path = changed.erase(path);
+    }
+
+    return result;
+}
+
+
+// Get the enabled status
+bool FileWatcher::isEnabled() const {
+    return enabled;
+}
+
+// Get the native notifications status
+bool FileWatcher::isNative() const {
+    return instance != -1;
+}
+
+// Get the number of watched paths
+std::size_t FileWatcher::getPaths() const {
+    return path_stock.size();
+}
+
+
+// Watch only the given paths
+void FileWatcher::setPaths(const std::set<std::string> &paths) {
+    // Remove the paths that are no longer referenced
+    std::vector<std::string> unused;
+    for (const std::string &path : path_stock)
+        if (paths.find(path) == paths.end())
+            unused.push_back(path);
+
+    for (const std::string &path : unused)
+        remove(path);
+
+    // Add the new ones
+    for (const std::string &path : paths)
+        if (!path.empty() && (path_stock.find(path) == path_stock.end()))
+            add(path);
+}
+
+// Set the enabled status
+void FileWatcher::setEnabled(const bool &status) {
+    enabled = status;
+}
+
+
+// File watcher destructor
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (instance != -1)
+        close(instance);
+#endif
+}
@@ -0,0 +1,88 @@
+#ifndef __FILE_WATCHER_HPP_
+#define __FILE_WATCHER_HPP_
+
+#include <unordered_map>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+
+class FileWatcher {
+    private:
+        // Clock of the debounce
+        typedef std::chrono::steady_clock clock;
+
+        // Watched directory
+        struct directory_data {
+            // Watch descriptor
+            int descriptor;
+
+            // Watched file names and their paths as given
+            std::map<std::string, std::set<std::string> > file;
+        };
+
+        // Enabled status
+        bool enabled;
+
+        // Seconds without events before a change is reported
+        clock::duration debounce;
+
+        // inotify instance, -1 without inotify
+        int instance;
+
+        // Watched paths and directories
+        std::set<std::string> path_stock;
+        std::map<std::string, directory_data> directory_stock;
+
+        // Modification times of the polling fallback and of the rescan after lost events, and time of the last poll or retry
+        std::map<std::string, long long> modified;
+        clock::time_point last_poll;
+
+        // Paths whose directory could not be watched, retried on the updates
+        std::set<std::string> failed;
+
+        // Changed paths and their last event
+        std::unordered_map<std::string, clock::time_point> changed;
+
+        // Disable copy and assignation
+        FileWatcher(const FileWatcher &) = delete;
+        FileWatcher &operator = (const FileWatcher &) = delete;
+
+        // Add or remove a path
+        void add(const std::string &path);
+        void remove(const std::string &path);
+
+        // Watch the directory of a path
+        bool watch(const std::string &path);
+
+        // Collect the changes
+        void read();
+        void poll();
+        void retry();
+        void rescan();
+
+        // Split a path in its directory and file name
+        static std::string getDirectory(const std::string &path);
+        static std::string getName(const std::string &path);
+
+        // Modification time of a file, -1 if it does not exist
+        static long long getModified(const std::string &path);
+
+    public:
+        FileWatcher(const double &debounce_time = 0.25);
+
+        std::vector<std::string> update();
+
+        bool isEnabled() const;
+        bool isNative() const;
+        std::size_t getPaths() const;
+
+        void setPaths(const std::set<std::string> &paths);
+        void setEnabled(const bool &status);
+
+
+        ~FileWatcher();
+};
+
+#endif // __FILE_WATCHER_HPP_
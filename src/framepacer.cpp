@@ -0,0 +1,208 @@
+#include "framepacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// Static const definitions
+constexpr const std::size_t FramePacer::HISTORY;
+constexpr const std::size_t FramePacer::MAX_STEPS;
+constexpr const double FramePacer::MAX_FRAME_TIME;
+constexpr const double FramePacer::SLEEP_SLICE;
+constexpr const double FramePacer::OVERSLEEP_WEIGHT;
+constexpr const double FramePacer::STEP;
+
+
+// Frame pacer constructor, the swap interval is set in the current context
+FramePacer::FramePacer() {
+    // Clock
+    frame_start = FramePacer::clock::now();
+    deadline = frame_start;
+
+    // Without limit and with vertical synchronization
+    target_fps = 0.0;
+    setVSync(FramePacer::ON);
+
+    // Fixed steps
+    accumulator = 0.0;
+    steps = 0U;
+
+    // Start expecting a full slice of oversleep
+    oversleep_mean = FramePacer::SLEEP_SLICE;
+    oversleep_variance = 0.0;
+
+    // Frame times
+    history.assign(FramePacer::HISTORY, 0.0F);
+    history_index = 0U;
+    history_count = 0U;
+}
+
+
+// Measure the last frame and add its time to the simulation
+void FramePacer::beginFrame() {
+    const FramePacer::clock::time_point now = FramePacer::clock::now();
+    const double elapsed = std::chrono::duration<double>(now - frame_start).count();
+    frame_start = now;
+
+    // Store the frame time
+    history[history_index] = (float)(elapsed * 1000.0);
+    history_index = (history_index + 1U) % FramePacer::HISTORY;
+    history_count = std::min(history_count + 1U, FramePacer::HISTORY);
+
+    // A long stall is not simulated at once
+    accumulator += std::min(elapsed, FramePacer::MAX_FRAME_TIME);
+    steps = 0U;
+}
+
+// Take one fixed step of the accumulated time, the steps over the limit are dropped
+bool FramePacer::step() {
+    if (accumulator < FramePacer::STEP)
+        return false;
+
+    if (steps == FramePacer::MAX_STEPS) {
+        accumulator = std::fmod(accumulator, FramePacer::STEP);
+        return false;
+    }
+
+    accumulator -= FramePacer::STEP;
+    steps++;
+    return true;
+}
+
+// Wait until the end of the frame for the target rate, sleeping while the expected oversleep fits and spinning the rest
+void FramePacer::limit() {
+    if (target_fps <= 0.0)
+        return;
+
+    // Next deadline, a frame late or more starts again from now instead of rushing the next frames
+    const FramePacer::clock::duration period = std::chrono::duration_cast<FramePacer::clock::duration>(std::chrono::duration<double>(1.0 / target_fps));
+    FramePacer::clock::time_point now = FramePacer::clock::now();
+    deadline += period;
+    if (deadline + period < now) {
+        deadline = now;
+        return;
+    }
+
+    // Sleep in short slices and learn how much each one oversleeps
+    while (std::chrono::duration<double>(deadline - now).count() > oversleep_mean + std::sqrt(oversleep_variance) + FramePacer::SLEEP_SLICE) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(FramePacer::SLEEP_SLICE));
+        const FramePacer::clock::time_point wake = FramePacer::clock::now();
+        const double oversleep = std::chrono::duration<double>(wake - now).count() - FramePacer::SLEEP_SLICE;
+        now = wake;
+
+        const double delta = oversleep - oversleep_mean;
+        oversleep_mean += FramePacer::OVERSLEEP_WEIGHT * delta;
+        oversleep_variance = (1.0 - FramePacer::OVERSLEEP_WEIGHT) * (oversleep_variance + FramePacer::OVERSLEEP_WEIGHT * delta * delta);
+    }
+
+    // Spin until the deadline
+    while (FramePacer::clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+// Restart the clock after waiting without drawing, the time waited is neither simulated nor measured
+void FramePacer::skip() {
+    frame_start = FramePacer::clock::now();
+    deadline = frame_start;
+}
+
+
+// Set the target frame rate, zero to disable the limit
+void FramePacer::setTargetFPS(const double &fps) {
+    target_fps = std::max(fps, 0.0);
+    deadline = FramePacer::clock::now();
+}
+
+// Set the swap interval, the adaptive one falls back to the synchronized one when the tear control is missing
+void FramePacer::setVSync(const FramePacer::VSync &mode) {
+    vsync = ((mode == FramePacer::ADAPTIVE) && !FramePacer::isAdaptiveSupported() ? FramePacer::ON : mode);
+
+    switch (vsync) {
+        case FramePacer::OFF:      glfwSwapInterval(0);  break;
+        case FramePacer::ON:       glfwSwapInterval(1);  break;
+        case FramePacer::ADAPTIVE: glfwSwapInterval(-1); break;
+    }
+}
+
+
+// Get the target frame rate
+double FramePacer::getTargetFPS() const {
+    return target_fps;
+}
+
+// Get the swap interval mode
+FramePacer::VSync FramePacer::getVSync() const {
+    return vsync;
+}
+
+// Get the fraction of step not simulated yet, to interpolate between the last two steps
+double FramePacer::getAlpha() const {
+    return accumulator / FramePacer::STEP;
+}
+
+// Get the steps run in the current frame
+std::size_t FramePacer::getSteps() const {
+    return steps;
+}
+
+
+// Get the milliseconds of the last frame
+float FramePacer::getFrameTime() const {
+    return history[(history_index + FramePacer::HISTORY - 1U) % FramePacer::HISTORY];
+}
+
+// Get the average milliseconds of the stored frames
+float FramePacer::getAverageFrameTime() const {
+    if (history_count == 0U)
+        return 0.0F;
+
+    double sum = 0.0;
+    for (std::size_t i = 0U; i < history_count; i++)
+        sum += history[i];
+
+    return (float)(sum / history_count);
+}
+
+// Get the standard deviation in milliseconds of the stored frames
+float FramePacer::getJitter() const {
+    if (history_count == 0U)
+        return 0.0F;
+
+    const double average = getAverageFrameTime();
+    double sum = 0.0;
+    for (std::size_t i = 0U; i < history_count; i++)
+        sum += (history[i] - average) * (history[i] - average);
+
+    return (float)std::sqrt(sum / history_count);
+}
+
+// Get the shortest stored frame
+float FramePacer::getMinFrameTime() const {
+    return (history_count > 0U ? *std::min_element(history.begin(), history.begin() + history_count) : 0.0F);
+}
+
+// Get the longest stored frame
+float FramePacer::getMaxFrameTime() const {
+    return (history_count > 0U ? *std::max_element(history.begin(), history.begin() + history_count) : 0.0F);
+}
+
+// Get the frame times ring
+const std::vector<float> &FramePacer::getHistory() const {
+    return history;
+}
+
+// Get the number of stored frames
+std::size_t FramePacer::getHistoryCount() const {
+    return history_count;
+}
+
+// Get the position of the oldest frame in the ring
+std::size_t FramePacer::getHistoryOffset() const {
+    return (history_count == FramePacer::HISTORY ? history_index : 0U);
+}
+
+
+// Check the support of the swap interval that tears the late frames
+bool FramePacer::isAdaptiveSupported() {
+    return (glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE) || (glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE);
+}
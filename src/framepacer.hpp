@@ -0,0 +1,85 @@
+#ifndef __FRAME_PACER_HPP_
+#define __FRAME_PACER_HPP_
+
+#include "glad/glad.h"
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <vector>
+
+class FramePacer {
+    public:
+        enum VSync : int {
+            OFF,
+            ON,
+            ADAPTIVE
+        };
+
+    private:
+        typedef std::chrono::steady_clock clock;
+
+        // Start of the current frame and end of the frame for the target rate
+        FramePacer::clock::time_point frame_start;
+        FramePacer::clock::time_point deadline;
+
+        // Target rate, zero without limit, and swap interval mode
+        double target_fps;
+        FramePacer::VSync vsync;
+
+        // Time not simulated yet by the fixed steps and steps run in the current frame
+        double accumulator;
+        std::size_t steps;
+
+        // Mean and variance of the time slept over the requested one
+        double oversleep_mean;
+        double oversleep_variance;
+
+        // Milliseconds of the last frames in a ring and its next position
+        std::vector<float> history;
+        std::size_t history_index;
+        std::size_t history_count;
+
+        // Disable copy and assignation
+        FramePacer(const FramePacer &) = delete;
+        FramePacer &operator = (const FramePacer &) = delete;
+
+        // Static const attributes
+        static constexpr const std::size_t HISTORY = 240U;
+        static constexpr const std::size_t MAX_STEPS = 8U;
+        static constexpr const double MAX_FRAME_TIME = 0.25;
+        static constexpr const double SLEEP_SLICE = 0.001;
+        static constexpr const double OVERSLEEP_WEIGHT = 0.05;
+
+    public:
+        // Time simulated by each fixed step
+        static constexpr const double STEP = 1.0 / 120.0;
+
+        FramePacer();
+
+        void beginFrame();
+        bool step();
+        void limit();
+        void skip();
+
+        void setTargetFPS(const double &fps);
+        void setVSync(const FramePacer::VSync &mode);
+
+        double getTargetFPS() const;
+        FramePacer::VSync getVSync() const;
+        double getAlpha() const;
+        std::size_t getSteps() const;
+
+        float getFrameTime() const;
+        float getAverageFrameTime() const;
+        float getJitter() const;
+        float getMinFrameTime() const;
+        float getMaxFrameTime() const;
+        const std::vector<float> &getHistory() const;
+        std::size_t getHistoryCount() const;
+        std::size_t getHistoryOffset() const;
+
+
+        static bool isAdaptiveSupported();
+};
+
+#endif // __FRAME_PACER_HPP_
@@ -0,0 +1,177 @@
+#include "gbuffer.hpp"
+
+#include <iostream>
+
+// Static definitions
+std::string GBuffer::screen_shader;
+
+// Static const definitions
+constexpr const GLenum GBuffer::FORMAT[];
+constexpr const std::size_t GBuffer::BYTES[];
+constexpr const char *const GBuffer::SAMPLER[];
+constexpr const std::size_t GBuffer::TARGETS;
+constexpr const GLenum GBuffer::UNIT;
+constexpr const GLint GBuffer::MAX_PROGRAMS;
+
+
+// G-buffer constructor
+GBuffer::GBuffer(const int &width_res, const int &height_res) {
+    width = width_res;
+    height = height_res;
+
+    // Textures sampled per pixel
+    glGenTextures((GLsizei)GBuffer::TARGETS, texture);
+    glGenTextures(1, &depth);
+    for (const GLuint &target : {texture[0], texture[1], texture[2], texture[3], depth}) {
+        glBindTexture(GL_TEXTURE_2D, target);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    allocate();
+
+    // Framebuffer with all the targets
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    for (std::size_t i = 0U; i < GBuffer::TARGETS; i++)
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum)i, GL_TEXTURE_2D, texture[i], 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+
+    const GLenum attachment[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3};
+    glDrawBuffers((GLsizei)GBuffer::TARGETS, attachment);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "error: the G-buffer framebuffer is not complete" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // The screen triangle has no attributes
+    glGenVertexArrays(1, &vao);
+}
+
+
+// Allocate the textures with the current resolution
+void GBuffer::allocate() {
+    for (std::size_t i = 0U; i < GBuffer::TARGETS; i++) {
+        glBindTexture(GL_TEXTURE_2D, texture[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GBuffer::FORMAT[i], width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, depth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+// Start the geometry pass, the models write the stencil value of their program
+void GBuffer::begin() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glStencilMask(0xFF);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    glEnable(GL_STENCIL_TEST);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+}
+
+// Set the stencil value of the next models
+void GBuffer::mark(const GLint &slot) const {
+    glStencilFunc(GL_ALWAYS, slot, 0xFF);
+}
+
+// Copy the depth and stencil to the default framebuffer and bind the targets for the lighting passes
+void GBuffer::resolve() const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // The stencil only selects the pixels of each program
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+
+    for (std::size_t i = 0U; i < GBuffer::TARGETS; i++) {
+        glActiveTexture(GL_TEXTURE0 + GBuffer::UNIT + (GLenum)i);
+        glBindTexture(GL_TEXTURE_2D, texture[i]);
+    }
+    glActiveTexture(GL_TEXTURE0 + GBuffer::UNIT + (GLenum)GBuffer::TARGETS);
+    glBindTexture(GL_TEXTURE_2D, depth);
+
+    glBindVertexArray(vao);
+}
+
+// Shade the pixels of a program with its lighting variant, the origin is the corner of the camera viewport in the window
+void GBuffer::shade(GLSLProgram *const program, const Camera *const camera, const GLint &slot, const glm::ivec2 &origin) const {
+    if (!program->isValid())
+        return;
+
+    program->use();
+    for (std::size_t i = 0U; i <= GBuffer::TARGETS; i++)
+        program->setUniform(GBuffer::SAMPLER[i], (GLint)(GBuffer::UNIT + i));
+
+    // Positions are reconstructed from the depth
+    program->setUniform("gbuffer_inverse", glm::inverse(camera->getProjectionMatrix() * camera->getViewMatrix()));
+    program->setUniform("gbuffer_viewport", glm::vec4(glm::vec2(origin), glm::vec2(camera->getResolution())));
+
+    glStencilFunc(GL_EQUAL, slot, 0xFF);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+// Restore the state of the forward passes
+void GBuffer::end() const {
+    glBindVertexArray(0);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+}
+
+
+// Get the memory of the targets in bytes
+std::size_t GBuffer::getMemory() const {
+    std::size_t bytes = 4U;
+    for (std::size_t i = 0U; i < GBuffer::TARGETS; i++)
+        bytes += GBuffer::BYTES[i];
+
+    return (std::size_t)width * (std::size_t)height * bytes;
+}
+
+
+// Set the resolution and allocate the textures again
+void GBuffer::setResolution(const int &width_res, const int &height_res) {
+    if ((width_res == width) && (height_res == height))
+        return;
+
+    width = width_res;
+    height = height_res;
+    allocate();
+}
+
+
+// Check that the default framebuffer depth and stencil can be copied from the G-buffer
+bool GBuffer::isSupported() {
+    GLint depth_bits = 0;
+    GLint stencil_bits = 0;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depth_bits);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencil_bits);
+    return (depth_bits == 24) && (stencil_bits == 8);
+}
+
+// Get the vertex shader of the lighting passes
+std::string GBuffer::getScreenShader() {
+    return GBuffer::screen_shader;
+}
+
+// Set the vertex shader of the lighting passes
+void GBuffer::setScreenShader(const std::string &path) {
+    GBuffer::screen_shader = path;
+}
+
+
+// G-buffer destructor
+GBuffer::~GBuffer() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures((GLsizei)GBuffer::TARGETS, texture);
+    glDeleteTextures(1, &depth);
+}
@@ -0,0 +1,65 @@
+#ifndef __G_BUFFER_HPP_
+#define __G_BUFFER_HPP_
+
+#include "camera.hpp"
+#include "glslprogram.hpp"
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+
+#include <string>
+
+class GBuffer {
+    private:
+        // Framebuffer, color targets, depth and stencil texture, and vertex array of the screen triangle
+        GLuint fbo;
+        GLuint texture[4];
+        GLuint depth;
+        GLuint vao;
+
+        // Resolution
+        int width;
+        int height;
+
+        // Disable copy and assignation
+        GBuffer(const GBuffer &) = delete;
+        GBuffer &operator = (const GBuffer &) = delete;
+
+        // Allocate the textures with the current resolution
+        void allocate();
+
+        // Static attributes
+        static std::string screen_shader;
+
+        // Static const attributes
+        static constexpr const GLenum FORMAT[] = {GL_RGBA8, GL_RGBA16F, GL_RGBA8, GL_RGBA8};
+        static constexpr const std::size_t BYTES[] = {4U, 8U, 4U, 4U};
+        static constexpr const char *const SAMPLER[] = {"gbuffer_albedo", "gbuffer_normal", "gbuffer_specular", "gbuffer_ambient", "gbuffer_depth"};
+
+    public:
+        // Color targets, first texture unit and stencil values of the programs
+        static constexpr const std::size_t TARGETS = 4U;
+        static constexpr const GLenum UNIT = 8U;
+        static constexpr const GLint MAX_PROGRAMS = 255;
+
+        GBuffer(const int &width_res, const int &height_res);
+
+        void begin() const;
+        void mark(const GLint &slot) const;
+        void resolve() const;
+        void shade(GLSLProgram *const program, const Camera *const camera, const GLint &slot, const glm::ivec2 &origin = glm::ivec2(0)) const;
+        void end() const;
+
+        std::size_t getMemory() const;
+
+        void setResolution(const int &width_res, const int &height_res);
+
+
+        static bool isSupported();
+        static std::string getScreenShader();
+        static void setScreenShader(const std::string &path);
+
+        ~GBuffer();
+};
+
+#endif // __G_BUFFER_HPP_
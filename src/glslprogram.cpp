@@ -1,5 +1,6 @@
 #include "glslprogram.hpp"
 #include "glslexception.hpp"
+#include "programcache.hpp"
 
 #include <string>
 #include <sstream>
@@ -11,6 +12,7 @@
 GLSLProgram::GLSLProgram() {
     // Initialize program ID
     program = GL_FALSE;
+    pending = false;
 
     // Empty shaders
     vert = nullptr;
@@ -24,13 +26,36 @@ GLSLProgram::GLSLProgram() {
 }
 
 
-// Create, compile, attach and delete shader
+// Submit the shaders compilation and the program link without waiting for them
 void GLSLProgram::link() {
+    pending = false;
+
+    // Use the binary of the same sources if it has been cached
+    key = ProgramCache::getKey(getSources());
+    program = ProgramCache::load(key);
+    if (program != GL_FALSE)
+        return;
+
+    // Submit the shaders compilation
+    for (Shader *const shader : {vert, tesc, tese, geom, frag}) {
+        if (shader == nullptr) continue;
+
+        try {
+            shader->submit();
+        } catch (GLSLException &exception) {
+            std::cerr << exception.what() << std::endl;
+        }
+    }
+
     // Create program and check it
     program = glCreateProgram();
     if (program == GL_FALSE)
         throw GLSLException("could not create the program object");
 
+    // Allow to retrieve the binary
+    if (ProgramCache::isEnabled())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     // Attach shaders
     if ((vert != nullptr) && vert->isValid()) glAttachShader(program, vert->getID());
     if ((tesc != nullptr) && tesc->isValid()) glAttachShader(program, tesc->getID());
@@ -38,8 +63,25 @@ void GLSLProgram::link() {
     if ((geom != nullptr) && geom->isValid()) glAttachShader(program, geom->getID());
     if ((frag != nullptr) && frag->isValid()) glAttachShader(program, frag->getID());
 
-    // Link the program
+    // Link the program, the result is checked later
     glLinkProgram(program);
+    pending = true;
+}
+
+// Check the shaders and the program, it waits for the compilation and link
+void GLSLProgram::finish() {
+    pending = false;
+
+    // Print the compilation errors
+    for (Shader *const shader : {vert, tesc, tese, geom, frag}) {
+        if (shader == nullptr) continue;
+
+        try {
+            shader->check();
+        } catch (GLSLException &exception) {
+            std::cerr << exception.what() << std::endl;
+        }
+    }
 
 	// Delete shaders
 	if (vert != nullptr) glDeleteShader(vert->getID());
@@ -77,6 +119,66 @@ void GLSLProgram::link() {
         // Throw exception
         throw GLSLException(msg);
     }
+
+    // Store the binary for the next time
+    ProgramCache::store(key, program);
+}
+
+// Get the sources of all stages
+std::string GLSLProgram::getSources() const {
+    std::string sources;
+    for (const Shader *const shader : {vert, tesc, tese, geom, frag}) {
+        if (shader == nullptr) continue;
+
+        sources.append(std::to_string(shader->getType())).append(":").append(std::to_string(shader->getSource().size())).append(":");
+        sources.append(shader->getSource());
+    }
+
+    return sources;
+}
+
+// Take the program and shaders of other program
+void GLSLProgram::assign(GLSLProgram *const source) {
+	// Destroy program and shaders
+	glDeleteProgram(program);
+    if (vert != nullptr) delete vert;
+    if (tesc != nullptr) delete tesc;
+    if (tese != nullptr) delete tese;
+    if (geom != nullptr) delete geom;
+    if (frag != nullptr) delete frag;
+
+	// The variants were compiled from the previous sources
+	clearVariants();
+	define_stock.clear();
+
+	// Take the source program
+	program = source->program;
+	vert = source->vert;
+	tesc = source->tesc;
+	tese = source->tese;
+	geom = source->geom;
+	frag = source->frag;
+	shaders = source->shaders;
+	pending = source->pending;
+	key = source->key;
+	location.clear();
+
+	// Empty the source
+	source->program = GL_FALSE;
+	source->vert = nullptr;
+	source->tesc = nullptr;
+	source->tese = nullptr;
+	source->geom = nullptr;
+	source->frag = nullptr;
+	source->shaders = 0;
+	source->pending = false;
+}
+
+// Delete the compiled variants
+void GLSLProgram::clearVariants() {
+	for (std::pair<const std::string, GLSLProgram *> &variant : variant_stock)
+		delete variant.second;
+	variant_stock.clear();
 }
 
 // Get uniform location
@@ -101,6 +203,7 @@ GLint GLSLProgram::getUniformLocation(const char *name) {
 GLSLProgram::GLSLProgram(const std::string &vert_path, const std::string &frag_path) {
 	// Initialize program ID
 	program = GL_FALSE;
+	pending = false;
 
 	// Load shaders
 	vert = (!vert_path.empty() ? new Shader(vert_path, GL_VERTEX_SHADER)   : nullptr);
@@ -126,6 +229,7 @@ GLSLProgram::GLSLProgram(const std::string &vert_path, const std::string &frag_p
 GLSLProgram::GLSLProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path) {
 	// Initialize program ID
 	program = GL_FALSE;
+	pending = false;
 
 	// Load shaders
 	vert = (!vert_path.empty() ? new Shader(vert_path, GL_VERTEX_SHADER)   : nullptr);
@@ -148,16 +252,17 @@ GLSLProgram::GLSLProgram(const std::string &vert_path, const std::string &geom_p
 }
 
 // GLSL program constructor
-GLSLProgram::GLSLProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path) {
+GLSLProgram::GLSLProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path, const std::string &defines) {
     // Initialize program ID
     program = GL_FALSE;
+    pending = false;
     
     // Load shaders
-    vert = (!vert_path.empty() ? new Shader(vert_path, GL_VERTEX_SHADER)          : nullptr);
-	tesc = (!tesc_path.empty() ? new Shader(tesc_path, GL_TESS_CONTROL_SHADER)    : nullptr);
-	tese = (!tese_path.empty() ? new Shader(tese_path, GL_TESS_EVALUATION_SHADER) : nullptr);
-	geom = (!geom_path.empty() ? new Shader(geom_path, GL_GEOMETRY_SHADER)        : nullptr);
-	frag = (!frag_path.empty() ? new Shader(frag_path, GL_FRAGMENT_SHADER)        : nullptr);
+    vert = (!vert_path.empty() ? new Shader(vert_path, GL_VERTEX_SHADER, defines)          : nullptr);
+	tesc = (!tesc_path.empty() ? new Shader(tesc_path, GL_TESS_CONTROL_SHADER, defines)    : nullptr);
+	tese = (!tese_path.empty() ? new Shader(tese_path, GL_TESS_EVALUATION_SHADER, defines) : nullptr);
+	geom = (!geom_path.empty() ? new Shader(geom_path, GL_GEOMETRY_SHADER, defines)        : nullptr);
+	frag = (!frag_path.empty() ? new Shader(frag_path, GL_FRAGMENT_SHADER, defines)        : nullptr);
 
     // Count the number of shaders
     shaders = (vert != nullptr) + (tesc != nullptr) + (tese != nullptr) + (geom != nullptr) + (frag != nullptr);
@@ -170,14 +275,94 @@ GLSLProgram::GLSLProgram(const std::string &vert_path, const std::string &tesc_p
     }
 }
 
+// Get the program compiled with the defines, the variants are compiled on first use
+GLSLProgram *GLSLProgram::getVariant(const std::string &defines) {
+    // Use this program until the variant is ready or if it is not valid
+    GLSLProgram *const variant = findVariant(defines);
+    return (variant != nullptr ? variant : this);
+}
+
+// Get the variant of some defines, optionally with other vertex shader, it is null until the variant is ready or if it is not valid
+GLSLProgram *GLSLProgram::findVariant(const std::string &defines, const std::string &vert_path) {
+    if (defines.empty() || !isValid())
+        return nullptr;
+
+    // The variants of other vertex shader are also keyed by its path
+    const std::string variant_key = (vert_path.empty() ? defines : vert_path + "\n" + defines);
+
+    // Search compiled variant
+    std::map<std::string, GLSLProgram *>::iterator result = variant_stock.find(variant_key);
+    if (result == variant_stock.end()) {
+        // Only the programs with variant code paths are compiled again
+        GLSLProgram *variant = nullptr;
+        if (supports("VARIANT")) {
+            variant = new GLSLProgram(
+                !vert_path.empty() ? vert_path : (vert != nullptr ? vert->getPath() : ""),
+                tesc != nullptr ? tesc->getPath() : "",
+                tese != nullptr ? tese->getPath() : "",
+                geom != nullptr ? geom->getPath() : "",
+                frag != nullptr ? frag->getPath() : "",
+                defines);
+        }
+
+        result = variant_stock.emplace(variant_key, variant).first;
+    }
+
+    GLSLProgram *const variant = result->second;
+    return ((variant != nullptr) && variant->update() && variant->isValid() ? variant : nullptr);
+}
+
+// Check if the sources have a code path for a define
+bool GLSLProgram::supports(const std::string &define) {
+    std::map<std::string, bool>::const_iterator result = define_stock.find(define);
+    if (result == define_stock.end())
+        result = define_stock.emplace(define, getSources().find(define) != std::string::npos).first;
+
+    return result->second;
+}
+
+// Check the pending program if the compilation has finished, without parallel compilation it waits for it
+bool GLSLProgram::update() {
+    if (!pending)
+        return true;
+
+    // Poll the completion status
+    if (GLSLProgram::isParallel()) {
+        GLint status;
+        glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &status);
+        if (status == GL_FALSE)
+            return false;
+    }
+
+    wait();
+    return true;
+}
+
+// Wait for the pending program
+void GLSLProgram::wait() {
+    if (!pending)
+        return;
+
+    try {
+        finish();
+    } catch (GLSLException &exception) {
+        std::cerr << exception.what() << std::endl;
+    }
+}
+
 // Use the program
 void GLSLProgram::use() const {
     glUseProgram(program);
 }
 
-// Check the program status
+// Check the program status, pending programs are not valid yet
 bool GLSLProgram::isValid() const {
-    return program != GL_FALSE;
+    return (program != GL_FALSE) && !pending;
+}
+
+// Get the pending status
+bool GLSLProgram::isPending() const {
+    return pending;
 }
 
 
@@ -216,6 +401,11 @@ void GLSLProgram::setUniform(const std::string &name, const glm::vec4 &vector) {
     glUniform4f(location, vector.x, vector.y, vector.z, vector.w);
 }
 
+void GLSLProgram::setUniform(const std::string &name, const glm::uvec3 &vector) {
+    const GLint location = getUniformLocation(name.c_str());
+    glUniform3ui(location, vector.x, vector.y, vector.z);
+}
+
 void GLSLProgram::setUniform(const std::string &name, const glm::mat3 &matrix) {
     const GLint location = getUniformLocation(name.c_str());
     glUniformMatrix3fv(location, 1, GL_FALSE, &matrix[0][0]);
@@ -250,9 +440,36 @@ unsigned int GLSLProgram::getShaders() const {
     return shaders;
 }
 
+// Get the files of all stages including the included ones
+std::set<std::string> GLSLProgram::getDependencies() const {
+    std::set<std::string> dependency;
+    for (const Shader *const shader : {vert, tesc, tese, geom, frag})
+        if (shader != nullptr)
+            dependency.insert(shader->getFiles().begin(), shader->getFiles().end());
+
+    return dependency;
+}
+
+// Get the parallel compilation support
+bool GLSLProgram::isParallel() {
+    return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
+// Get the number of compiled variants
+std::size_t GLSLProgram::getVariants() const {
+    std::size_t count = 0U;
+    for (const std::pair<const std::string, GLSLProgram *> &variant : variant_stock)
+        count += (variant.second != nullptr);
+
+    return count;
+}
+
 
 // Delete program
 GLSLProgram::~GLSLProgram() {
+	// Delete variants
+	clearVariants();
+
 	// Destroy program
 	glDeleteProgram(program);
 	program = GL_FALSE;
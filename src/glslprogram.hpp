@@ -7,6 +7,7 @@
 #include <glm/glm.hpp>
 
 #include <map>
+#include <set>
 #include <string>
 
 class GLSLProgram {
@@ -32,23 +33,51 @@ class GLSLProgram {
         // Number of shaders
         unsigned int shaders;
 
+		// Compiled variants by their defines
+		std::map<std::string, GLSLProgram *> variant_stock;
+
+		// Defines with code paths in the sources
+		std::map<std::string, bool> define_stock;
+
 		// Uniform locations
 		std::map<std::string, GLint> location;
 
         // Empty GLSL program constructor
         GLSLProgram();
 
-		// Link program
+		// Binary cache key and pending compilation status
+		std::string key;
+		bool pending;
+
+		// Submit the link of the program and check it later
 		void link();
+		void finish();
+
+		// Get the sources of all stages
+		std::string getSources() const;
+
+		// Take the program and shaders of other program
+		void assign(GLSLProgram *const source);
+
+		// Delete the compiled variants
+		void clearVariants();
 		
 
     public:
 		GLSLProgram(const std::string &vert_path, const std::string &frag_path);
 		GLSLProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path);
-        GLSLProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path);
+        GLSLProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path, const std::string &defines = "");
+
+        GLSLProgram *getVariant(const std::string &defines);
+        GLSLProgram *findVariant(const std::string &defines, const std::string &vert_path = "");
+        bool supports(const std::string &define);
+
+        bool update();
+        void wait();
         
         void use() const;
         bool isValid() const;
+        bool isPending() const;
 
         void setUniform(const std::string &name, const GLint &scalar);
         void setUniform(const std::string &name, const GLuint &scalar);
@@ -60,6 +89,8 @@ class GLSLProgram {
         void setUniform(const std::string &name, const glm::vec3 &vector);
         void setUniform(const std::string &name, const glm::vec4 &vector);
 
+        void setUniform(const std::string &name, const glm::uvec3 &vector);
+
         void setUniform(const std::string &name, const glm::mat3 &matrix);
         void setUniform(const std::string &name, const glm::mat4 &matrix);
 
@@ -67,6 +98,11 @@ class GLSLProgram {
 
 		const Shader *getShader(const GLenum &type) const;
         unsigned int getShaders() const;
+        std::set<std::string> getDependencies() const;
+        std::size_t getVariants() const;
+
+
+        static bool isParallel();
 
         ~GLSLProgram();
 };
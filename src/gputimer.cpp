@@ -0,0 +1,68 @@
+#include "gputimer.hpp"
+
+// Static const definitions
+constexpr const std::size_t GPUTimer::FRAMES;
+
+
+// GPU timer constructor
+GPUTimer::GPUTimer(const std::size_t &timestamps) {
+    stamps = timestamps;
+    frame = 0U;
+
+    // The results are read some frames later to not stall the pipeline
+    query.resize(GPUTimer::FRAMES * stamps);
+    issued.assign(GPUTimer::FRAMES * stamps, false);
+    elapsed.assign(stamps > 0U ? stamps - 1U : 0U, 0.0);
+    glGenQueries((GLsizei)query.size(), query.data());
+}
+
+
+// Record a timestamp of the current frame
+void GPUTimer::stamp(const std::size_t &index) {
+    const std::size_t slot = frame * stamps + index;
+    glQueryCounter(query[slot], GL_TIMESTAMP);
+    issued[slot] = true;
+}
+
+// Start the next frame and read the timestamps of the oldest one if they are available
+void GPUTimer::next() {
+    frame = (frame + 1U) % GPUTimer::FRAMES;
+    const std::size_t first = frame * stamps;
+
+    // Read only the frames with all the timestamps
+    bool complete = true;
+    for (std::size_t i = 0U; i < stamps; i++)
+        complete &= issued[first + i];
+
+    GLint available = GL_FALSE;
+    if (complete && (stamps > 0U))
+        glGetQueryObjectiv(query[first + stamps - 1U], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    // Convert the nanoseconds between consecutive timestamps
+    if (available == GL_TRUE) {
+        GLuint64 previous;
+        glGetQueryObjectui64v(query[first], GL_QUERY_RESULT, &previous);
+        for (std::size_t i = 1U; i < stamps; i++) {
+            GLuint64 current;
+            glGetQueryObjectui64v(query[first + i], GL_QUERY_RESULT, &current);
+            elapsed[i - 1U] = (double)(current - previous) / 1.0E6;
+            previous = current;
+        }
+    }
+
+    // The queries of the frame are issued again
+    for (std::size_t i = 0U; i < stamps; i++)
+        issued[first + i] = false;
+}
+
+
+// Get the milliseconds between a timestamp and the next one
+double GPUTimer::getElapsed(const std::size_t &index) const {
+    return elapsed[index];
+}
+
+
+// GPU timer destructor
+GPUTimer::~GPUTimer() {
+    glDeleteQueries((GLsizei)query.size(), query.data());
+}
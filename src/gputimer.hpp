@@ -0,0 +1,39 @@
+#ifndef __GPU_TIMER_HPP_
+#define __GPU_TIMER_HPP_
+
+#include "glad/glad.h"
+
+#include <vector>
+
+class GPUTimer {
+    private:
+        // Timestamp queries of each frame in flight and their issued status
+        std::vector<GLuint> query;
+        std::vector<bool> issued;
+
+        // Timestamps per frame and current frame
+        std::size_t stamps;
+        std::size_t frame;
+
+        // Milliseconds between consecutive timestamps of the last finished frame
+        std::vector<double> elapsed;
+
+        // Disable copy and assignation
+        GPUTimer(const GPUTimer &) = delete;
+        GPUTimer &operator = (const GPUTimer &) = delete;
+
+        // Static const attributes
+        static constexpr const std::size_t FRAMES = 3U;
+
+    public:
+        GPUTimer(const std::size_t &timestamps);
+
+        void stamp(const std::size_t &index);
+        void next();
+
+        double getElapsed(const std::size_t &index) const;
+
+        ~GPUTimer();
+};
+
+#endif // __GPU_TIMER_HPP_
@@ -29,6 +29,10 @@ Light::Light(const Light::Type &value) {
     position    = glm::vec3(0.0F, 0.00F, 2.000F);
     attenuation = glm::vec3(1.0F, 0.14F, 0.007F);
     cutoff      = glm::vec2(glm::radians(20.0F), glm::radians(25.0F));
+
+    // Shadows
+    cast_shadow  = true;
+    shadow_dirty = true;
 }
 
 // Use light
@@ -66,47 +70,68 @@ void Light::use(GLSLProgram *const program) const {
     program->setUniform(uniform + "specular", specular);
 }
 
+// Pack the light in seven texels of the light buffer, the shadow maps fill the last one
+void Light::pack(glm::vec4 *const texel) const {
+    const glm::vec2 cos_cutoff = glm::cos(cutoff);
+
+    texel[0] = glm::vec4(position, (float)type);
+    texel[1] = glm::vec4(-direction, cos_cutoff.x);
+    texel[2] = glm::vec4(ambient, ambient_level);
+    texel[3] = glm::vec4(diffuse, specular_level);
+    texel[4] = glm::vec4(specular, shininess);
+    texel[5] = glm::vec4(attenuation, cos_cutoff.y);
+    texel[6] = glm::vec4(-1.0F, 0.0F, 0.0F, 0.0F);
+}
+
 
 // Set type
 void Light::setType(const Light::Type &value) {
     type = value;
+    shadow_dirty = true;
 }
 
 // Set position
 void Light::setPosition(const glm::vec3 &value) {
     position = value;
+    shadow_dirty = true;
 }
 
 // Set direction
 void Light::setDirection(const glm::vec3 &value) {
     direction = glm::normalize(value);
+    shadow_dirty = true;
 }
 
 
-// Set ambient
+// Set ambient, the colors and levels change the range of the shadow maps
 void Light::setAmbient(const glm::vec3 &value) {
     ambient = value;
+    shadow_dirty = true;
 }
 
 // Set diffuse
 void Light::setDiffuse(const glm::vec3 &color) {
     diffuse = color;
+    shadow_dirty = true;
 }
 
 // Set specular
 void Light::setSpecular(const glm::vec3 &value) {
     specular = value;
+    shadow_dirty = true;
 }
 
 
 // Set ambient level
 void Light::setAmbientLevel(const float &value) {
     ambient_level = value;
+    shadow_dirty = true;
 }
 
 // Set specular level
 void Light::setSpecularLevel(const float &value) {
     specular_level = value;
+    shadow_dirty = true;
 }
 
 // Set shininess
@@ -118,37 +143,56 @@ void Light::setShininess(const float &value) {
 // Set attenuation
 void Light::setAttenuation(const glm::vec3 &value) {
     attenuation = value;
+    shadow_dirty = true;
 }
 
 // Set constant attenuation
 void Light::setConstAttenuation(const float &value) {
     attenuation.x = value;
+    shadow_dirty = true;
 }
 
 // Set linear attenuation
 void Light::setLinearAttenuation(const float &value) {
     attenuation.y = value;
+    shadow_dirty = true;
 }
 
 // Set quadratic attenuation
 void Light::setQuadraticAttenuation(const float &value) {
     attenuation.z = value;
+    shadow_dirty = true;
 }
 
 
 // Set cutoff
 void Light::setCutoff(const glm::vec2 &value) {
     cutoff = glm::radians(value);
+    shadow_dirty = true;
 }
 
 // Set inner cutoff
 void Light::setInnerCutoff(const float &value) {
     cutoff.s = glm::radians(value);
+    shadow_dirty = true;
 }
 
 // Set outer cutoff
 void Light::setOuterCutoff(const float &value) {
     cutoff.t = glm::radians(value);
+    shadow_dirty = true;
+}
+
+
+// Set the shadow casting status
+void Light::castShadow(const bool &status) {
+    cast_shadow = status;
+    shadow_dirty = true;
+}
+
+// Set the changed status of the shadow map, the setters of the spacial attributes set it
+void Light::setShadowDirty(const bool &status) {
+    shadow_dirty = status;
 }
 
 
@@ -212,6 +256,17 @@ glm::vec2 Light::getCutoff() const {
 }
 
 
+// Get the shadow casting status
+bool Light::castingShadow() const {
+    return cast_shadow;
+}
+
+// Get the changed status of the shadow map
+bool Light::isShadowDirty() const {
+    return shadow_dirty;
+}
+
+
 // Type to string
 const std::string &Light::to_string(const Light::Type &type) {
     switch (type) {
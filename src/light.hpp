@@ -42,11 +42,16 @@ class Light {
         glm::vec3 attenuation;
         glm::vec2 cutoff;
 
+        // Shadow casting status, and changes since the last shadow map
+        bool cast_shadow;
+        bool shadow_dirty;
+
 
     public:
         Light(const Light::Type &value = Light::Type::DIRECTIONAL);
 
         void use(GLSLProgram *const program) const;
+        void pack(glm::vec4 *const texel) const;
 
 
         void setType(const Light::Type &value);
@@ -71,6 +76,9 @@ class Light {
         void setInnerCutoff(const float &value);
         void setOuterCutoff(const float &value);
 
+        void castShadow(const bool &status);
+        void setShadowDirty(const bool &status);
+
         Type getType() const;
 
         glm::vec3 getDirection() const;
@@ -87,6 +95,9 @@ class Light {
         glm::vec3 getAttenuation() const;
         glm::vec2 getCutoff() const;
 
+        bool castingShadow() const;
+        bool isShadowDirty() const;
+
         static const std::string &to_string(const Light::Type &type);
 };
 
@@ -0,0 +1,327 @@
+#include "lightgrid.hpp"
+#include "scheduler.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define LIGHT_GRID_SSE
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cmath>
+
+// Static const definitions
+constexpr const GLenum LightGrid::FORMAT[];
+constexpr const char *const LightGrid::SAMPLER[];
+constexpr const std::size_t LightGrid::LIGHT_GRAIN;
+constexpr const std::int32_t LightGrid::X;
+constexpr const std::int32_t LightGrid::Y;
+constexpr const std::int32_t LightGrid::Z;
+constexpr const std::size_t LightGrid::TEXELS;
+constexpr const GLenum LightGrid::UNIT;
+constexpr const float LightGrid::THRESHOLD;
+
+
+// Light grid constructor, the buffers are created on the first upload
+LightGrid::LightGrid() {
+    std::fill(buffer, buffer + 3, GL_FALSE);
+    std::fill(texture, texture + 3, GL_FALSE);
+
+    directional = 0U;
+    depth = glm::vec2(0.0F);
+    scale = glm::vec2(0.0F);
+    offset = glm::vec2(0.0F);
+    assign_time = 0.0;
+
+    cluster.resize(LightGrid::X * LightGrid::Y * LightGrid::Z);
+    slice_light.resize(LightGrid::Z);
+    slice_index.resize(LightGrid::Z);
+}
+
+
+// Calculate the clusters covered by the bounding sphere of a light, empty bounds have a minimum greater than the maximum
+void LightGrid::setBounds(const std::size_t &slot, const glm::vec4 *const texel, const glm::mat4 &view, const glm::mat4 &projection, const glm::vec2 &clip) {
+    bounds.x_min[slot] = 0;
+    bounds.y_min[slot] = 0;
+    bounds.z_min[slot] = LightGrid::Z;
+    bounds.x_max[slot] = LightGrid::X - 1;
+    bounds.y_max[slot] = LightGrid::Y - 1;
+    bounds.z_max[slot] = -1;
+
+    // Lights without contribution
+    const float radius = LightGrid::getRadius(texel);
+    if (!(radius > 0.0F))
+        return;
+
+    // Lights without range reach every cluster
+    if (std::isinf(radius)) {
+        bounds.z_min[slot] = 0;
+        bounds.z_max[slot] = LightGrid::Z - 1;
+        return;
+    }
+
+    // Depth range
+    const glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(texel[0]), 1.0F));
+    const float near_depth = -center.z - radius;
+    const float far_depth  = -center.z + radius;
+    if ((far_depth < clip.x) || (near_depth > clip.y))
+        return;
+
+    // Screen range of the projected bounding box, the whole screen if it crosses the near plane
+    if (near_depth > clip.x) {
+        glm::vec2 ndc_min(std::numeric_limits<float>::max());
+        glm::vec2 ndc_max(std::numeric_limits<float>::lowest());
+        for (unsigned int corner = 0U; corner < 8U; corner++) {
+            const glm::vec3 offset((corner & 1U) ? radius : -radius, (corner & 2U) ? radius : -radius, (corner & 4U) ? radius : -radius);
+            const glm::vec4 point = projection * glm::vec4(center + offset, 1.0F);
+            const glm::vec2 ndc = glm::vec2(point) / point.w;
+            ndc_min = glm::min(ndc_min, ndc);
+            ndc_max = glm::max(ndc_max, ndc);
+        }
+
+        // Outside of the screen
+        if ((ndc_max.x < -1.0F) || (ndc_max.y < -1.0F) || (ndc_min.x > 1.0F) || (ndc_min.y > 1.0F))
+            return;
+
+        const glm::vec2 size((float)LightGrid::X, (float)LightGrid::Y);
+        const glm::ivec2 tile_min = glm::clamp(glm::ivec2(glm::floor((ndc_min * 0.5F + 0.5F) * size)), glm::ivec2(0), glm::ivec2(LightGrid::X - 1, LightGrid::Y - 1));
+        const glm::ivec2 tile_max = glm::clamp(glm::ivec2(glm::floor((ndc_max * 0.5F + 0.5F) * size)), glm::ivec2(0), glm::ivec2(LightGrid::X - 1, LightGrid::Y - 1));
+        bounds.x_min[slot] = tile_min.x;
+        bounds.y_min[slot] = tile_min.y;
+        bounds.x_max[slot] = tile_max.x;
+        bounds.y_max[slot] = tile_max.y;
+    }
+
+    bounds.z_min[slot] = getSlice(std::max(near_depth, clip.x));
+    bounds.z_max[slot] = getSlice(std::min(far_depth, clip.y));
+}
+
+// Assign the lights of a depth slice to its clusters, every slice has its own clusters and indices
+void LightGrid::assignSlice(const std::size_t &slice) {
+    const std::int32_t z = (std::int32_t)slice;
+    const std::size_t count = bounds.z_min.size();
+    std::vector<std::uint32_t> &overlap = slice_light[slice];
+    std::vector<std::uint32_t> &list = slice_index[slice];
+    glm::uvec2 *const grid = &cluster[slice * LightGrid::X * LightGrid::Y];
+
+    // Lights overlapping the slice
+    overlap.clear();
+    std::size_t slot = 0U;
+#ifdef LIGHT_GRID_SSE
+    const __m128i depth_slice = _mm_set1_epi32(z);
+    for (; slot + 4U <= count; slot += 4U) {
+        const __m128i z_min = _mm_loadu_si128((const __m128i *)&bounds.z_min[slot]);
+        const __m128i z_max = _mm_loadu_si128((const __m128i *)&bounds.z_max[slot]);
+        const __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(z_min, depth_slice), _mm_cmpgt_epi32(depth_slice, z_max));
+        const int mask = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF;
+        for (std::size_t bit = 0U; bit < 4U; bit++)
+            if (mask & (1 << bit))
+                overlap.push_back((std::uint32_t)(slot + bit));
+    }
+#endif
+    for (; slot < count; slot++)
+        if ((bounds.z_min[slot] <= z) && (z <= bounds.z_max[slot]))
+            overlap.push_back((std::uint32_t)slot);
+
+    // Count the lights of each cluster
+    std::fill(grid, grid + LightGrid::X * LightGrid::Y, glm::uvec2(0U));
+    for (const std::uint32_t &light : overlap)
+        for (std::int32_t y = bounds.y_min[light]; y <= bounds.y_max[light]; y++)
+            for (std::int32_t x = bounds.x_min[light]; x <= bounds.x_max[light]; x++)
+                grid[y * LightGrid::X + x].y++;
+
+    // Offsets inside the slice
+    std::uint32_t offset = 0U;
+    for (std::int32_t tile = 0; tile < LightGrid::X * LightGrid::Y; tile++) {
+        grid[tile].x = offset;
+        offset += grid[tile].y;
+        grid[tile].y = 0U;
+    }
+
+    // Fill the indices, the lights are stored after the directional ones
+    list.resize(offset);
+    for (const std::uint32_t &light : overlap)
+        for (std::int32_t y = bounds.y_min[light]; y <= bounds.y_max[light]; y++)
+            for (std::int32_t x = bounds.x_min[light]; x <= bounds.x_max[light]; x++) {
+                glm::uvec2 &tile = grid[y * LightGrid::X + x];
+                list[tile.x + tile.y++] = (std::uint32_t)directional + light;
+            }
+}
+
+// Depth slice of a view depth, the slices are distributed logarithmically
+std::int32_t LightGrid::getSlice(const float &view_depth) const {
+    const std::int32_t slice = (std::int32_t)std::floor(std::log(view_depth) * depth.x + depth.y);
+    return std::min(std::max(slice, 0), LightGrid::Z - 1);
+}
+
+
+// Assign the point and spot lights to the clusters of the camera view, the directional lights are the first ones
+void LightGrid::assign(const std::vector<glm::vec4> &lights, const std::size_t &directional_lights, const Camera *const camera, const glm::ivec2 &origin) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    light_data = lights;
+    directional = directional_lights;
+
+    // Camera properties
+    const glm::mat4 view = camera->getViewMatrix();
+    const glm::mat4 projection = camera->getProjectionMatrix();
+    const glm::vec2 clip = camera->getClipping();
+    const glm::ivec2 resolution = camera->getResolution();
+
+    // Depth slices scale and bias, clusters per pixel and the viewport corner in the window
+    const float ratio = std::log(clip.y / clip.x);
+    depth = glm::vec2((float)LightGrid::Z / ratio, -(float)LightGrid::Z * std::log(clip.x) / ratio);
+    scale = glm::vec2((float)LightGrid::X / (float)std::max(resolution.x, 1), (float)LightGrid::Y / (float)std::max(resolution.y, 1));
+    offset = glm::vec2(origin);
+
+    // Bounds of the point and spot lights
+    const std::size_t count = light_data.size() / LightGrid::TEXELS;
+    const std::size_t clustered = count - std::min(directional, count);
+    for (std::vector<std::int32_t> *const values : {&bounds.x_min, &bounds.x_max, &bounds.y_min, &bounds.y_max, &bounds.z_min, &bounds.z_max})
+        values->resize(clustered);
+
+    Scheduler *const scheduler = Scheduler::getDefault();
+    scheduler->parallelFor(0U, clustered, LightGrid::LIGHT_GRAIN, [this, &view, &projection, &clip](const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t slot = begin; slot < end; slot++)
+            setBounds(slot, &light_data[(directional + slot) * LightGrid::TEXELS], view, projection, clip);
+    });
+
+    // Assign the lights of each slice
+    scheduler->parallelFor(0U, LightGrid::Z, 1U, [this](const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t slice = begin; slice < end; slice++)
+            assignSlice(slice);
+    });
+
+    // Join the slices
+    index.clear();
+    for (std::size_t slice = 0U; slice < (std::size_t)LightGrid::Z; slice++) {
+        const std::uint32_t base = (std::uint32_t)index.size();
+        glm::uvec2 *const grid = &cluster[slice * LightGrid::X * LightGrid::Y];
+        for (std::int32_t tile = 0; tile < LightGrid::X * LightGrid::Y; tile++)
+            grid[tile].x += base;
+
+        index.insert(index.end(), slice_index[slice].begin(), slice_index[slice].end());
+    }
+
+    assign_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Upload the lights, clusters and indices to their buffers
+void LightGrid::upload() {
+    // Create the buffers and their textures
+    if (buffer[LightGrid::LIGHTS] == GL_FALSE) {
+        glGenBuffers(3, buffer);
+        glGenTextures(3, texture);
+        for (std::size_t i = 0U; i < 3U; i++) {
+            glBindBuffer(GL_TEXTURE_BUFFER, buffer[i]);
+            glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+            glBindTexture(GL_TEXTURE_BUFFER, texture[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, LightGrid::FORMAT[i], buffer[i]);
+        }
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    // Orphan the previous storage, empty buffers keep one element
+    const GLsizeiptr size[] = {
+        (GLsizeiptr)(light_data.size() * sizeof(glm::vec4)),
+        (GLsizeiptr)(cluster.size() * sizeof(glm::uvec2)),
+        (GLsizeiptr)(index.size() * sizeof(std::uint32_t))
+    };
+    const void *const data[] = {light_data.data(), cluster.data(), index.data()};
+
+    for (std::size_t i = 0U; i < 3U; i++) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer[i]);
+        glBufferData(GL_TEXTURE_BUFFER, std::max(size[i], (GLsizeiptr)sizeof(glm::vec4)), nullptr, GL_STREAM_DRAW);
+        if (size[i] > 0)
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, size[i], data[i]);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Bind the buffers and set the cluster uniforms
+void LightGrid::bind(GLSLProgram *const program) const {
+    if (!program->isValid())
+        return;
+
+    program->use();
+    program->setUniform("directional_size", (GLuint)directional);
+    program->setUniform("cluster_size", glm::uvec3(LightGrid::X, LightGrid::Y, LightGrid::Z));
+    program->setUniform("cluster_scale", scale);
+    program->setUniform("cluster_depth", depth);
+    program->setUniform("cluster_offset", offset);
+
+    for (std::size_t i = 0U; i < 3U; i++) {
+        glActiveTexture(GL_TEXTURE0 + LightGrid::UNIT + (GLenum)i);
+        glBindTexture(GL_TEXTURE_BUFFER, texture[i]);
+        program->setUniform(LightGrid::SAMPLER[i], (GLint)(LightGrid::UNIT + i));
+    }
+}
+
+
+// Get the number of lights
+std::size_t LightGrid::getLights() const {
+    return light_data.size() / LightGrid::TEXELS;
+}
+
+// Get the number of point and spot lights in at least one cluster
+std::size_t LightGrid::getClusteredLights() const {
+    std::size_t count = 0U;
+    for (std::size_t slot = 0U; slot < bounds.z_min.size(); slot++)
+        count += (bounds.z_min[slot] <= bounds.z_max[slot]);
+
+    return count;
+}
+
+// Get the number of light indices of all clusters
+std::size_t LightGrid::getIndices() const {
+    return index.size();
+}
+
+// Get the maximum number of lights in a cluster
+std::size_t LightGrid::getMaxClusterLights() const {
+    std::size_t count = 0U;
+    for (const glm::uvec2 &lights : cluster)
+        count = std::max(count, (std::size_t)lights.y);
+
+    return count;
+}
+
+// Get the last assignation time in microseconds
+double LightGrid::getAssignTime() const {
+    return assign_time;
+}
+
+
+// Distance where the light intensity falls below the threshold, zero without contribution and infinite without attenuation
+float LightGrid::getRadius(const glm::vec4 *const texel) {
+    // Brightest component of the light colors
+    const glm::vec3 ambient  = glm::vec3(texel[2]) * texel[2].w;
+    const glm::vec3 diffuse  = glm::vec3(texel[3]);
+    const glm::vec3 specular = glm::vec3(texel[4]) * texel[3].w;
+    const glm::vec3 color = glm::max(ambient, glm::max(diffuse, specular));
+    const float intensity = std::max(color.r, std::max(color.g, color.b)) / LightGrid::THRESHOLD;
+
+    // Solve constant + linear * d + quadratic * d^2 = intensity
+    const glm::vec3 attenuation = glm::vec3(texel[5]);
+    const float constant = attenuation.x - intensity;
+    if (constant >= 0.0F)
+        return 0.0F;
+
+    if (attenuation.z > 0.0F)
+        return (-attenuation.y + std::sqrt(attenuation.y * attenuation.y - 4.0F * attenuation.z * constant)) / (2.0F * attenuation.z);
+
+    if (attenuation.y > 0.0F)
+        return -constant / attenuation.y;
+
+    return std::numeric_limits<float>::infinity();
+}
+
+
+// Delete the buffers
+LightGrid::~LightGrid() {
+    if (buffer[LightGrid::LIGHTS] != GL_FALSE) {
+        glDeleteTextures(3, texture);
+        glDeleteBuffers(3, buffer);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef __LIGHT_GRID_HPP_
+#define __LIGHT_GRID_HPP_
+
+#include "camera.hpp"
+#include "glslprogram.hpp"
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+class LightGrid {
+    private:
+        // Buffers
+        enum Buffer : std::uint8_t {
+            LIGHTS,
+            CLUSTERS,
+            INDICES
+        };
+
+        // Bounds of the clustered lights in cluster coordinates, the slices test them four at a time
+        struct bounds_data {
+            std::vector<std::int32_t> x_min;
+            std::vector<std::int32_t> x_max;
+            std::vector<std::int32_t> y_min;
+            std::vector<std::int32_t> y_max;
+            std::vector<std::int32_t> z_min;
+            std::vector<std::int32_t> z_max;
+        };
+
+        // Disable copy and assignation
+        LightGrid(const LightGrid &) = delete;
+        LightGrid &operator = (const LightGrid &) = delete;
+
+        // Buffers and their buffer textures
+        GLuint buffer[3];
+        GLuint texture[3];
+
+        // Packed lights and number of directional lights
+        std::vector<glm::vec4> light_data;
+        std::size_t directional;
+
+        // Bounds of the point and spot lights
+        bounds_data bounds;
+
+        // Offset and count of the light indices of each cluster and the indices
+        std::vector<glm::uvec2> cluster;
+        std::vector<std::uint32_t> index;
+
+        // Lights and indices of each depth slice
+        std::vector<std::vector<std::uint32_t> > slice_light;
+        std::vector<std::vector<std::uint32_t> > slice_index;
+
+        // Depth slice scale and bias, clusters per pixel and window position of the viewport
+        glm::vec2 depth;
+        glm::vec2 scale;
+        glm::vec2 offset;
+
+        // Last assignation time in microseconds
+        double assign_time;
+
+        // Calculate the bounds of a light
+        void setBounds(const std::size_t &slot, const glm::vec4 *const texel, const glm::mat4 &view, const glm::mat4 &projection, const glm::vec2 &clip);
+
+        // Assign the lights of a depth slice to its clusters
+        void assignSlice(const std::size_t &slice);
+
+        // Depth slice of a view depth
+        std::int32_t getSlice(const float &view_depth) const;
+
+        // Static const attributes
+        static constexpr const GLenum FORMAT[] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+        static constexpr const char *const SAMPLER[] = {"light_data", "light_cluster", "light_index"};
+        static constexpr const std::size_t LIGHT_GRAIN = 64U;
+
+    public:
+        // Cluster grid size, texels per light and texture units
+        static constexpr const std::int32_t X = 16;
+        static constexpr const std::int32_t Y = 9;
+        static constexpr const std::int32_t Z = 24;
+        static constexpr const std::size_t TEXELS = 7U;
+        static constexpr const GLenum UNIT = 13U;
+
+        // Lowest intensity that reaches a cluster
+        static constexpr const float THRESHOLD = 1.0F / 256.0F;
+
+        LightGrid();
+
+        void assign(const std::vector<glm::vec4> &lights, const std::size_t &directional_lights, const Camera *const camera, const glm::ivec2 &origin = glm::ivec2(0));
+        void upload();
+        void bind(GLSLProgram *const program) const;
+
+        std::size_t getLights() const;
+        std::size_t getClusteredLights() const;
+        std::size_t getIndices() const;
+        std::size_t getMaxClusterLights() const;
+        double getAssignTime() const;
+
+
+        static float getRadius(const glm::vec4 *const texel);
+
+        ~LightGrid();
+};
+
+#endif // __LIGHT_GRID_HPP_
@@ -0,0 +1,221 @@
+#include "loader.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+
+// Static definitions
+GLFWwindow *Loader::context = nullptr;
+std::thread Loader::thread;
+std::mutex Loader::mutex;
+std::condition_variable Loader::condition;
+std::deque<std::size_t> Loader::pending;
+std::map<std::size_t, Loader::job_data> Loader::job_stock;
+std::size_t Loader::last_id = 0U;
+bool Loader::stop = false;
+
+
+// Loader thread main loop
+void Loader::run() {
+    // Make the shared context current in this thread
+    glfwMakeContextCurrent(Loader::context);
+
+    std::unique_lock<std::mutex> lock(Loader::mutex);
+    while (true) {
+        // Wait for jobs
+        Loader::condition.wait(lock, []() { return Loader::stop || !Loader::pending.empty(); });
+        if (Loader::stop)
+            break;
+
+        // Take the next job, it is not erased until it has a fence
+        std::map<std::size_t, Loader::job_data>::iterator job = Loader::job_stock.find(Loader::pending.front());
+        Loader::pending.pop_front();
+        const std::function<void()> work = job->second.work;
+        lock.unlock();
+
+        // Run the work, a failed work is discarded like a cancelled one
+        bool failed = false;
+        try {
+            work();
+        } catch (std::exception &exception) {
+            std::cerr << exception.what() << std::endl;
+            failed = true;
+        }
+
+        // Fence the issued commands and flush them so the render thread can wait for the fence
+        const GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        lock.lock();
+        job->second.fence = fence;
+        job->second.cancelled |= failed;
+    }
+
+    // Release the context
+    glfwMakeContextCurrent(NULL);
+}
+
+
+// Create the loader context sharing objects with the window context and start the thread
+bool Loader::init(GLFWwindow *const window) {
+    // Hidden window with the same hints of the main window
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    Loader::context = glfwCreateWindow(1, 1, "Loader", NULL, window);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    // Load in the render thread if the context could not be created
+    if (Loader::context == NULL) {
+        std::cerr << "warning: could not create the loader context, resources will be loaded in the render thread" << std::endl;
+        Loader::context = nullptr;
+        return false;
+    }
+
+    // Start the loader thread
+    Loader::stop = false;
+    Loader::thread = std::thread(&Loader::run);
+    return true;
+}
+
+
+// Push a job, the done or discard callback runs in the render thread once the job commands have completed, the discard one if the work throws
+std::size_t Loader::push(const std::function<void()> &work, const std::function<void()> &done, const std::function<void()> &discard) {
+    // Run in place without loader context
+    if (Loader::context == nullptr) {
+        try {
+            work();
+        } catch (std::exception &exception) {
+            std::cerr << exception.what() << std::endl;
+            if (discard)
+                discard();
+            return 0U;
+        }
+
+        if (done)
+            done();
+        return 0U;
+    }
+
+    // Queue job
+    std::size_t id;
+    {
+        std::lock_guard<std::mutex> lock(Loader::mutex);
+        id = ++Loader::last_id;
+        Loader::job_stock[id] = Loader::job_data{work, done, discard, nullptr, false};
+        Loader::pending.push_back(id);
+    }
+
+    // Wake up the loader thread
+    Loader::condition.notify_one();
+    return id;
+}
+
+// Cancel a job, the discard callback runs instead of the done callback if the work has started
+void Loader::cancel(const std::size_t &job) {
+    if (job == 0U)
+        return;
+
+    std::lock_guard<std::mutex> lock(Loader::mutex);
+    std::map<std::size_t, Loader::job_data>::iterator result = Loader::job_stock.find(job);
+    if (result == Loader::job_stock.end())
+        return;
+
+    // Remove the job if it has not started
+    std::deque<std::size_t>::iterator position = std::find(Loader::pending.begin(), Loader::pending.end(), job);
+    if (position != Loader::pending.end()) {
+        Loader::pending.erase(position);
+        Loader::job_stock.erase(result);
+    }
+
+    // Discard the results later
+    else
+        result->second.cancelled = true;
+}
+
+// Run the callbacks of the completed jobs
+void Loader::update() {
+    if (Loader::context == nullptr)
+        return;
+
+    // Jobs whose fence has been signaled
+    std::vector<std::size_t> ready;
+    {
+        std::lock_guard<std::mutex> lock(Loader::mutex);
+        for (const std::pair<const std::size_t, Loader::job_data> &job : Loader::job_stock) {
+            if (job.second.fence == nullptr)
+                continue;
+
+            const GLenum status = glClientWaitSync(job.second.fence, 0, 0);
+            if ((status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED))
+                ready.push_back(job.first);
+        }
+    }
+
+    // Run the callbacks out of the lock, they can push or cancel other jobs
+    for (const std::size_t &id : ready) {
+        Loader::job_data job;
+        {
+            std::lock_guard<std::mutex> lock(Loader::mutex);
+            std::map<std::size_t, Loader::job_data>::iterator result = Loader::job_stock.find(id);
+            if (result == Loader::job_stock.end())
+                continue;
+
+            job = result->second;
+            Loader::job_stock.erase(result);
+        }
+
+        // Delete fence
+        glDeleteSync(job.fence);
+
+        // Done or discard callback
+        if (job.cancelled) {
+            if (job.discard)
+                job.discard();
+        }
+        else if (job.done)
+            job.done();
+    }
+}
+
+
+// Get the enabled status
+bool Loader::isEnabled() {
+    return Loader::context != nullptr;
+}
+
+// Get the number of pending and unfinished jobs
+std::size_t Loader::getJobs() {
+    std::lock_guard<std::mutex> lock(Loader::mutex);
+    return Loader::job_stock.size();
+}
+
+
+// Stop the loader thread and destroy its context
+void Loader::terminate() {
+    if (Loader::context == nullptr)
+        return;
+
+    // Stop thread
+    {
+        std::lock_guard<std::mutex> lock(Loader::mutex);
+        Loader::stop = true;
+    }
+    Loader::condition.notify_one();
+    Loader::thread.join();
+
+    // Discard the results of the finished jobs
+    for (std::pair<const std::size_t, Loader::job_data> &job : Loader::job_stock) {
+        if (job.second.fence == nullptr)
+            continue;
+
+        glDeleteSync(job.second.fence);
+        if (job.second.discard)
+            job.second.discard();
+    }
+    Loader::job_stock.clear();
+    Loader::pending.clear();
+
+    // Destroy context
+    glfwDestroyWindow(Loader::context);
+    Loader::context = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef __LOADER_HPP_
+#define __LOADER_HPP_
+
+#include "glad/glad.h"
+#include <GLFW/glfw3.h>
+
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <map>
+
+class Loader {
+    private:
+        struct job_data {
+            // Work done in the loader context and callbacks run by the render thread
+            std::function<void()> work;
+            std::function<void()> done;
+            std::function<void()> discard;
+
+            // Fence of the commands issued by the work
+            GLsync fence;
+            bool cancelled;
+        };
+
+        // Disable constructor, copy and assignation
+        Loader() = delete;
+        Loader(const Loader &) = delete;
+        Loader &operator = (const Loader &) = delete;
+
+        // Loader thread main loop
+        static void run();
+
+        // Static attributes
+        static GLFWwindow *context;
+        static std::thread thread;
+        static std::mutex mutex;
+        static std::condition_variable condition;
+        static std::deque<std::size_t> pending;
+        static std::map<std::size_t, Loader::job_data> job_stock;
+        static std::size_t last_id;
+        static bool stop;
+
+    public:
+        static bool init(GLFWwindow *const window);
+
+        static std::size_t push(const std::function<void()> &work, const std::function<void()> &done, const std::function<void()> &discard = nullptr);
+        static void cancel(const std::size_t &job);
+        static void update();
+
+        static bool isEnabled();
+        static std::size_t getJobs();
+
+        static void terminate();
+};
+
+#endif // __LOADER_HPP_
\ No newline at end of file
@@ -2,6 +2,16 @@
 #include "scene/scenelight.hpp"
 #include "scene/scenemodel.hpp"
 #include "scene/scene.hpp"
+#include "scene/scenefile.hpp"
+#include "streammodel.hpp"
+#include "loader.hpp"
+#include "scheduler.hpp"
+#include "programcache.hpp"
+#include "lightgrid.hpp"
+#include "gbuffer.hpp"
+#include "transparencybuffer.hpp"
+#include "shadowmaps.hpp"
+#include "framepacer.hpp"
 
 #include "dirseparator.hpp"
 
@@ -17,8 +27,16 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <iomanip>
+#include <fstream>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdio>
 #include <cstdint>
+#include <random>
+#include <algorithm>
 
 
 // Scene variables
@@ -32,6 +50,9 @@ double ypos;
 // ImGui IO
 ImGuiIO *io = nullptr;
 
+// Longest sleep of the on demand drawing
+const double IDLE_TIMEOUT = 0.5;
+
 
 // OpenGL and scene initialization
 void init_opengl();
@@ -48,15 +69,28 @@ void mouse_button_callback(GLFWwindow *, int button, int action, int);
 void cursor_position_callback(GLFWwindow *, double xpos, double ypos);
 void scroll_callback(GLFWwindow *, double, double yoffset);
 void key_callback(GLFWwindow *window, int key, int, int action, int modifier);
+void char_callback(GLFWwindow *, unsigned int);
+void refresh_callback(GLFWwindow *);
+void focus_callback(GLFWwindow *, int);
 
 // Process inputs
 void process_input(GLFWwindow *window);
+bool is_moving(GLFWwindow *window);
 void setMouseEnabled(const bool &status);
 
 // Setup scene and GUI
-void setup_scene(const std::string &bin_path);
+void setup_scene(const std::string &bin_path, const std::string &session_path = "");
 void setup_gui();
 
+// Job scheduler scaling benchmark
+void benchmark_jobs(const std::string &bin_path, const std::vector<std::string> &extra_path);
+
+// Clustered lights benchmark
+void benchmark_lights(const std::string &bin_path);
+
+// Scene stocks benchmark
+void benchmark_models();
+
 // Main loop
 void main_loop();
 
@@ -73,6 +107,18 @@ int main(const int argc, const char **const argv) {
     // Exit status
     int status = EXIT_SUCCESS;
 
+    // Convert an OBJ file to a chunks file without creating a window
+    if ((argc == 4) && (std::string(argv[1]) == "--convert")) {
+        try {
+            StreamModel::convert(argv[2], argv[3]);
+        } catch (std::exception &exception) {
+            std::cerr << exception.what() << std::endl;
+            status = EXIT_FAILURE;
+        }
+
+        return status;
+    }
+
     try {
         // Initialize OpenGL and make context
         init_opengl();
@@ -86,14 +132,34 @@ int main(const int argc, const char **const argv) {
         print_opengl_info();
         setup_opengl();
 
+        // Start the loader thread with a shared context
+        Loader::init(window);
+
+        // Start the job scheduler
+        Scheduler::setDefault(new Scheduler());
+
         // Setup GUI
         setup_gui();
 
-        // Load scene
-        setup_scene(argv[0]);
+        // Measure the scheduler scaling instead of running the viewer
+        if ((argc >= 2) && (std::string(argv[1]) == "--benchmark-jobs"))
+            benchmark_jobs(argv[0], std::vector<std::string>(argv + 2, argv + argc));
+
+        // Measure the clustered lights instead of running the viewer
+        else if ((argc == 2) && (std::string(argv[1]) == "--benchmark-lights"))
+            benchmark_lights(argv[0]);
+
+        // Measure the scene model handles instead of running the viewer
+        else if ((argc == 2) && (std::string(argv[1]) == "--benchmark-models"))
+            benchmark_models();
+
+        else {
+            // Load scene, or the session saved in the file given with --scene
+            setup_scene(argv[0], ((argc == 3) && (std::string(argv[1]) == "--scene")) ? argv[2] : "");
 
-        // Main loop
-        main_loop();    
+            // Main loop
+            main_loop();
+        }
     }
     catch (std::exception &exception) {
         std::cerr << exception.what() << std::endl;
@@ -161,12 +227,21 @@ void setup_opengl() {
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
 
+    // Let the driver compile the shaders in its own threads
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFU);
+    else if (GLAD_GL_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFU);
+
     // Register the callbacks
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetCursorPosCallback(window, cursor_position_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetKeyCallback(window, key_callback);
+    glfwSetCharCallback(window, char_callback);
+    glfwSetWindowRefreshCallback(window, refresh_callback);
+    glfwSetWindowFocusCallback(window, focus_callback);
 }
 
 
@@ -186,6 +261,8 @@ void framebuffer_size_callback(GLFWwindow *, int width, int height) {
 
 // Mouse button callback
 void mouse_button_callback(GLFWwindow *, int button, int action, int) {
+    scene->requestRedraw();
+
     // Disable cursor if don't click any window
     if ((action == GLFW_RELEASE) && !io->WantCaptureKeyboard)
         setMouseEnabled(false);
@@ -193,18 +270,24 @@ void mouse_button_callback(GLFWwindow *, int button, int action, int) {
 
 // Cursor position callback
 void cursor_position_callback(GLFWwindow *, double xpos, double ypos) {
+    scene->requestRedraw();
+
     if (!io->WantCaptureKeyboard || !scene->showingGUI())
         scene->lookAround(xpos, ypos);
 }
 
 // Scroll callback
 void scroll_callback(GLFWwindow *, double, double yoffset) {
+    scene->requestRedraw();
+
     if (!io->WantCaptureKeyboard || !scene->showingGUI())
         scene->zoom(yoffset);
 }
 
 // Key callback
 void key_callback(GLFWwindow *window, int key, int, int action, int modifier) {
+    scene->requestRedraw();
+
     switch (key) {
         // Toggle the GUI visibility
         case GLFW_KEY_ESCAPE:
@@ -242,6 +325,21 @@ void key_callback(GLFWwindow *window, int key, int, int action, int modifier) {
     }
 }
 
+// Text input callback, the GUI reads the characters
+void char_callback(GLFWwindow *, unsigned int) {
+    scene->requestRedraw();
+}
+
+// Window damaged callback
+void refresh_callback(GLFWwindow *) {
+    scene->requestRedraw();
+}
+
+// Window focus callback
+void focus_callback(GLFWwindow *, int) {
+    scene->requestRedraw();
+}
+
 // Process key input
 void process_input(GLFWwindow *window) {
     // Check if the GUI want to capture the keyboard
@@ -257,6 +355,19 @@ void process_input(GLFWwindow *window) {
     if (glfwGetKey(window, GLFW_KEY_C)     | glfwGetKey(window, GLFW_KEY_DOWN))  scene->travell(Camera::DOWN);
 }
 
+// Check if some camera movement key is held
+bool is_moving(GLFWwindow *window) {
+    // Check if the GUI want to capture the keyboard
+    if (io->WantCaptureKeyboard && scene->showingGUI())
+        return false;
+
+    for (const int &key : {GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_A, GLFW_KEY_LEFT, GLFW_KEY_D, GLFW_KEY_RIGHT, GLFW_KEY_SPACE, GLFW_KEY_UP, GLFW_KEY_C, GLFW_KEY_DOWN})
+        if (glfwGetKey(window, key) == GLFW_PRESS)
+            return true;
+
+    return false;
+}
+
 // Set the mouse status
 void setMouseEnabled(const bool &status) {
     // Enable mouse
@@ -302,7 +413,7 @@ void setup_gui() {
 
 
 // Setup scene
-void setup_scene(const std::string &bin_path) {
+void setup_scene(const std::string &bin_path, const std::string &session_path) {
     // Get resolution
     int width;
     int height;
@@ -318,31 +429,49 @@ void setup_scene(const std::string &bin_path) {
 	scene = new Scene(width, height);
 	scene->setBackground(glm::vec3(0.45F, 0.55F, 0.60F));
 
-    // Add a second camera
-    const std::size_t cam_id = scene->pushCamera(true);
-    SceneCamera *second_cam = scene->getCamera(cam_id);
-    second_cam->setOrthogonal(true);
-    second_cam->setPosition(glm::vec3(-1.170F, 0.975F, 1.700F));
-    second_cam->setLookDirection(glm::vec3(0.4855F, -0.4140F, -0.7700F));
+	// Keep the program binaries next to the executable
+	ProgramCache::init(root_path);
 
 	// Default programs
 	const std::string vertex = shader_path + "common.vert.glsl";
 	SceneProgram::setDefault(new SceneProgram(vertex, shader_path + "normals.frag.glsl"));
     SceneLight::setDefaultProgram(new SceneProgram(vertex, shader_path + "light.frag.glsl"));
+    GBuffer::setScreenShader(shader_path + "deferred.vert.glsl");
+    scene->setDepthProgram(new SceneProgram(vertex, shader_path + "depth.frag.glsl"));
 
-    // Add programs
-	const std::size_t blinn_phong_id   = scene->pushProgram(vertex, shader_path + "blinn_phong.frag.glsl");
-	const std::size_t oren_nayar_id    = scene->pushProgram(vertex, shader_path + "oren_nayar.frag.glsl");
-	const std::size_t cook_torrance_id = scene->pushProgram(vertex, shader_path + "cook_torrance.frag.glsl");
+    // The shadow maps are rendered with the depth program
+    scene->setShadowMapping(ShadowMaps::isSupported());
 
-    // Add models
-	const std::size_t nanosuit_id = scene->pushModel(model_path + "nanosuit" + DIR_SEP + "nanosuit.obj",    cook_torrance_id);
-	const std::size_t suzanne_id = scene->pushModel(model_path + "suzanne"  + DIR_SEP + "suzanne.obj",      blinn_phong_id);
-	const std::size_t crash_id = scene->pushModel(model_path + "crash"    + DIR_SEP + "crashbandicoot.obj", oren_nayar_id);
+    // The transparent materials are blended over the opaque models
+    scene->setTransparencyProgram(new SceneProgram(shader_path + "deferred.vert.glsl", shader_path + "transparency.frag.glsl"));
+    scene->setTransparency(TransparencyBuffer::isSupported());
 
     // Add light model
     SceneLight::setModel(new SceneModel(model_path + "arrow" + DIR_SEP + "light_arrow.obj"));
 
+    // Restore the saved session instead of the default scene
+    if (!session_path.empty() && SceneFile::load(scene, session_path)) {
+        scene->drawGUI();
+        return;
+    }
+
+    // Add a second camera
+    const Scene::CameraHandle cam_id = scene->pushCamera(true);
+    SceneCamera *second_cam = scene->getCamera(cam_id);
+    second_cam->setOrthogonal(true);
+    second_cam->setPosition(glm::vec3(-1.170F, 0.975F, 1.700F));
+    second_cam->setLookDirection(glm::vec3(0.4855F, -0.4140F, -0.7700F));
+
+    // Add programs
+	const Scene::ProgramHandle blinn_phong_id   = scene->pushProgram(vertex, shader_path + "blinn_phong.frag.glsl");
+	const Scene::ProgramHandle oren_nayar_id    = scene->pushProgram(vertex, shader_path + "oren_nayar.frag.glsl");
+	const Scene::ProgramHandle cook_torrance_id = scene->pushProgram(vertex, shader_path + "cook_torrance.frag.glsl");
+
+    // Add models
+	const Scene::ModelHandle nanosuit_id = scene->pushModel(model_path + "nanosuit" + DIR_SEP + "nanosuit.obj",    cook_torrance_id);
+	const Scene::ModelHandle suzanne_id = scene->pushModel(model_path + "suzanne"  + DIR_SEP + "suzanne.obj",      blinn_phong_id);
+	const Scene::ModelHandle crash_id = scene->pushModel(model_path + "crash"    + DIR_SEP + "crashbandicoot.obj", oren_nayar_id);
+
 	// Suzanne geometry
 	SceneModel *suzanne = scene->getModel(suzanne_id);
     suzanne->setScale(glm::vec3(0.5F));
@@ -393,7 +522,32 @@ void setup_scene(const std::string &bin_path) {
 
 // Main loop
 void main_loop() {
+    // Frame rate limit and fixed steps of the camera movement
+    FramePacer *const pacer = scene->getFramePacer();
+
     while (!glfwWindowShouldClose(window)) {
+        // Keep drawing while a movement key is held, the steps may not run in every frame
+        if (is_moving(window))
+            scene->requestRedraw();
+
+        // Update scene
+		scene->update();
+
+        // Sleep until an event while there is nothing to draw, the timeout keeps watching the assets
+        if (scene->isIdle()) {
+            glfwWaitEventsTimeout(IDLE_TIMEOUT);
+            pacer->skip();
+            continue;
+        }
+
+        // Move the camera in fixed steps and draw it between the last two
+        pacer->beginFrame();
+        while (pacer->step()) {
+            scene->stepCamera();
+            process_input(window);
+        }
+        scene->interpolateCamera(pacer->getAlpha());
+
         // Clear color and depth buffers
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -411,11 +565,9 @@ void main_loop() {
             setMouseEnabled(false);
         
 
-        // Draw GUI or process input
-        process_input(window);
-
-        // Poll events and swap buffers
+        // Poll events, wait for the target frame rate and swap buffers
         glfwPollEvents();
+        pacer->limit();
         glfwSwapBuffers(window);
     }
 }
@@ -436,6 +588,13 @@ void clean_up() {
     if (SceneLight::getProgram() != SceneLight::getDefaultProgram())
         delete SceneLight::getProgram();
 
+    // Stop the loader thread
+    Loader::terminate();
+
+    // Stop the job scheduler
+    delete Scheduler::getDefault();
+    Scheduler::setDefault(nullptr);
+
     // Terminate GUI
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -444,4 +603,263 @@ void clean_up() {
     // Destroy window and terminate OpenGL
     glfwDestroyWindow(window);
     glfwTerminate();
-}
\ No newline at end of file
+}
+
+
+// Load and cull models with 1 to 32 threads and print the times
+void benchmark_jobs(const std::string &bin_path, const std::vector<std::string> &extra_path) {
+    // Get resolution
+    int width;
+    int height;
+    glfwGetWindowSize(window, &width, &height);
+
+    // Bundled models
+    const std::string root_path = bin_path.substr(0, bin_path.find_last_of(DIR_SEP) + 1);
+    const std::string model_path = root_path + ".." + DIR_SEP + "model" + DIR_SEP;
+    std::vector<std::string> path = {
+        model_path + "nanosuit" + DIR_SEP + "nanosuit.obj",
+        model_path + "suzanne"  + DIR_SEP + "suzanne.obj",
+        model_path + "crash"    + DIR_SEP + "crashbandicoot.obj"
+    };
+    path.insert(path.end(), extra_path.begin(), extra_path.end());
+
+    // Synthetic grid of 2048 x 2048 quads
+    const std::string grid_path = root_path + "benchmark_grid.obj";
+    {
+        const std::size_t size = 2048U;
+        std::ofstream file(grid_path);
+        for (std::size_t y = 0U; y <= size; y++)
+            for (std::size_t x = 0U; x <= size; x++)
+                file << "v " << (float)x / size - 0.5F << ' ' << (float)y / size - 0.5F << " 0\n";
+
+        file << "vn 0 0 1\n";
+        for (std::size_t y = 0U; y < size; y++) {
+            for (std::size_t x = 0U; x < size; x++) {
+                const std::size_t a = y * (size + 1U) + x + 1U;
+                const std::size_t b = a + size + 1U;
+                file << "f " << a << "//1 " << a + 1U << "//1 " << b + 1U << "//1\n";
+                file << "f " << a << "//1 " << b + 1U << "//1 " << b << "//1\n";
+            }
+        }
+    }
+    path.push_back(grid_path);
+
+    // Camera used for culling
+    const Camera camera(width, height);
+    const std::size_t cull_repeats = 100U;
+
+    std::cout << std::endl << std::setw(8) << "threads" << std::setw(24) << "model" << std::setw(12) << "clusters" << std::setw(14) << "load (ms)" << std::setw(14) << "cull (us)" << std::endl;
+    for (const std::size_t threads : {1U, 2U, 4U, 8U, 16U, 32U}) {
+        // Replace the default scheduler
+        delete Scheduler::getDefault();
+        Scheduler::setDefault(new Scheduler(threads));
+
+        for (const std::string &model_file : path) {
+            // Load time, including the textures decoded and uploaded by the loader thread
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            Model model(model_file);
+            while (Loader::getJobs() > 0U) {
+                Loader::update();
+                std::this_thread::yield();
+            }
+            const std::chrono::steady_clock::time_point loaded = std::chrono::steady_clock::now();
+
+            // Average cull time
+            for (std::size_t i = 0U; i < cull_repeats; i++)
+                model.cull(&camera);
+            const std::chrono::steady_clock::time_point culled = std::chrono::steady_clock::now();
+
+            std::cout << std::setw(8) << threads << std::setw(24) << model.getName() << std::setw(12) << model.getClusters()
+                      << std::setw(14) << std::chrono::duration<double, std::milli>(loaded - start).count()
+                      << std::setw(14) << std::chrono::duration<double, std::micro>(culled - loaded).count() / cull_repeats << std::endl;
+        }
+    }
+
+    // Remove the synthetic model
+    std::remove(grid_path.c_str());
+}
+
+// Assign and shade from 1 to 1024 point lights over a plane that fills the screen
+void benchmark_lights(const std::string &bin_path) {
+    // Get resolution
+    int width;
+    int height;
+    glfwGetWindowSize(window, &width, &height);
+
+    // Paths
+    const std::string root_path = bin_path.substr(0, bin_path.find_last_of(DIR_SEP) + 1);
+    const std::string shader_path = root_path + ".." + DIR_SEP + "shader" + DIR_SEP;
+    const std::string plane_path = root_path + "benchmark_plane.obj";
+
+    // Plane of 64 x 64 quads, the model is normalized and placed in front of the camera
+    {
+        const std::size_t size = 64U;
+        std::ofstream file(plane_path);
+        for (std::size_t y = 0U; y <= size; y++)
+            for (std::size_t x = 0U; x <= size; x++)
+                file << "v " << (float)x / size - 0.5F << ' ' << (float)y / size - 0.5F << " 0\n";
+
+        file << "vn 0 0 1\n";
+        for (std::size_t y = 0U; y < size; y++) {
+            for (std::size_t x = 0U; x < size; x++) {
+                const std::size_t a = y * (size + 1U) + x + 1U;
+                const std::size_t b = a + size + 1U;
+                file << "f " << a << "//1 " << a + 1U << "//1 " << b + 1U << "//1\n";
+                file << "f " << a << "//1 " << b + 1U << "//1 " << b << "//1\n";
+            }
+        }
+    }
+
+    Model plane(plane_path);
+    plane.setPosition(glm::vec3(0.0F, 0.0F, -6.0F));
+    plane.setScale(glm::vec3(8.0F));
+    std::remove(plane_path.c_str());
+
+    // Shading program
+    GLSLProgram program(shader_path + "common.vert.glsl", shader_path + "blinn_phong.frag.glsl");
+    program.wait();
+    if (!program.isValid()) {
+        std::cerr << "error: could not build the benchmark program" << std::endl;
+        return;
+    }
+
+    // Camera looking at the plane
+    const Camera camera(width, height);
+    const std::size_t repeats = 100U;
+
+    // Timer query
+    GLuint query;
+    glGenQueries(1, &query);
+
+    LightGrid grid;
+    std::mt19937 generator(17U);
+    std::uniform_real_distribution<float> x_position(-3.0F, 3.0F);
+    std::uniform_real_distribution<float> y_position(-1.8F, 1.8F);
+    std::uniform_real_distribution<float> z_position(-5.9F, -5.0F);
+    std::uniform_real_distribution<float> color(0.2F, 1.0F);
+
+    std::cout << std::endl << std::setw(8) << "lights" << std::setw(12) << "clustered" << std::setw(12) << "indices" << std::setw(14) << "max/cluster"
+              << std::setw(14) << "assign (us)" << std::setw(14) << "shade (ms)" << std::endl;
+    for (std::size_t count = 1U; count <= 1024U; count *= 2U) {
+        // Random point lights with a radius of about half a unit
+        std::vector<glm::vec4> lights(count * LightGrid::TEXELS);
+        for (std::size_t i = 0U; i < count; i++) {
+            Light light(Light::POINT);
+            light.setPosition(glm::vec3(x_position(generator), y_position(generator), z_position(generator)));
+            light.setDiffuse(glm::vec3(color(generator), color(generator), color(generator)));
+            light.setAmbientLevel(0.0F);
+            light.setAttenuation(glm::vec3(1.0F, 0.0F, 1024.0F));
+            light.pack(&lights[i * LightGrid::TEXELS]);
+        }
+
+        // Average assignation time
+        double assign_time = 0.0;
+        for (std::size_t i = 0U; i < repeats; i++) {
+            grid.assign(lights, 0U, &camera);
+            assign_time += grid.getAssignTime();
+        }
+
+        // Average shading time
+        grid.upload();
+        camera.use(&program);
+        grid.bind(&program);
+
+        GLuint64 shade_time = 0U;
+        for (std::size_t i = 0U; i < repeats; i++) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            plane.draw(&program);
+            glEndQuery(GL_TIME_ELAPSED);
+
+            GLuint64 elapsed = 0U;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            shade_time += elapsed;
+        }
+
+        std::cout << std::setw(8) << count << std::setw(12) << grid.getClusteredLights() << std::setw(12) << grid.getIndices() << std::setw(14) << grid.getMaxClusterLights()
+                  << std::setw(14) << assign_time / repeats << std::setw(14) << (double)shade_time / repeats / 1.0E6 << std::endl;
+    }
+
+    glDeleteQueries(1, &query);
+}
+
+// Create, look up, iterate and destroy 100000 empty models through the scene handles
+void benchmark_models() {
+    // Get resolution
+    int width;
+    int height;
+    glfwGetWindowSize(window, &width, &height);
+
+    Scene models_scene(width, height);
+    const std::size_t count = 100000U;
+    std::vector<Scene::ModelHandle> handle;
+    handle.reserve(count);
+    std::mt19937 generator(17U);
+
+    std::cout << std::endl << std::setw(24) << "operation" << std::setw(12) << "models" << std::setw(14) << "total (ms)" << std::setw(14) << "model (ns)" << std::endl;
+    const auto print = [count](const std::string &operation, const std::size_t &models, const std::chrono::steady_clock::time_point &start) {
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(24) << operation << std::setw(12) << models << std::setw(14) << elapsed << std::setw(14) << elapsed * 1.0E6 / models << std::endl;
+    };
+
+    // Create the models
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0U; i < count; i++)
+        handle.push_back(models_scene.pushModel());
+    print("create", count, start);
+
+    // Look up the models in random order
+    std::shuffle(handle.begin(), handle.end(), generator);
+    std::size_t found = 0U;
+    start = std::chrono::steady_clock::now();
+    for (const Scene::ModelHandle &model : handle)
+        found += (models_scene.getModel(model) != nullptr ? 1U : 0U);
+    print("random lookup", found, start);
+
+    // Iterate the models as the draw does, the empty models are disabled
+    std::size_t disabled = 0U;
+    start = std::chrono::steady_clock::now();
+    for (SceneModel *const &model : models_scene.getModelStock())
+        disabled += (model->isEnabled() ? 0U : 1U);
+    print("iterate", models_scene.getModelStock().size(), start);
+
+    // Destroy half of the models in random order, their handles must become stale
+    const std::size_t half = count / 2U;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0U; i < half; i++)
+        models_scene.popModel(handle[i]);
+    print("random destroy", half, start);
+
+    std::size_t stale = 0U;
+    for (std::size_t i = 0U; i < half; i++)
+        stale += (models_scene.getModel(handle[i]) == nullptr ? 1U : 0U);
+
+    // Create them again in the released slots
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0U; i < half; i++)
+        handle[i] = models_scene.pushModel();
+    print("recreate", half, start);
+
+    // Move all the models and update their matrices in one pass, then again without changes
+    const std::vector<Model *> transformed(models_scene.getModelStock().begin(), models_scene.getModelStock().end());
+    for (std::size_t i = 0U; i < transformed.size(); i++)
+        transformed[i]->setPosition(glm::vec3((float)i, 0.0F, 0.0F));
+    start = std::chrono::steady_clock::now();
+    Model::updateTransforms(transformed);
+    print("moved transforms", transformed.size(), start);
+
+    start = std::chrono::steady_clock::now();
+    Model::updateTransforms(transformed);
+    print("static transforms", transformed.size(), start);
+
+    // Destroy all the models
+    std::shuffle(handle.begin(), handle.end(), generator);
+    start = std::chrono::steady_clock::now();
+    for (const Scene::ModelHandle &model : handle)
+        models_scene.popModel(model);
+    print("destroy", count, start);
+
+    // Check the handles
+    if ((found != count) || (disabled != count) || (stale != half) || !models_scene.getModelStock().empty())
+        std::cerr << "error: the model handles are not consistent" << std::endl;
+}
@@ -147,6 +147,35 @@ Texture *Material::getTexture(const Texture::Type &texture) const {
     }
 }
 
+// Get the shader defines of the real texture maps and the alpha test
+std::string Material::getDefines() const {
+    // Loaded texture different of the default one
+    const auto real = [](const Texture *const texture) { return texture->isOpen() && !texture->isDefault(); };
+
+    std::string defines;
+    if (real(ambient_map))   defines.append("#define HAS_AMBIENT_MAP\n");
+    if (real(diffuse_map))   defines.append("#define HAS_DIFFUSE_MAP\n");
+    if (real(specular_map))  defines.append("#define HAS_SPECULAR_MAP\n");
+    if (real(shininess_map)) defines.append("#define HAS_SHININESS_MAP\n");
+    if (real(alpha_map))     defines.append("#define HAS_ALPHA_MAP\n");
+
+    // Discard transparent fragments
+    if (isAlphaTested())
+        defines.append("#define ALPHA_TEST\n");
+
+    return defines;
+}
+
+// Check if the fragments are discarded by their alpha, when the transparent materials are not blended
+bool Material::isAlphaTested() const {
+    return isTransparent();
+}
+
+// Check if the material has a real alpha map or a partial alpha
+bool Material::isTransparent() const {
+    return (alpha_map->isOpen() && !alpha_map->isDefault()) || (alpha < 1.0F);
+}
+
 
 
 // Set the ambient color
@@ -202,16 +231,16 @@ void Material::setRefractiveIndex(const float &value) {
 
 
 // Set a new texture map
-void Material::setTexture(const std::string &path, const Texture::Type &texture) {
+void Material::setTexture(const std::string &path, const Texture::Type &texture, const std::function<void()> &callback) {
     switch (texture) {
-        case Texture::AMBIENT:      delete ambient_map;      ambient_map      = new Texture(path, Texture::AMBIENT);      return;
-        case Texture::DIFFUSE:      delete diffuse_map;      diffuse_map      = new Texture(path, Texture::DIFFUSE);      return;
-        case Texture::SPECULAR:     delete specular_map;     specular_map     = new Texture(path, Texture::SPECULAR);     return;
-        case Texture::SHININESS:    delete shininess_map;    shininess_map    = new Texture(path, Texture::SHININESS);    return;
-        case Texture::ALPHA:        delete alpha_map;        alpha_map        = new Texture(path, Texture::ALPHA);        return;
-        case Texture::BUMP:         delete bump_map;         bump_map         = new Texture(path, Texture::BUMP);         return;
-        case Texture::DISPLACEMENT: delete displacement_map; displacement_map = new Texture(path, Texture::DISPLACEMENT); return;
-        case Texture::STENCIL:      delete stencil_map;      stencil_map      = new Texture(path, Texture::STENCIL);      return;
+        case Texture::AMBIENT:      delete ambient_map;      ambient_map      = new Texture(path, Texture::AMBIENT, callback);      return;
+        case Texture::DIFFUSE:      delete diffuse_map;      diffuse_map      = new Texture(path, Texture::DIFFUSE, callback);      return;
+        case Texture::SPECULAR:     delete specular_map;     specular_map     = new Texture(path, Texture::SPECULAR, callback);     return;
+        case Texture::SHININESS:    delete shininess_map;    shininess_map    = new Texture(path, Texture::SHININESS, callback);    return;
+        case Texture::ALPHA:        delete alpha_map;        alpha_map        = new Texture(path, Texture::ALPHA, callback);        return;
+        case Texture::BUMP:         delete bump_map;         bump_map         = new Texture(path, Texture::BUMP, callback);         return;
+        case Texture::DISPLACEMENT: delete displacement_map; displacement_map = new Texture(path, Texture::DISPLACEMENT, callback); return;
+        case Texture::STENCIL:      delete stencil_map;      stencil_map      = new Texture(path, Texture::STENCIL, callback);      return;
         default: throw std::runtime_error("error: unknown texture map `" + std::to_string(texture) + "'");
     }
 }
@@ -6,6 +6,7 @@
 
 #include <glm/glm.hpp>
 
+#include <functional>
 #include <cstdint>
 #include <string>
 #include <map>
@@ -60,6 +61,9 @@ class Material {
 		float getRefractiveIndex() const;
 
         Texture *getTexture(const Texture::Type &texture) const;
+        std::string getDefines() const;
+        bool isAlphaTested() const;
+        bool isTransparent() const;
 
 
 		void setAmbientColor(const glm::vec3 &color);
@@ -74,7 +78,7 @@ class Material {
 		void setMetalness(const float &value);
 		void setRefractiveIndex(const float &value);
 
-        void setTexture(const std::string &path, const Texture::Type &texture);
+        void setTexture(const std::string &path, const Texture::Type &texture, const std::function<void()> &callback = nullptr);
 
 
         ~Material();
@@ -1,9 +1,18 @@
 #include "model.hpp"
+#include "loader.hpp"
+#include "scheduler.hpp"
 #include "dirseparator.hpp"
 
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtx/transform.hpp>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define MODEL_CULL_SSE
+#define MODEL_TRANSFORM_SSE
+#endif
+
+#include <cmath>
 #include <cctype>
 #include <limits>
 #include <sstream>
@@ -12,6 +21,16 @@
 #include <algorithm>
 #include <stdexcept>
 
+// Static const definitions
+constexpr const std::size_t Model::CLUSTER_VERTICES;
+constexpr const std::size_t Model::CLUSTER_TRIANGLES;
+constexpr const std::size_t Model::CLUSTER_GRAIN;
+constexpr const std::size_t Model::CULL_GRAIN;
+constexpr const std::size_t Model::LOAD_TRIANGLES;
+constexpr const std::size_t Model::OCCLUDER_TRIANGLES;
+constexpr const std::size_t Model::TRANSFORM_BATCH;
+
+
 // Right trim std::string
 void Model::rtrim(std::string &str) {
     std::size_t index = str.size();
@@ -27,7 +46,7 @@ void Model::rtrim(std::string &str) {
         str.resize(index);
 }
 
-// Read a OBJ file
+// Read a OBJ file in the loading thread
 void Model::readOBJ() {
     std::ifstream file(path);
     if (!file.is_open())
@@ -38,12 +57,18 @@ void Model::readOBJ() {
     std::string token;
     std::string line;
     glm::vec3 data;
-    std::size_t count = 0;
+
+    // Limits of the read geometry
+    glm::vec3 low(std::numeric_limits<float>::max());
+    glm::vec3 high(-std::numeric_limits<float>::max());
+
+    // The geometry before the first material belongs to the first group
+    group_stock.push_back(std::make_pair(std::string(), (std::size_t)0U));
 
     // Read file
-    while(!file.eof()) {
-        // Read line
-        std::getline(file, line);
+    while (!load_cancel && std::getline(file, line)) {
+        // Parsed bytes
+        load_bytes.fetch_add(line.size() + 1U, std::memory_order_relaxed);
 
         // Right trim line
         Model::rtrim(line);
@@ -56,46 +81,26 @@ void Model::readOBJ() {
         std::istringstream stream(line);
         stream >> token;
 
-        // Load material file data
+        // Material file path, published to the render thread when the loading finishes
         if (token == "mtllib") {
             // Get the relative path to the material file
             stream >> std::ws;
             std::getline(stream, token);
 
-            // Open material
-            material_path = path.substr(0, path.find_last_of(DIR_SEP) + 1) + token;
-			material_name = material_path.substr(material_path.find_last_of(DIR_SEP) + 1);
-
-			try {
-				readMTL();
-				material_open = true;
-			} catch (std::exception &exception) {
-				std::cerr << exception.what() << std::endl;
-			}
+            loaded_material = path.substr(0, path.find_last_of(DIR_SEP) + 1) + token;
         }
 
         // Set material
-        if ((token == "usemtl") && material_open) {
-            // Set count to the previous object
-            if (!model_stock.empty()) {
-                model_stock.back().count = (GLsizei)(index.size() - count);
-                count = index.size();
-            }
-
+        else if (token == "usemtl") {
 			// Read material name
 			stream >> std::ws;
 			std::getline(stream, token);
 
-			// Search material
-			Material *material = nullptr;
-            for (Material *const &material_it : material_stock)
-                if (material_it->getName() == token) {
-                    material = material_it;
-                    break;
-                }
-
-			// Add the new material
-            model_stock.push_back(Model::model_data{0, sizeof(std::uint32_t) * count, material});
+            // The first material takes the previous geometry
+            if ((group_stock.size() == 1U) && group_stock.back().first.empty())
+                group_stock.back().first = token;
+            else
+                group_stock.push_back(std::make_pair(token, index.size()));
         }
 
         // Store vertex
@@ -104,12 +109,8 @@ void Model::readOBJ() {
             vertex_position.push_back(data);
 
             // Update limits
-            if (data.x < min.x) min.x = data.x;
-            if (data.y < min.y) min.y = data.y;
-            if (data.z < min.z) min.z = data.z;
-            if (data.x > max.x) max.x = data.x;
-            if (data.y > max.y) max.y = data.y;
-            if (data.z > max.z) max.z = data.z;
+            low = glm::min(low, data);
+            high = glm::max(high, data);
         }
         
         // Store normal
@@ -142,34 +143,30 @@ void Model::readOBJ() {
 
             // Clear faces vector
             face.clear();
-        }
-    }
 
-    // Set count to the last object
-    if (!model_stock.empty())
-        model_stock.back().count = (GLsizei)(index.size() - count);
-
-    // Associate all geometry to the default material
-	else {
-        Material *material = new Material("Default");
-        material_stock.push_back(material);
-		model_stock.push_back(Model::model_data{(GLsizei)index.size(), 0U, material});
+            // Publish the geometry read so far
+            if (index.size() - published_indices >= 3U * Model::LOAD_TRIANGLES)
+                publishChunk(low, high);
+        }
     }
 
     // Close file
     file.close();
+    if (load_cancel)
+        return;
 
-    // Save statistics
-    polygons = index.size() / 3U;
-    vertices = vertex_position.size();
-    elements = vertex.size();
-	materials = material_stock.size();
+    // Publish the remaining geometry
+    publishChunk(low, high);
 
-    // Free memory
-    vertex_stock.clear();
-    vertex_position.clear();
-    vertex_uv_coord.clear();
-    vertex_normal.clear();
+    // Build the groups, the materials are associated by the render thread
+    for (std::size_t i = 0; i < group_stock.size(); i++) {
+        const std::size_t first = group_stock[i].second;
+        const std::size_t last = (i + 1U < group_stock.size() ? group_stock[i + 1U].second : index.size());
+        loaded_stock.push_back(Model::model_data{(GLsizei)(last - first), sizeof(std::uint32_t) * first, nullptr, 0U, 0U});
+    }
+
+    // Partition the geometry in clusters
+    buildClusters();
 }
 
 // Read the material lib file
@@ -379,21 +376,370 @@ void Model::storeVertex(const std::string &vertex_str) {
 }
 
 
-// Load data to GPU
-void Model::loadData() {
-    // Vertex array object
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
+// Partition each model group in clusters of close triangles, the culling state is left to the render thread
+void Model::buildClusters() {
+    // Clear previous clusters
+    loaded_cluster = Model::cluster_data();
+
+    // Last cluster where each vertex has been stored
+    std::vector<std::size_t> stamp(vertex.size(), std::numeric_limits<std::size_t>::max());
+
+    // Index range of each cluster
+    std::vector<std::pair<std::size_t, std::size_t> > range;
+
+    for (Model::model_data &model : loaded_stock) {
+        // Group range in the index vector
+        const std::size_t first = model.offset / sizeof(std::uint32_t);
+        const std::size_t last = first + (std::size_t)model.count;
+
+        // First cluster of the group
+        model.cluster_offset = range.size();
+
+        // Fill clusters with consecutive triangles
+        std::size_t begin = first;
+        std::size_t unique = 0U;
+        for (std::size_t i = first; i + 2U < last; i += 3U) {
+            // Count the vertices not yet stored in the current cluster
+            std::size_t id = range.size();
+            std::size_t fresh = (stamp[index[i]] != id) + (stamp[index[i + 1U]] != id) + (stamp[index[i + 2U]] != id);
+
+            // Close the current cluster if it is full
+            if ((unique + fresh > Model::CLUSTER_VERTICES) || ((i - begin) / 3U == Model::CLUSTER_TRIANGLES)) {
+                range.emplace_back(begin, i);
+                begin = i;
+                unique = 0U;
+                fresh = 3U;
+                id++;
+            }
 
-    // Vertex buffer object
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertex_data) * vertex.size(), &vertex[0], GL_STATIC_DRAW);
+            // Mark the triangle vertices
+            stamp[index[i]]      = id;
+            stamp[index[i + 1U]] = id;
+            stamp[index[i + 2U]] = id;
+            unique += fresh;
+        }
 
-    // Element array buffer
-    glGenBuffers(1, &ebo);
+        // Close the last cluster of the group
+        if (begin < last)
+            range.emplace_back(begin, last);
+
+        // Number of clusters of the group
+        model.cluster_count = range.size() - model.cluster_offset;
+    }
+
+    // Allocate the clusters
+    const std::size_t size = range.size();
+    loaded_cluster.x.resize(size);
+    loaded_cluster.y.resize(size);
+    loaded_cluster.z.resize(size);
+    loaded_cluster.radius.resize(size);
+    loaded_cluster.axis_x.resize(size);
+    loaded_cluster.axis_y.resize(size);
+    loaded_cluster.axis_z.resize(size);
+    loaded_cluster.cutoff.resize(size);
+    loaded_cluster.count.resize(size);
+    loaded_cluster.offset.resize(size);
+
+    // Compute the bounds of the clusters in parallel
+    Scheduler::getDefault()->parallelFor(0U, size, Model::CLUSTER_GRAIN, [this, &range](const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++)
+            storeCluster(i, range[i].first, range[i].second);
+    });
+
+    // Save the number of clusters
+    clusters = size;
+}
+
+// Store the bounding sphere and normal cone of the triangles in the index range
+void Model::storeCluster(const std::size_t &id, const std::size_t &begin, const std::size_t &end) {
+    // Bounding box
+    glm::vec3 low(std::numeric_limits<float>::max());
+    glm::vec3 high(-std::numeric_limits<float>::max());
+    for (std::size_t i = begin; i < end; i++) {
+        low  = glm::min(low,  vertex[index[i]].position);
+        high = glm::max(high, vertex[index[i]].position);
+    }
+
+    // Bounding sphere
+    const glm::vec3 center = (low + high) / 2.0F;
+    float radius = 0.0F;
+    for (std::size_t i = begin; i < end; i++)
+        radius = glm::max(radius, glm::distance(center, vertex[index[i]].position));
+
+    // Triangle normals and average axis
+    std::vector<glm::vec3> normal;
+    glm::vec3 axis(0.0F);
+    for (std::size_t i = begin; i + 2U < end; i += 3U) {
+        const glm::vec3 &a = vertex[index[i]].position;
+        const glm::vec3 face = glm::cross(vertex[index[i + 1U]].position - a, vertex[index[i + 2U]].position - a);
+
+        // Skip degenerated triangles
+        const float area = glm::length(face);
+        if (area > 0.0F) {
+            normal.push_back(face / area);
+            axis += normal.back();
+        }
+    }
+
+    // Normal cone cutoff, a cutoff of one never culls the cluster
+    float cutoff = 1.0F;
+    const float length = glm::length(axis);
+    if (length > 0.0F) {
+        axis /= length;
+
+        // Minimum cosine between the axis and any normal
+        float min_dot = 1.0F;
+        for (const glm::vec3 &face : normal)
+            min_dot = glm::min(min_dot, glm::dot(face, axis));
+
+        // Keep only narrow cones
+        if (min_dot > 0.1F)
+            cutoff = glm::sqrt(1.0F - min_dot * min_dot);
+    }
+
+    // Store cluster
+    loaded_cluster.x[id] = center.x;
+    loaded_cluster.y[id] = center.y;
+    loaded_cluster.z[id] = center.z;
+    loaded_cluster.radius[id] = radius;
+    loaded_cluster.axis_x[id] = axis.x;
+    loaded_cluster.axis_y[id] = axis.y;
+    loaded_cluster.axis_z[id] = axis.z;
+    loaded_cluster.cutoff[id] = cutoff;
+    loaded_cluster.count[id] = (GLsizei)(end - begin);
+    loaded_cluster.offset[id] = sizeof(std::uint32_t) * begin;
+}
+
+
+// Loading thread entry point
+void Model::loadThread() {
+    try {
+        readOBJ();
+    } catch (std::exception &exception) {
+        load_error = exception.what();
+    }
+
+    // Notify the render thread
+    load_done = true;
+}
+
+// Publish the geometry read since the last chunk
+void Model::publishChunk(const glm::vec3 &chunk_min, const glm::vec3 &chunk_max) {
+    Model::chunk_data chunk;
+    chunk.vertex.assign(vertex.begin() + published_vertices, vertex.end());
+    chunk.index.assign(index.begin() + published_indices, index.end());
+    chunk.min = chunk_min;
+    chunk.max = chunk_max;
+
+    published_vertices = vertex.size();
+    published_indices = index.size();
+
+    // Queue the chunk for the render thread
+    std::lock_guard<std::mutex> lock(chunk_mutex);
+    chunk_queue.push_back(std::move(chunk));
+}
+
+// Cancel and wait for the loading thread
+void Model::stopLoading() {
+    // Discard the upload in progress
+    Loader::cancel(upload_job);
+    upload_job = 0U;
+
+    if (loader.joinable()) {
+        load_cancel = true;
+        loader.join();
+    }
+
+    loading = false;
+}
+
+// Read the materials and set the model groups once all the geometry has been read
+void Model::finishLoading() {
+    loading = false;
+
+    // Publish the material library path, the loading thread has finished
+    material_path = loaded_material;
+    material_name = material_path.substr(material_path.find_last_of(DIR_SEP) + 1);
+    loaded_material.clear();
+
+    // Loading errors
+    if (!load_error.empty())
+        std::cerr << load_error << std::endl;
+
+    // Take the clusters and reset the culling results
+    cluster_visible.clear();
+    culled = false;
+
+    // Keep the uploaded geometry if the loading was cancelled or has failed
+    if (load_cancel || !load_error.empty()) {
+        cluster = Model::cluster_data();
+        clusters = 0U;
+        open = (uploaded_indices > 0U);
+    }
+
+    else {
+        cluster = std::move(loaded_cluster);
+
+        // Read the material library
+        if (!material_path.empty()) {
+			try {
+				readMTL();
+				material_open = true;
+			} catch (std::exception &exception) {
+				std::cerr << exception.what() << std::endl;
+			}
+        }
+
+        // Associate each group to its material
+        Material *default_material = nullptr;
+        std::vector<std::pair<std::string, std::size_t> >::const_iterator group = group_stock.begin();
+        for (Model::model_data &model : loaded_stock) {
+            if (material_open) {
+                for (Material *const &material : material_stock)
+                    if (material->getName() == group->first) {
+                        model.material = material;
+                        break;
+                    }
+            }
+
+            // Associate the geometry without material to the default material
+            if (model.material == nullptr) {
+                if (default_material == nullptr) {
+                    default_material = new Material("Default");
+                    material_stock.push_back(default_material);
+                }
+                model.material = default_material;
+            }
+
+            group++;
+        }
+
+        // Replace the loading group
+        model_stock.swap(loaded_stock);
+    }
+
+    // Save statistics
+    polygons = uploaded_indices / 3U;
+    vertices = vertex_position.size();
+    elements = uploaded_vertices;
+    materials = material_stock.size();
+    submitted = polygons;
+
+    // Keep the positions of the small models for the occlusion culling
+    occluder_vertex.clear();
+    occluder_index.clear();
+    if (!load_cancel && load_error.empty() && (index.size() / 3U <= Model::OCCLUDER_TRIANGLES)) {
+        occluder_vertex.reserve(vertex.size());
+        for (const Model::vertex_data &data : vertex)
+            occluder_vertex.push_back(data.position);
+        occluder_index = index;
+    }
+
+    // Free memory
+    loaded_stock.clear();
+    loaded_cluster = Model::cluster_data();
+    group_stock.clear();
+    vertex_stock.clear();
+    vertex_position.clear();
+    vertex_uv_coord.clear();
+    vertex_normal.clear();
+    vertex.clear();
+    index.clear();
+}
+
+
+// Grow a buffer keeping its content, returns true if the buffer has been replaced
+bool Model::growBuffer(GLuint &buffer, std::size_t &capacity, const std::size_t &used, const std::size_t &required) {
+    if (required <= capacity)
+        return false;
+
+    // New buffer of at least twice the capacity
+    const std::size_t new_capacity = std::max(required, 2U * capacity);
+    GLuint new_buffer;
+    glGenBuffers(1, &new_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)new_capacity, NULL, GL_STATIC_DRAW);
+
+    // Copy the previous content
+    if (used > 0U) {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)used);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // Replace buffer
+    glDeleteBuffers(1, &buffer);
+    buffer = new_buffer;
+    capacity = new_capacity;
+
+    return true;
+}
+
+// Upload a chunk at the end of the buffers, in the loader context for background loading
+void Model::loadChunk(const std::shared_ptr<Model::chunk_data> &chunk) {
+    // Uploaded and required sizes
+    const std::size_t vbo_used = sizeof(Model::vertex_data) * uploaded_vertices;
+    const std::size_t ebo_used = sizeof(std::uint32_t) * uploaded_indices;
+    const std::size_t vbo_size = sizeof(Model::vertex_data) * chunk->vertex.size();
+    const std::size_t ebo_size = sizeof(std::uint32_t) * chunk->index.size();
+
+    // Grow buffers in the render thread, there is no upload in progress
+    const bool vbo_grown = Model::growBuffer(vbo, vbo_capacity, vbo_used, vbo_used + vbo_size);
+    const bool ebo_grown = Model::growBuffer(ebo, ebo_capacity, ebo_used, ebo_used + ebo_size);
+    if (vbo_grown || ebo_grown)
+        bindAttributes();
+
+    // Write the chunk after the uploaded data
+    const GLuint vbo_id = vbo;
+    const GLuint ebo_id = ebo;
+    const std::function<void()> work = [chunk, vbo_id, ebo_id, vbo_used, ebo_used, vbo_size, ebo_size]() {
+        if (vbo_size > 0U) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, vbo_id);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)vbo_used, (GLsizeiptr)vbo_size, chunk->vertex.data());
+        }
+
+        if (ebo_size > 0U) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, ebo_id);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)ebo_used, (GLsizeiptr)ebo_size, chunk->index.data());
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    };
+
+    // Draw all the arrived geometry
+    const std::function<void()> done = [this, chunk]() {
+        upload_job = 0U;
+        uploaded_vertices += chunk->vertex.size();
+        uploaded_indices += chunk->index.size();
+
+        // Rebind the buffers to see the data written by other context
+        bindAttributes();
+
+        model_stock.back().count = (GLsizei)uploaded_indices;
+        polygons = uploaded_indices / 3U;
+        elements = uploaded_vertices;
+
+        // Update the origin with the new limits
+        min = chunk->min;
+        max = chunk->max;
+        setOrigin();
+    };
+
+    // Upload in the loader context or in place
+    if (load_async)
+        upload_job = Loader::push(work, done);
+    else {
+        work();
+        done();
+    }
+}
+
+// Bind the buffers and attributes to the vertex array object
+void Model::bindAttributes() {
+    // Vertex array object and buffers
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(std::uint32_t) * index.size(), &index[0], GL_STATIC_DRAW);
 
     // Position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_data), (void *)offsetof(vertex_data, position));
@@ -409,15 +755,101 @@ void Model::loadData() {
 
     // Ubnind array object and buffers
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    // Free memory
-    vertex.clear();
-    index.clear();
+// Start loading the model, in background if async
+void Model::load(const bool &async) {
+    // Stop the previous loading
+    stopLoading();
+
+    // Clear previous geometry
+    model_stock.clear();
+    loaded_stock.clear();
+    group_stock.clear();
+    chunk_queue.clear();
+    loaded_material.clear();
+    loaded_cluster = Model::cluster_data();
+    cluster = Model::cluster_data();
+    cluster_visible.clear();
+    culled = false;
+
+    // Delete buffers
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+    glDeleteVertexArrays(1, &vao);
+    vao = 0U;
+    vbo = 0U;
+    ebo = 0U;
+
+    // Initialize attributes
+    polygons = 0U;
+    vertices = 0U;
+    elements = 0U;
+    materials = 0U;
+    textures  = 0U;
+    clusters  = 0U;
+    submitted = 0U;
+    min = glm::vec3(std::numeric_limits<float>::max());
+    max = glm::vec3(std::numeric_limits<float>::min());
+
+	// Default status
+	open = false;
+	material_open = false;
+    material_path.clear();
+    material_name.clear();
+
+    // Loading status
+    published_vertices = 0U;
+    published_indices = 0U;
+    uploaded_vertices = 0U;
+    uploaded_indices = 0U;
+    vbo_capacity = 0U;
+    ebo_capacity = 0U;
+    load_async = async;
+    load_cancel = false;
+    load_done = false;
+    load_bytes = 0U;
+    load_size = 0U;
+    load_error.clear();
+
+    // Check path
+    if (path.empty())
+        return;
+
+    // Check the file and get its size
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the model `" << path << "'" << std::endl;
+        return;
+    }
+    load_size = (std::size_t)file.tellg();
+    file.close();
+
+    // Buffers
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    bindAttributes();
+
+    // Draw the arrived geometry with the loading material
+    model_stock.push_back(Model::model_data{0, 0U, load_material, 0U, 0U});
+    open = true;
+    loading = true;
+
+    // Read the file in background or in place
+    if (async)
+        loader = std::thread(&Model::loadThread, this);
+    else {
+        loadThread();
+        while (loading)
+            updateLoading();
+    }
 }
 
 
 // Model constructor
-Model::Model(const std::string &file_path) {
+Model::Model(const std::string &file_path, const bool &async) : load_cancel(false), load_done(false), load_bytes(0U) {
     // Set path and name
     path = file_path;
     name = path.substr(path.find_last_of(DIR_SEP) + 1);
@@ -428,57 +860,351 @@ Model::Model(const std::string &file_path) {
     elements = 0U;
     materials = 0U;
     textures  = 0U;
+    clusters  = 0U;
+    submitted = 0U;
     min = glm::vec3(std::numeric_limits<float>::max());
     max = glm::vec3(std::numeric_limits<float>::min());
 
 	// Default status
 	open = false;
 	material_open = false;
-
-    if (!file_path.empty()) {
-	    try {
-            // Read file and load data to GPU
-                readOBJ();
-                loadData();
-                open = true;
-	    } catch (std::exception &exception) {
-		    std::cerr << exception.what() << std::endl;
-	    }
-    }
+    culled = false;
+    transform_dirty = true;
+    shadow_dirty = true;
+
+    // Culling status
+    cluster_culling = true;
+    cone_culling = true;
+
+    // Buffers
+    vao = 0U;
+    vbo = 0U;
+    ebo = 0U;
+
+    // Loading status
+    loading = false;
+    load_size = 0U;
+    published_vertices = 0U;
+    published_indices = 0U;
+    uploaded_vertices = 0U;
+    uploaded_indices = 0U;
+    vbo_capacity = 0U;
+    ebo_capacity = 0U;
+    upload_job = 0U;
+    load_async = false;
+    load_material = new Material("Default");
+
+    // Read file and load data to GPU
+    if (!file_path.empty())
+        load(async);
 
     // Initialize matrices
     reset();
 }
 
-// Draw model
-void Model::draw(GLSLProgram *const program) const {
+// Upload the published geometry, returns true when the loading has finished
+bool Model::updateLoading() {
+    if (!loading)
+        return false;
+
+    // Wait for the upload in progress
+    if (upload_job != 0U)
+        return false;
+
+    // Check the loading thread status before taking the last chunks
+    const bool done = load_done;
+
+    // Take the published chunks
+    std::deque<Model::chunk_data> chunks;
+    {
+        std::lock_guard<std::mutex> lock(chunk_mutex);
+        chunks.swap(chunk_queue);
+    }
+
+    // Merge and upload the chunks, the loading finishes after the upload
+    if (!chunks.empty()) {
+        std::shared_ptr<Model::chunk_data> upload = std::make_shared<Model::chunk_data>(std::move(chunks.front()));
+        for (std::deque<Model::chunk_data>::const_iterator chunk = chunks.begin() + 1; chunk != chunks.end(); chunk++) {
+            upload->vertex.insert(upload->vertex.end(), chunk->vertex.begin(), chunk->vertex.end());
+            upload->index.insert(upload->index.end(), chunk->index.begin(), chunk->index.end());
+            upload->min = chunk->min;
+            upload->max = chunk->max;
+        }
+
+        loadChunk(upload);
+        return false;
+    }
+
+    // Wait for the loading thread
+    if (!done)
+        return false;
+
+    if (loader.joinable())
+        loader.join();
+
+    finishLoading();
+    return true;
+}
+
+// Cancel the loading keeping the arrived geometry
+void Model::cancelLoading() {
+    if (loading)
+        load_cancel = true;
+}
+
+// Cull the clusters outside of the camera frustum or facing away of the camera
+void Model::cull(const Camera *const camera, const OcclusionBuffer *const occlusion) {
+    // Draw all clusters by default
+    culled = false;
+    submitted = polygons;
+    if (!cluster_culling || !open || loading || cluster.count.empty())
+        return;
+
+    // Model matrix and model view projection matrix
+    updateTransform();
+    const glm::mat4 &model_mat = world_mat;
+    const glm::mat4 mvp = camera->getProjectionMatrix() * camera->getViewMatrix() * model_mat;
+
+    // Frustum planes in model space
+    glm::vec4 plane[6];
+    for (int i = 0; i < 3; i++) {
+        const glm::vec4 row(mvp[0][i], mvp[1][i], mvp[2][i], mvp[3][i]);
+        const glm::vec4 row_w(mvp[0][3], mvp[1][3], mvp[2][3], mvp[3][3]);
+        plane[2 * i]     = row_w + row;
+        plane[2 * i + 1] = row_w - row;
+    }
+    for (glm::vec4 &p : plane)
+        p /= glm::length(glm::vec3(p));
+
+    // Camera in model space, mirrored models invert the faces orientation
+    const glm::mat4 inverse_mat = glm::inverse(model_mat);
+    const glm::vec3 eye = glm::vec3(inverse_mat * glm::vec4(camera->getPosition(), 1.0F));
+    const glm::vec3 look = glm::normalize(glm::mat3(inverse_mat) * camera->getLookDirection());
+    const float flip = (glm::determinant(glm::mat3(model_mat)) < 0.0F ? -1.0F : 1.0F);
+    const bool orthogonal = camera->isOrthogonal();
+    const bool cone = cone_culling;
+
+    // Visibility test for every cluster, the ranges are multiple of four for the vectorized test
+    const std::size_t size = cluster.count.size();
+    cluster_visible.resize(size);
+    Scheduler::getDefault()->parallelFor(0U, size, Model::CULL_GRAIN, [&](const std::size_t &begin, const std::size_t &end) {
+        std::size_t i = begin;
+
+#ifdef MODEL_CULL_SSE
+        // Four clusters at once
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 sign = _mm_set1_ps(flip);
+        for (; i + 4U <= end; i += 4U) {
+            const __m128 x = _mm_loadu_ps(&cluster.x[i]);
+            const __m128 y = _mm_loadu_ps(&cluster.y[i]);
+            const __m128 z = _mm_loadu_ps(&cluster.z[i]);
+            const __m128 r = _mm_loadu_ps(&cluster.radius[i]);
+
+            // Sphere against the frustum planes
+            __m128 visible = _mm_cmpeq_ps(zero, zero);
+            for (const glm::vec4 &p : plane) {
+                __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), x), _mm_mul_ps(_mm_set1_ps(p.y), y));
+                distance = _mm_add_ps(distance, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), z), _mm_set1_ps(p.w)));
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+            }
+
+            // Normal cone against the view direction
+            if (cone) {
+                const __m128 ax = _mm_loadu_ps(&cluster.axis_x[i]);
+                const __m128 ay = _mm_loadu_ps(&cluster.axis_y[i]);
+                const __m128 az = _mm_loadu_ps(&cluster.axis_z[i]);
+                const __m128 cutoff = _mm_loadu_ps(&cluster.cutoff[i]);
+                __m128 back;
+
+                if (orthogonal) {
+                    __m128 dot = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(look.x), ax), _mm_mul_ps(_mm_set1_ps(look.y), ay));
+                    dot = _mm_mul_ps(sign, _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(look.z), az)));
+                    back = _mm_cmpge_ps(dot, cutoff);
+                }
+                else {
+                    const __m128 dx = _mm_sub_ps(x, _mm_set1_ps(eye.x));
+                    const __m128 dy = _mm_sub_ps(y, _mm_set1_ps(eye.y));
+                    const __m128 dz = _mm_sub_ps(z, _mm_set1_ps(eye.z));
+                    __m128 dot = _mm_add_ps(_mm_mul_ps(dx, ax), _mm_mul_ps(dy, ay));
+                    dot = _mm_mul_ps(sign, _mm_add_ps(dot, _mm_mul_ps(dz, az)));
+                    const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+                    back = _mm_cmpge_ps(dot, _mm_add_ps(_mm_mul_ps(cutoff, length), r));
+                }
+
+                visible = _mm_andnot_ps(back, visible);
+            }
+
+            // Store results
+            const int mask = _mm_movemask_ps(visible);
+            cluster_visible[i]      = (std::uint8_t)( mask       & 1);
+            cluster_visible[i + 1U] = (std::uint8_t)((mask >> 1) & 1);
+            cluster_visible[i + 2U] = (std::uint8_t)((mask >> 2) & 1);
+            cluster_visible[i + 3U] = (std::uint8_t)((mask >> 3) & 1);
+        }
+#endif
+
+        // Remaining clusters
+        for (; i < end; i++) {
+            const glm::vec3 center(cluster.x[i], cluster.y[i], cluster.z[i]);
+            const float radius = cluster.radius[i];
+
+            // Sphere against the frustum planes
+            bool visible = true;
+            for (const glm::vec4 &p : plane)
+                visible &= (glm::dot(glm::vec3(p), center) + p.w + radius >= 0.0F);
+
+            // Normal cone against the view direction
+            if (visible && cone) {
+                const glm::vec3 axis(cluster.axis_x[i], cluster.axis_y[i], cluster.axis_z[i]);
+                if (orthogonal)
+                    visible = (flip * glm::dot(look, axis) < cluster.cutoff[i]);
+                else
+                    visible = (flip * glm::dot(center - eye, axis) < cluster.cutoff[i] * glm::distance(center, eye) + radius);
+            }
+
+            cluster_visible[i] = (std::uint8_t)visible;
+        }
+
+        // Clusters hidden behind the occluders
+        if (occlusion != nullptr)
+            for (std::size_t j = begin; j < end; j++) {
+                if (!cluster_visible[j]) continue;
+
+                const glm::vec3 center(cluster.x[j], cluster.y[j], cluster.z[j]);
+                const glm::vec3 radius(cluster.radius[j]);
+                cluster_visible[j] = (std::uint8_t)occlusion->isVisible(center - radius, center + radius, model_mat, OcclusionBuffer::CLUSTER);
+            }
+    });
+
+    // Compact the visible clusters of each group in draw ranges
+    visible_count.clear();
+    visible_offset.clear();
+    visible_ranges.clear();
+    submitted = 0U;
+    for (const Model::model_data &model : model_stock) {
+        GLsizei ranges = 0;
+        std::size_t end = 0U;
+
+        for (std::size_t j = model.cluster_offset; j < model.cluster_offset + model.cluster_count; j++) {
+            if (!cluster_visible[j]) continue;
+
+            // Merge with the previous range if they are contiguous
+            if ((ranges > 0) && (cluster.offset[j] == end))
+                visible_count.back() += cluster.count[j];
+
+            // New range
+            else {
+                visible_count.push_back(cluster.count[j]);
+                visible_offset.push_back((const void *)(uintptr_t)cluster.offset[j]);
+                ranges++;
+            }
+
+            end = cluster.offset[j] + sizeof(std::uint32_t) * cluster.count[j];
+            submitted += (std::size_t)cluster.count[j] / 3U;
+        }
+
+        visible_ranges.push_back(ranges);
+    }
+
+    // Use the culling results in the next draw
+    culled = true;
+}
+
+// Add the triangles of the model to the occluders, returns false if the triangles budget is full
+bool Model::addOccluder(OcclusionBuffer *const occlusion) const {
+    updateTransform();
+    return occlusion->addOccluder(occluder_vertex, occluder_index, world_mat);
+}
+
+// Test the model limits against the occluders
+bool Model::isOccluded(const OcclusionBuffer *const occlusion) const {
+    if (!open || loading)
+        return false;
+
+    updateTransform();
+    return !occlusion->isVisible(min, max, world_mat, OcclusionBuffer::MODEL);
+}
+
+// Draw model, the select function can replace the program of each material group or skip it with a null program
+void Model::draw(GLSLProgram *const program, const std::function<GLSLProgram *(const Material *const)> &select) const {
     // Check program
     if (!program->isValid()) return;
 
-    // Use GLSL program
-    program->use();
+    // Model matrices
+    updateTransform();
+
+    // Use a program and set the model uniforms if it is different from the current one
+    GLSLProgram *current = nullptr;
+    const auto use = [&](const Material *const material) {
+        GLSLProgram *const next = (select ? select(material) : program);
+        if (next == nullptr)
+            return false;
+
+        if (next != current) {
+            current = next;
+            current->use();
+            current->setUniform("model_mat", world_mat);
+            current->setUniform("normal_mat", normal_mat);
+        }
 
-    // Set model uniforms
-    glm::mat4 normal_mat = glm::translate(position) * glm::mat4_cast(rotation);
-    program->setUniform("model_mat", normal_mat * glm::scale(scale) * origin_mat);
-    program->setUniform("normal_mat", glm::mat3(glm::inverse(glm::transpose(normal_mat))));
+        // Bind material
+        material->use(current);
+        return true;
+    };
 
     // Bind vertex array object and buffers
     glBindVertexArray(vao);
 
+    // Draw the visible clusters
+    if (culled) {
+        std::size_t group = 0U;
+        std::size_t range = 0U;
+        for (const Model::model_data &model : model_stock) {
+            const GLsizei ranges = visible_ranges[group++];
+            if (ranges == 0) continue;
+
+            // Bind program and material
+            if (use(model.material))
+                glMultiDrawElements(GL_TRIANGLES, &visible_count[range], GL_UNSIGNED_INT, &visible_offset[range], ranges);
+
+            range += (std::size_t)ranges;
+        }
+    }
+
     // Draw objects
-    for (const Model::model_data &model : model_stock) {
-        // Bind material
-		model.material->use(program);
+    else {
+        for (const Model::model_data &model : model_stock) {
+            // Bind program and material
+            if (!use(model.material))
+                continue;
 
-        // Draw triangles
-        glDrawElements(GL_TRIANGLES, model.count, GL_UNSIGNED_INT, (void *)(uintptr_t)model.offset);
+            // Draw triangles
+            glDrawElements(GL_TRIANGLES, model.count, GL_UNSIGNED_INT, (void *)(uintptr_t)model.offset);
+        }
     }
 
     // Unbind vertex array object and buffers
     glBindVertexArray(0);
 }
 
+// Draw all the triangles with one program, without materials nor the view culling
+void Model::drawDepth(GLSLProgram *const program) const {
+    // Check program
+    if (!program->isValid()) return;
+
+    // Model matrices
+    updateTransform();
+    program->use();
+    program->setUniform("model_mat", world_mat);
+    program->setUniform("normal_mat", normal_mat);
+
+    // Draw the material groups
+    glBindVertexArray(vao);
+    for (const Model::model_data &model : model_stock)
+        glDrawElements(GL_TRIANGLES, model.count, GL_UNSIGNED_INT, (void *)(uintptr_t)model.offset);
+    glBindVertexArray(0);
+}
+
 // Normalize and center model
 void Model::reset() {
     // Initialize values
@@ -487,24 +1213,55 @@ void Model::reset() {
     scale = glm::vec3(1.0F);
 
     // Setup origin matrix
+    setOrigin();
+}
+
+// Setup the origin matrix from the model limits
+void Model::setOrigin() {
     glm::vec3 dim = 1.0F / (max - min);
     float min_dim = glm::min(glm::min(dim.x, dim.y), dim.z);
     origin_mat = glm::scale(glm::vec3(min_dim)) * glm::translate((min + max) / -2.0F);
+    transform_dirty = true;
+    shadow_dirty = true;
+}
+
+// Compute the world and normal matrices if the transformation changed, the origin matrix is a uniform scale and a translation
+void Model::updateTransform() const {
+    if (!transform_dirty)
+        return;
+
+    // The inverse transpose of the rotation and translation is the rotation itself
+    normal_mat = glm::mat3_cast(rotation);
+
+    const float origin_scale = origin_mat[0][0];
+    const glm::vec3 origin_offset(origin_mat[3]);
+    world_mat[0] = glm::vec4(normal_mat[0] * (scale.x * origin_scale), 0.0F);
+    world_mat[1] = glm::vec4(normal_mat[1] * (scale.y * origin_scale), 0.0F);
+    world_mat[2] = glm::vec4(normal_mat[2] * (scale.z * origin_scale), 0.0F);
+    world_mat[3] = glm::vec4(position + normal_mat * (scale * origin_offset), 1.0F);
+
+    transform_dirty = false;
 }
 
 // Translate model
 void Model::translate(const glm::vec3 &delta) {
     position += delta;
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 // Rotate the model
 void Model::rotate(const glm::vec3 &angles) {
     rotation = glm::normalize(glm::quat(glm::radians(angles)) * rotation);
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 // Rotate the model
 void Model::rotate(const glm::quat &quaternion) {
     rotation = glm::normalize(quaternion * rotation);
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 // Resize the model
@@ -516,26 +1273,37 @@ void Model::resize(const glm::vec3 &proportion) {
     if (!std::isfinite(scale.x)) scale.x = 0.001F;
     if (!std::isfinite(scale.y)) scale.y = 0.001F;
     if (!std::isfinite(scale.z)) scale.z = 0.001F;
+
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 // Set new position
 void Model::setPosition(const glm::vec3 &position_new) {
     position = position_new;
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 // Set new rotation
 void Model::setRotation(const glm::vec3 &rotation_new) {
     rotation = glm::normalize(glm::quat(glm::radians(rotation_new - getRotationAngles())) * rotation);
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 // Set new rotation
 void Model::setRotation(const glm::quat &rotation_new) {
     rotation = rotation_new;
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 // Set new scale
 void Model::setScale(const glm::vec3 &scale_new) {
     scale = scale_new;
+    transform_dirty = true;
+    shadow_dirty = true;
 }
 
 
@@ -547,6 +1315,26 @@ void Model::setMatrix(const glm::mat4 &matrix) {
 
     // Decompose matrix
     glm::decompose(matrix, scale, rotation, position, dummy_skew, dummy_perspective);
+
+    transform_dirty = true;
+    shadow_dirty = true;
+}
+
+
+
+// Set the cluster culling status
+void Model::setClusterCulling(const bool &status) {
+    cluster_culling = status;
+}
+
+// Set the normal cone culling status
+void Model::setConeCulling(const bool &status) {
+    cone_culling = status;
+}
+
+// Set the changed status of the shadow maps, the transformations and the arrived geometry set it
+void Model::setShadowDirty(const bool &status) {
+    shadow_dirty = status;
 }
 
 
@@ -560,6 +1348,40 @@ bool Model::isMaterialOpen() const {
 	return material_open;
 }
 
+// Get the loading status
+bool Model::isLoading() const {
+    return loading;
+}
+
+// Get the cluster culling status
+bool Model::isClusterCulling() const {
+    return cluster_culling;
+}
+
+// Get the normal cone culling status
+bool Model::isConeCulling() const {
+    return cone_culling;
+}
+
+// Check if the model has occluder geometry
+bool Model::isOccluder() const {
+    return open && !loading && !occluder_index.empty();
+}
+
+// Check if any material group is transparent
+bool Model::isTransparent() const {
+    for (const Model::model_data &model : model_stock)
+        if ((model.material != nullptr) && model.material->isTransparent())
+            return true;
+
+    return false;
+}
+
+// Get the changed status of the shadow maps
+bool Model::isShadowDirty() const {
+    return shadow_dirty;
+}
+
 
 
 // Get model path
@@ -589,9 +1411,16 @@ glm::mat4 Model::getOriginMatrix() const {
     return origin_mat;
 }
 
-// Get model matrix
+// Get model matrix, from the model space to the world space
 glm::mat4 Model::getModelMatrix() const {
-    return glm::mat4_cast(rotation) * glm::translate(position) * glm::scale(scale);
+    updateTransform();
+    return world_mat;
+}
+
+// Get the normal matrix
+glm::mat3 Model::getNormalMatrix() const {
+    updateTransform();
+    return normal_mat;
 }
 
 // Rotation angles
@@ -614,6 +1443,16 @@ glm::vec3 Model::getScale() const {
     return scale;
 }
 
+// Bounding sphere of the limits in world space
+glm::vec4 Model::getBoundingSphere() const {
+    updateTransform();
+    const glm::vec3 center = glm::vec3(world_mat * glm::vec4(0.5F * (min + max), 1.0F));
+    const glm::vec3 half = 0.5F * (max - min);
+    const glm::mat3 linear(world_mat);
+    const glm::vec3 extent = glm::abs(linear[0]) * half.x + glm::abs(linear[1]) * half.y + glm::abs(linear[2]) * half.z;
+    return glm::vec4(center, glm::length(extent));
+}
+
 
 // Get the total of polygons
 std::size_t Model::getPolygons() const {
@@ -640,14 +1479,134 @@ std::size_t Model::getTextures() const {
     return textures;
 }
 
+// Get the number of clusters
+std::size_t Model::getClusters() const {
+    return clusters;
+}
+
+// Get the number of polygons submitted in the last draw
+std::size_t Model::getSubmittedPolygons() const {
+    return submitted;
+}
+
+// Get the number of bytes read by the loading thread
+std::size_t Model::getLoadedBytes() const {
+    return load_bytes;
+}
+
+// Get the size of the model file
+std::size_t Model::getLoadSize() const {
+    return load_size;
+}
+
+// Get the GPU memory in bytes of the vertex and element buffers
+std::size_t Model::getMemory() const {
+    return vbo_capacity + ebo_capacity;
+}
+
 
 // Material
-std::list<Material *> Model::getMaterialStock() const {
+const std::list<Material *> &Model::getMaterialStock() const {
     return material_stock;
 }
 
+
+// Compute the matrices of the changed models in one pass, a static scene only checks the flags
+void Model::updateTransforms(const std::vector<Model *> &models) {
+    std::vector<Model *> dirty;
+    for (Model *const &model : models)
+        if (model->transform_dirty)
+            dirty.push_back(model);
+
+    std::size_t i = 0U;
+
+#ifdef MODEL_TRANSFORM_SSE
+    // Four models at once, the attributes are gathered in structure of arrays layout
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 two = _mm_set1_ps(2.0F);
+    for (; i + Model::TRANSFORM_BATCH <= dirty.size(); i += Model::TRANSFORM_BATCH) {
+        float input[14][Model::TRANSFORM_BATCH];
+        for (std::size_t j = 0U; j < Model::TRANSFORM_BATCH; j++) {
+            const Model *const model = dirty[i + j];
+            input[0][j]  = model->rotation.x;
+            input[1][j]  = model->rotation.y;
+            input[2][j]  = model->rotation.z;
+            input[3][j]  = model->rotation.w;
+            input[4][j]  = model->scale.x * model->origin_mat[0][0];
+            input[5][j]  = model->scale.y * model->origin_mat[0][0];
+            input[6][j]  = model->scale.z * model->origin_mat[0][0];
+            input[7][j]  = model->scale.x * model->origin_mat[3][0];
+            input[8][j]  = model->scale.y * model->origin_mat[3][1];
+            input[9][j]  = model->scale.z * model->origin_mat[3][2];
+            input[10][j] = model->position.x;
+            input[11][j] = model->position.y;
+            input[12][j] = model->position.z;
+        }
+
+        const __m128 x = _mm_loadu_ps(input[0]);
+        const __m128 y = _mm_loadu_ps(input[1]);
+        const __m128 z = _mm_loadu_ps(input[2]);
+        const __m128 w = _mm_loadu_ps(input[3]);
+
+        // Rotation matrix of the quaternions, stored by columns as in GLM
+        const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        __m128 r[3][3];
+        r[0][0] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+        r[0][1] = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+        r[0][2] = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+        r[1][0] = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+        r[1][1] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+        r[1][2] = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+        r[2][0] = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+        r[2][1] = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+        r[2][2] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+        // Scaled columns and translation of the world matrix
+        float output[21][Model::TRANSFORM_BATCH];
+        for (int c = 0; c < 3; c++) {
+            const __m128 column_scale = _mm_loadu_ps(input[4 + c]);
+            for (int e = 0; e < 3; e++) {
+                _mm_storeu_ps(output[c * 3 + e], r[c][e]);
+                _mm_storeu_ps(output[9 + c * 3 + e], _mm_mul_ps(r[c][e], column_scale));
+            }
+        }
+
+        const __m128 ox = _mm_loadu_ps(input[7]);
+        const __m128 oy = _mm_loadu_ps(input[8]);
+        const __m128 oz = _mm_loadu_ps(input[9]);
+        for (int e = 0; e < 3; e++) {
+            __m128 translation = _mm_add_ps(_mm_loadu_ps(input[10 + e]), _mm_mul_ps(r[0][e], ox));
+            translation = _mm_add_ps(translation, _mm_add_ps(_mm_mul_ps(r[1][e], oy), _mm_mul_ps(r[2][e], oz)));
+            _mm_storeu_ps(output[18 + e], translation);
+        }
+
+        // Scatter the matrices
+        for (std::size_t j = 0U; j < Model::TRANSFORM_BATCH; j++) {
+            const Model *const model = dirty[i + j];
+            for (int c = 0; c < 3; c++) {
+                model->normal_mat[c] = glm::vec3(output[c * 3][j], output[c * 3 + 1][j], output[c * 3 + 2][j]);
+                model->world_mat[c] = glm::vec4(output[9 + c * 3][j], output[10 + c * 3][j], output[11 + c * 3][j], 0.0F);
+            }
+            model->world_mat[3] = glm::vec4(output[18][j], output[19][j], output[20][j], 1.0F);
+            model->transform_dirty = false;
+        }
+    }
+#endif
+
+    // Remaining models
+    for (; i < dirty.size(); i++)
+        dirty[i]->updateTransform();
+}
+
 // Delete model
 Model::~Model() {
+    // Stop the loading thread
+    stopLoading();
+    delete load_material;
+
 	// Delete all materials
 	for (const Material *const &material : material_stock)
 		delete material;
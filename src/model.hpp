@@ -3,15 +3,23 @@
 
 #include "material.hpp"
 #include "glslprogram.hpp"
+#include "camera.hpp"
+#include "occlusionbuffer.hpp"
 
 #include "glad/glad.h"
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/glm.hpp>
 
+#include <functional>
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <list>
 #include <map>
 
@@ -28,17 +36,87 @@ class Model {
         std::vector<glm::vec2> vertex_uv_coord;
         std::vector<glm::vec3> vertex_normal;
 
+        // Cluster bounds in structure of arrays layout
+        struct cluster_data {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+            std::vector<float> radius;
+            std::vector<float> axis_x;
+            std::vector<float> axis_y;
+            std::vector<float> axis_z;
+            std::vector<float> cutoff;
+            std::vector<GLsizei> count;
+            std::vector<std::size_t> offset;
+        };
+
+        // Geometry published by the loading thread
+        struct chunk_data {
+            std::vector<Model::vertex_data> vertex;
+            std::vector<std::uint32_t> index;
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
         // Indexed model data
         std::map<std::string, std::uint32_t> vertex_stock;
         std::vector<std::uint32_t> index;
         std::vector<Model::vertex_data> vertex;
 
+        // Material groups, material library and clusters read by the loading thread, taken by the render thread when it finishes
+        std::vector<std::pair<std::string, std::size_t> > group_stock;
+        std::string loaded_material;
+        Model::cluster_data loaded_cluster;
+        std::size_t published_vertices;
+        std::size_t published_indices;
+
+        // Loading thread and published chunks
+        std::thread loader;
+        std::mutex chunk_mutex;
+        std::deque<Model::chunk_data> chunk_queue;
+        std::atomic<bool> load_cancel;
+        std::atomic<bool> load_done;
+        std::atomic<std::size_t> load_bytes;
+        std::size_t load_size;
+        std::string load_error;
+
+        // Uploaded data and buffers capacity
+        std::size_t uploaded_vertices;
+        std::size_t uploaded_indices;
+        std::size_t vbo_capacity;
+        std::size_t ebo_capacity;
+        Material *load_material;
+
+        // Upload in the loader context
+        std::size_t upload_job;
+        bool load_async;
+
+        // Clusters and culling results
+        Model::cluster_data cluster;
+        std::vector<std::uint8_t> cluster_visible;
+        std::vector<GLsizei> visible_count;
+        std::vector<const void *> visible_offset;
+        std::vector<GLsizei> visible_ranges;
+        bool culled;
+
+        // Positions and indices kept for the occlusion culling, only the small models are occluders
+        std::vector<glm::vec3> occluder_vertex;
+        std::vector<std::uint32_t> occluder_index;
+
         // Geometry attributes
         glm::mat4 origin_mat;
         glm::vec3 position;
         glm::quat rotation;
         glm::vec3 scale;
 
+        // World and normal matrices, computed again when the transformation changes
+        mutable glm::mat4 world_mat;
+        mutable glm::mat3 normal_mat;
+        mutable bool transform_dirty;
+
+        // Geometry or transformation changed since the last shadow maps update
+        bool shadow_dirty;
+
         // Disable copy and assignation
         Model() = delete;
         Model(const Model &) = delete;
@@ -47,14 +125,46 @@ class Model {
 		// Store vertex
         void storeVertex(const std::string &vertex_data);
 
+        // Loading thread
+        void loadThread();
+        void publishChunk(const glm::vec3 &chunk_min, const glm::vec3 &chunk_max);
+        void stopLoading();
+        void finishLoading();
+
+        // Upload geometry to the growing buffers
+        void loadChunk(const std::shared_ptr<Model::chunk_data> &chunk);
+        void bindAttributes();
+
+        // Set the origin matrix from the limits
+        void setOrigin();
+
+        // Compute the world and normal matrices if the transformation changed
+        void updateTransform() const;
+
+        // Build and store clusters
+        void buildClusters();
+        void storeCluster(const std::size_t &id, const std::size_t &begin, const std::size_t &end);
+
         // Static methods
         static void rtrim(std::string &str);
+        static bool growBuffer(GLuint &buffer, std::size_t &capacity, const std::size_t &used, const std::size_t &required);
+
+        // Static const attributes
+        static constexpr const std::size_t CLUSTER_VERTICES = 64U;
+        static constexpr const std::size_t CLUSTER_TRIANGLES = 124U;
+        static constexpr const std::size_t CLUSTER_GRAIN = 256U;
+        static constexpr const std::size_t CULL_GRAIN = 4096U;
+        static constexpr const std::size_t LOAD_TRIANGLES = 65536U;
+        static constexpr const std::size_t OCCLUDER_TRIANGLES = 16384U;
+        static constexpr const std::size_t TRANSFORM_BATCH = 4U;
 
 	protected:
         struct model_data {
             GLsizei count;
             std::size_t offset;
             Material *material;
+            std::size_t cluster_offset;
+            std::size_t cluster_count;
         };
 
 		// File path and name
@@ -69,9 +179,17 @@ class Model {
 		bool open;
 		bool material_open;
 
+		// Culling status
+		bool cluster_culling;
+		bool cone_culling;
+
 		// Model and material stock
 		std::list<Model::model_data> model_stock;
 		std::list<Material *> material_stock;
+		std::list<Model::model_data> loaded_stock;
+
+		// Loading status
+		bool loading;
 
 		// Limits
 		glm::vec3 max;
@@ -82,25 +200,34 @@ class Model {
 		GLuint vbo;
 		GLuint ebo;
 
-		// Statistics
+		// Statistics, the clusters are counted by the loading thread
         std::size_t polygons;
 		std::size_t vertices;
         std::size_t elements;
 		std::size_t materials;
         std::size_t textures;
+        std::atomic<std::size_t> clusters;
+        std::size_t submitted;
 
 		// File reading
 		void readOBJ();
 		void readMTL();
 
-		// Load data to GPU
-		void loadData();
-		
+		// Start loading the model, in background if async
+		void load(const bool &async);
+
 
     public:
-        Model(const std::string &file_path = "");
+        Model(const std::string &file_path = "", const bool &async = false);
+
+        bool updateLoading();
+        void cancelLoading();
 
-        void draw(GLSLProgram *const program) const;
+        void cull(const Camera *const camera, const OcclusionBuffer *const occlusion = nullptr);
+        bool addOccluder(OcclusionBuffer *const occlusion) const;
+        bool isOccluded(const OcclusionBuffer *const occlusion) const;
+        void draw(GLSLProgram *const program, const std::function<GLSLProgram *(const Material *const)> &select = nullptr) const;
+        void drawDepth(GLSLProgram *const program) const;
 
         void reset();
         
@@ -116,8 +243,18 @@ class Model {
 
         void setMatrix(const glm::mat4 &matrix);
 
+        void setClusterCulling(const bool &status);
+        void setConeCulling(const bool &status);
+        void setShadowDirty(const bool &status);
+
         bool isOpen() const;
 		bool isMaterialOpen() const;
+        bool isLoading() const;
+        bool isClusterCulling() const;
+        bool isConeCulling() const;
+        bool isOccluder() const;
+        bool isTransparent() const;
+        bool isShadowDirty() const;
 
         std::string getPath() const;
 		std::string getMaterialPath() const;
@@ -127,19 +264,29 @@ class Model {
 
         glm::mat4 getOriginMatrix() const;
         glm::mat4 getModelMatrix() const;
+        glm::mat3 getNormalMatrix() const;
 
         glm::vec3 getPosition() const;
         glm::vec3 getRotationAngles() const;
         glm::quat getRotationQuaternion() const;
         glm::vec3 getScale() const;
+        glm::vec4 getBoundingSphere() const;
 
         std::size_t getPolygons() const;
         std::size_t getVertices() const;
         std::size_t getElements() const;
         std::size_t getMaterials() const;
         std::size_t getTextures() const;
+        std::size_t getClusters() const;
+        std::size_t getSubmittedPolygons() const;
+        std::size_t getLoadedBytes() const;
+        std::size_t getLoadSize() const;
+        std::size_t getMemory() const;
+
+		const std::list<Material *> &getMaterialStock() const;
+
 
-		std::list<Material *> getMaterialStock() const;
+        static void updateTransforms(const std::vector<Model *> &models);
 
         ~Model();
 };
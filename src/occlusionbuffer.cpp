@@ -0,0 +1,333 @@
+#include "occlusionbuffer.hpp"
+#include "scheduler.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define OCCLUSION_SSE
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cmath>
+
+// Static const definitions
+constexpr const std::int32_t OcclusionBuffer::BAND;
+constexpr const std::size_t OcclusionBuffer::SETUP_GRAIN;
+constexpr const std::int32_t OcclusionBuffer::WIDTH;
+constexpr const std::int32_t OcclusionBuffer::HEIGHT;
+constexpr const std::size_t OcclusionBuffer::MAX_OCCLUDERS;
+constexpr const std::size_t OcclusionBuffer::MAX_TRIANGLES;
+
+
+// Occlusion buffer constructor, the debug texture is created on the first upload
+OcclusionBuffer::OcclusionBuffer() {
+    // Levels until one of the sides has a single texel
+    for (std::int32_t width = OcclusionBuffer::WIDTH, height = OcclusionBuffer::HEIGHT; (width > 0) && (height > 0); width /= 2, height /= 2)
+        level.emplace_back((std::size_t)(width * height), 1.0F);
+
+    occluders = 0U;
+    view_projection = glm::mat4(1.0F);
+    clipping = glm::vec2(0.0F, 1.0F);
+    for (std::size_t i = 0U; i < 2U; i++) {
+        tested[i] = 0U;
+        culled[i] = 0U;
+    }
+    raster_time = 0.0;
+    texture = GL_FALSE;
+}
+
+
+// Rasterize the triangles of a band of rows, the pixels fully covered keep the farthest depth of their nearest triangle
+void OcclusionBuffer::rasterizeBand(const std::int32_t &first, const std::int32_t &last) {
+    std::vector<float> &depth = level[0];
+
+    for (const OcclusionBuffer::triangle_data &tri : triangle) {
+        const std::int32_t min_y = std::max(tri.min_y, first);
+        const std::int32_t max_y = std::min(tri.max_y, last - 1);
+
+        for (std::int32_t y = min_y; y <= max_y; y++) {
+            // Edges and depth at the start of the row
+            const float center_y = (float)y + 0.5F;
+            const float e0 = tri.b[0] * center_y + tri.c[0];
+            const float e1 = tri.b[1] * center_y + tri.c[1];
+            const float e2 = tri.b[2] * center_y + tri.c[2];
+            const float z = tri.z_y * center_y + tri.z_c;
+            float *const row = &depth[(std::size_t)(y * OcclusionBuffer::WIDTH)];
+
+            std::int32_t x = tri.min_x;
+
+#ifdef OCCLUSION_SSE
+            // Four pixels at once
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 step = _mm_set_ps(3.0F, 2.0F, 1.0F, 0.0F);
+            for (; x + 3 <= tri.max_x; x += 4) {
+                const __m128 center_x = _mm_add_ps(_mm_set1_ps((float)x + 0.5F), step);
+                __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.a[0]), center_x), _mm_set1_ps(e0)), zero);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.a[1]), center_x), _mm_set1_ps(e1)), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.a[2]), center_x), _mm_set1_ps(e2)), zero));
+
+                // Keep the nearest depth of the covered pixels
+                const __m128 previous = _mm_loadu_ps(row + x);
+                const __m128 nearest = _mm_min_ps(previous, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.z_x), center_x), _mm_set1_ps(z)));
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+            }
+#endif
+
+            // Remaining pixels
+            for (; x <= tri.max_x; x++) {
+                const float center_x = (float)x + 0.5F;
+                if ((tri.a[0] * center_x + e0 >= 0.0F) && (tri.a[1] * center_x + e1 >= 0.0F) && (tri.a[2] * center_x + e2 >= 0.0F))
+                    row[x] = std::min(row[x], tri.z_x * center_x + z);
+            }
+        }
+    }
+}
+
+// Build the levels of the farthest depth
+void OcclusionBuffer::buildLevels() {
+    std::int32_t width = OcclusionBuffer::WIDTH;
+    for (std::size_t i = 1U; i < level.size(); i++) {
+        const std::vector<float> &source = level[i - 1U];
+        std::vector<float> &target = level[i];
+        const std::int32_t target_width = width / 2;
+        const std::int32_t target_height = (std::int32_t)target.size() / target_width;
+
+        for (std::int32_t y = 0; y < target_height; y++)
+            for (std::int32_t x = 0; x < target_width; x++) {
+                const std::size_t top = (std::size_t)(2 * y * width + 2 * x);
+                const std::size_t bottom = top + (std::size_t)width;
+                target[(std::size_t)(y * target_width + x)] = std::max(std::max(source[top], source[top + 1U]), std::max(source[bottom], source[bottom + 1U]));
+            }
+
+        width = target_width;
+    }
+}
+
+
+// Clear the buffer and the occluders for a new view
+void OcclusionBuffer::begin(const Camera *const camera) {
+    view_projection = camera->getProjectionMatrix() * camera->getViewMatrix();
+    clipping = camera->getClipping();
+
+    std::fill(level[0].begin(), level[0].end(), 1.0F);
+    triangle.clear();
+    occluders = 0U;
+
+    for (std::size_t i = 0U; i < 2U; i++) {
+        tested[i] = 0U;
+        culled[i] = 0U;
+    }
+}
+
+// Set up the triangles of an occluder, returns false if the triangles budget is full
+bool OcclusionBuffer::addOccluder(const std::vector<glm::vec3> &vertex, const std::vector<std::uint32_t> &index, const glm::mat4 &model_mat) {
+    const std::size_t count = index.size() / 3U;
+    if (triangle.size() + count > OcclusionBuffer::MAX_TRIANGLES)
+        return false;
+
+    // Vertices in screen space, the ones behind the near plane are marked with a negative depth
+    const glm::mat4 mvp = view_projection * model_mat;
+    std::vector<glm::vec3> screen(vertex.size());
+    Scheduler::getDefault()->parallelFor(0U, vertex.size(), OcclusionBuffer::SETUP_GRAIN, [&](const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const glm::vec4 clip = mvp * glm::vec4(vertex[i], 1.0F);
+            if (clip.w <= 1.0E-5F) {
+                screen[i] = glm::vec3(0.0F, 0.0F, -1.0F);
+                continue;
+            }
+
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            screen[i] = glm::vec3((ndc.x * 0.5F + 0.5F) * (float)OcclusionBuffer::WIDTH, (ndc.y * 0.5F + 0.5F) * (float)OcclusionBuffer::HEIGHT, ndc.z * 0.5F + 0.5F);
+        }
+    });
+
+    // Edge functions and depth planes
+    std::vector<OcclusionBuffer::triangle_data> setup(count);
+    std::vector<std::uint8_t> valid(count, 0U);
+    Scheduler::getDefault()->parallelFor(0U, count, OcclusionBuffer::SETUP_GRAIN, [&](const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            glm::vec3 p[3] = {screen[index[3U * i]], screen[index[3U * i + 1U]], screen[index[3U * i + 2U]]};
+
+            // The triangles crossing the near plane are not occluders
+            if ((p[0].z < 0.0F) || (p[1].z < 0.0F) || (p[2].z < 0.0F))
+                continue;
+
+            // Counter clockwise order, the degenerated triangles are skipped
+            float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y);
+            if (std::fabs(area) < 1.0E-6F)
+                continue;
+
+            if (area < 0.0F) {
+                std::swap(p[1], p[2]);
+                area = -area;
+            }
+
+            // Pixels inside the screen
+            OcclusionBuffer::triangle_data &tri = setup[i];
+            const glm::vec2 size((float)OcclusionBuffer::WIDTH, (float)OcclusionBuffer::HEIGHT);
+            const glm::vec2 low = glm::clamp(glm::min(glm::min(glm::vec2(p[0]), glm::vec2(p[1])), glm::vec2(p[2])), glm::vec2(0.0F), size);
+            const glm::vec2 high = glm::clamp(glm::max(glm::max(glm::vec2(p[0]), glm::vec2(p[1])), glm::vec2(p[2])), glm::vec2(-1.0F), size - 1.0F);
+            tri.min_x = (std::int32_t)low.x;
+            tri.max_x = (std::int32_t)std::floor(high.x);
+            tri.min_y = (std::int32_t)low.y;
+            tri.max_y = (std::int32_t)std::floor(high.y);
+            if ((tri.min_x > tri.max_x) || (tri.min_y > tri.max_y))
+                continue;
+
+            // Edge functions moved inwards by half a pixel, only the pixels fully inside are covered so the occluders never grow. The shared edges may leave cracks that only reduce the culling
+            for (std::size_t j = 0U; j < 3U; j++) {
+                const glm::vec3 &from = p[j];
+                const glm::vec3 &to = p[(j + 1U) % 3U];
+                tri.a[j] = from.y - to.y;
+                tri.b[j] = to.x - from.x;
+                tri.c[j] = from.x * to.y - from.y * to.x - 0.5F * (std::fabs(tri.a[j]) + std::fabs(tri.b[j]));
+            }
+
+            // Depth plane moved to the farthest corner of each pixel
+            tri.z_x = ((p[1].z - p[0].z) * (p[2].y - p[0].y) - (p[2].z - p[0].z) * (p[1].y - p[0].y)) / area;
+            tri.z_y = ((p[2].z - p[0].z) * (p[1].x - p[0].x) - (p[1].z - p[0].z) * (p[2].x - p[0].x)) / area;
+            tri.z_c = p[0].z - tri.z_x * p[0].x - tri.z_y * p[0].y + 0.5F * (std::fabs(tri.z_x) + std::fabs(tri.z_y));
+            valid[i] = 1U;
+        }
+    });
+
+    for (std::size_t i = 0U; i < count; i++)
+        if (valid[i])
+            triangle.push_back(setup[i]);
+
+    occluders++;
+    return true;
+}
+
+// Rasterize the occluders in bands of rows and build the levels
+void OcclusionBuffer::rasterize() {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    const std::size_t bands = (std::size_t)((OcclusionBuffer::HEIGHT + OcclusionBuffer::BAND - 1) / OcclusionBuffer::BAND);
+    Scheduler::getDefault()->parallelFor(0U, bands, 1U, [this](const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t band = begin; band < end; band++) {
+            const std::int32_t first = (std::int32_t)band * OcclusionBuffer::BAND;
+            rasterizeBand(first, std::min(first + OcclusionBuffer::BAND, OcclusionBuffer::HEIGHT));
+        }
+    });
+
+    buildLevels();
+    raster_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+// Test a box against the farthest depth of the level where it covers at most two by two texels
+bool OcclusionBuffer::isVisible(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &model_mat, const OcclusionBuffer::Test &test) const {
+    tested[test]++;
+
+    // Screen rectangle and nearest depth of the corners, the boxes crossing the near plane are visible
+    const glm::mat4 mvp = view_projection * model_mat;
+    glm::vec3 low(std::numeric_limits<float>::max());
+    glm::vec3 high(std::numeric_limits<float>::lowest());
+    for (std::size_t i = 0U; i < 8U; i++) {
+        const glm::vec4 clip = mvp * glm::vec4((i & 1U) ? max.x : min.x, (i & 2U) ? max.y : min.y, (i & 4U) ? max.z : min.z, 1.0F);
+        if (clip.w <= 1.0E-5F)
+            return true;
+
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        const glm::vec3 screen((ndc.x * 0.5F + 0.5F) * (float)OcclusionBuffer::WIDTH, (ndc.y * 0.5F + 0.5F) * (float)OcclusionBuffer::HEIGHT, ndc.z * 0.5F + 0.5F);
+        low = glm::min(low, screen);
+        high = glm::max(high, screen);
+    }
+
+    // The boxes outside the screen are left to the frustum culling
+    if ((high.x < 0.0F) || (high.y < 0.0F) || (low.x >= (float)OcclusionBuffer::WIDTH) || (low.y >= (float)OcclusionBuffer::HEIGHT))
+        return true;
+
+    std::int32_t min_x = (std::int32_t)std::max(low.x, 0.0F);
+    std::int32_t min_y = (std::int32_t)std::max(low.y, 0.0F);
+    std::int32_t max_x = (std::int32_t)std::min(high.x, (float)(OcclusionBuffer::WIDTH - 1));
+    std::int32_t max_y = (std::int32_t)std::min(high.y, (float)(OcclusionBuffer::HEIGHT - 1));
+
+    // Level where the rectangle covers at most two texels on each side
+    std::size_t index = 0U;
+    while ((index + 1U < level.size()) && ((max_x - min_x > 1) || (max_y - min_y > 1))) {
+        min_x /= 2;
+        min_y /= 2;
+        max_x /= 2;
+        max_y /= 2;
+        index++;
+    }
+
+    // Visible if some texel is farther than the nearest corner
+    const std::int32_t width = OcclusionBuffer::WIDTH >> index;
+    for (std::int32_t y = min_y; y <= max_y; y++)
+        for (std::int32_t x = min_x; x <= max_x; x++)
+            if (level[index][(std::size_t)(y * width + x)] >= low.z)
+                return true;
+
+    culled[test]++;
+    return false;
+}
+
+
+// Upload the depth to the debug texture, the view depth is linearized and the nearest is the brightest
+void OcclusionBuffer::upload() {
+    if (texture == GL_FALSE) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    const float z_near = clipping.x;
+    const float z_far = clipping.y;
+    std::vector<std::uint8_t> pixel(level[0].size() * 4U);
+    for (std::size_t i = 0U; i < level[0].size(); i++) {
+        const float ndc = level[0][i] * 2.0F - 1.0F;
+        const float view_depth = 2.0F * z_near * z_far / (z_far + z_near - ndc * (z_far - z_near));
+        const std::uint8_t value = (std::uint8_t)(255.0F * glm::clamp(1.0F - view_depth / z_far, 0.0F, 1.0F));
+        pixel[4U * i] = value;
+        pixel[4U * i + 1U] = value;
+        pixel[4U * i + 2U] = value;
+        pixel[4U * i + 3U] = 255U;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, OcclusionBuffer::WIDTH, OcclusionBuffer::HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+// Get the number of rasterized occluders
+std::size_t OcclusionBuffer::getOccluders() const {
+    return occluders;
+}
+
+// Get the number of rasterized triangles
+std::size_t OcclusionBuffer::getTriangles() const {
+    return triangle.size();
+}
+
+// Get the number of tested bounds of a kind
+std::size_t OcclusionBuffer::getTested(const OcclusionBuffer::Test &test) const {
+    return tested[test];
+}
+
+// Get the number of culled bounds of a kind
+std::size_t OcclusionBuffer::getCulled(const OcclusionBuffer::Test &test) const {
+    return culled[test];
+}
+
+// Get the last rasterization time in microseconds
+double OcclusionBuffer::getRasterTime() const {
+    return raster_time;
+}
+
+// Get the debug texture
+GLuint OcclusionBuffer::getTexture() const {
+    return texture;
+}
+
+
+// Occlusion buffer destructor
+OcclusionBuffer::~OcclusionBuffer() {
+    if (texture != GL_FALSE)
+        glDeleteTextures(1, &texture);
+}
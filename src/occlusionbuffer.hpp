@@ -0,0 +1,98 @@
+#ifndef __OCCLUSION_BUFFER_HPP_
+#define __OCCLUSION_BUFFER_HPP_
+
+#include "camera.hpp"
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <atomic>
+#include <vector>
+
+class OcclusionBuffer {
+    public:
+        // Kind of tested bounds
+        enum Test : std::uint8_t {
+            MODEL,
+            CLUSTER
+        };
+
+    private:
+        // Occluder triangle in screen space, the edges are moved inwards by half a pixel and the depth is offset to the farthest pixel corner
+        struct triangle_data {
+            float a[3];
+            float b[3];
+            float c[3];
+            float z_x;
+            float z_y;
+            float z_c;
+            std::int32_t min_x;
+            std::int32_t max_x;
+            std::int32_t min_y;
+            std::int32_t max_y;
+        };
+
+        // Disable copy and assignation
+        OcclusionBuffer(const OcclusionBuffer &) = delete;
+        OcclusionBuffer &operator = (const OcclusionBuffer &) = delete;
+
+        // Depth of each level, the first one is the rasterized depth and the others keep the farthest one
+        std::vector<std::vector<float> > level;
+
+        // Occluder triangles
+        std::vector<OcclusionBuffer::triangle_data> triangle;
+        std::size_t occluders;
+
+        // View projection matrix and clipping planes
+        glm::mat4 view_projection;
+        glm::vec2 clipping;
+
+        // Tested and culled bounds of each kind
+        mutable std::atomic<std::size_t> tested[2];
+        mutable std::atomic<std::size_t> culled[2];
+
+        // Last rasterization time in microseconds
+        double raster_time;
+
+        // Debug texture
+        GLuint texture;
+
+        // Rasterize the triangles of a band of rows
+        void rasterizeBand(const std::int32_t &first, const std::int32_t &last);
+
+        // Build the levels of the farthest depth
+        void buildLevels();
+
+        // Static const attributes
+        static constexpr const std::int32_t BAND = 8;
+        static constexpr const std::size_t SETUP_GRAIN = 1024U;
+
+    public:
+        // Resolution, occluders and triangles budgets
+        static constexpr const std::int32_t WIDTH = 256;
+        static constexpr const std::int32_t HEIGHT = 128;
+        static constexpr const std::size_t MAX_OCCLUDERS = 16U;
+        static constexpr const std::size_t MAX_TRIANGLES = 65536U;
+
+        OcclusionBuffer();
+
+        void begin(const Camera *const camera);
+        bool addOccluder(const std::vector<glm::vec3> &vertex, const std::vector<std::uint32_t> &index, const glm::mat4 &model_mat);
+        void rasterize();
+
+        bool isVisible(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &model_mat, const OcclusionBuffer::Test &test) const;
+
+        void upload();
+
+        std::size_t getOccluders() const;
+        std::size_t getTriangles() const;
+        std::size_t getTested(const OcclusionBuffer::Test &test) const;
+        std::size_t getCulled(const OcclusionBuffer::Test &test) const;
+        double getRasterTime() const;
+        GLuint getTexture() const;
+
+        ~OcclusionBuffer();
+};
+
+#endif // __OCCLUSION_BUFFER_HPP_
@@ -0,0 +1,196 @@
+#include "programcache.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Static definitions
+std::string ProgramCache::directory;
+std::string ProgramCache::driver;
+bool ProgramCache::enabled = false;
+std::mutex ProgramCache::mutex;
+std::size_t ProgramCache::hits = 0U;
+std::size_t ProgramCache::misses = 0U;
+std::size_t ProgramCache::stores = 0U;
+
+// Static const definitions
+constexpr const char *const ProgramCache::MAGIC;
+constexpr const char *const ProgramCache::PREFIX;
+constexpr const char *const ProgramCache::EXTENSION;
+
+
+// FNV-1a hash continuing from a previous hash
+std::uint64_t ProgramCache::hash(const std::string &data, std::uint64_t seed) {
+    for (const char &byte : data) {
+        seed ^= (std::uint64_t)(unsigned char)byte;
+        seed *= 0x100000001B3ULL;
+    }
+
+    return seed;
+}
+
+// Path of the binary of a key
+std::string ProgramCache::getPath(const std::string &key) {
+    return ProgramCache::directory + ProgramCache::PREFIX + key + ProgramCache::EXTENSION;
+}
+
+
+// Enable the cache if the driver can retrieve program binaries, the driver strings are part of every key
+bool ProgramCache::init(const std::string &cache_directory) {
+    ProgramCache::directory = cache_directory;
+
+    // Driver identification
+    ProgramCache::driver.clear();
+    for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const GLubyte *const value = glGetString(name);
+        ProgramCache::driver.append(value != nullptr ? (const char *)value : "").append("\n");
+    }
+
+    // Check the binary formats
+    GLint formats = 0;
+    if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+    ProgramCache::enabled = (formats > 0);
+    if (!ProgramCache::enabled)
+        std::cerr << "warning: the driver does not support program binaries, the programs will be compiled on every start" << std::endl;
+
+    return ProgramCache::enabled;
+}
+
+
+// Get the key of the program sources for the current driver
+std::string ProgramCache::getKey(const std::string &sources) {
+    const std::uint64_t value = ProgramCache::hash(sources, ProgramCache::hash(ProgramCache::driver, 0xCBF29CE484222325ULL));
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", (unsigned long long)value);
+    return key;
+}
+
+// Create a program from the stored binary, returns GL_FALSE on a miss or if the driver rejects the binary
+GLuint ProgramCache::load(const std::string &key) {
+    if (!ProgramCache::enabled)
+        return GL_FALSE;
+
+    // Read the format and binary
+    GLenum format = GL_NONE;
+    std::vector<char> binary;
+    {
+        std::lock_guard<std::mutex> lock(ProgramCache::mutex);
+        std::ifstream file(ProgramCache::getPath(key), std::ios::binary);
+        char magic[8];
+        std::uint64_t length = 0U;
+
+        if (!file.is_open() || !file.read(magic, sizeof(magic)) || (std::strncmp(magic, ProgramCache::MAGIC, sizeof(magic)) != 0) ||
+            !file.read((char *)&format, sizeof(format)) || !file.read((char *)&length, sizeof(length))) {
+            ProgramCache::misses++;
+            return GL_FALSE;
+        }
+
+        // The length must fit in the rest of the file
+        const std::streampos position = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::uint64_t remaining = (std::uint64_t)(file.tellg() - position);
+        file.seekg(position);
+        if ((length == 0U) || (length > remaining)) {
+            ProgramCache::misses++;
+            return GL_FALSE;
+        }
+
+        binary.resize((std::size_t)length);
+        if (!file.read(binary.data(), binary.size())) {
+            ProgramCache::misses++;
+            return GL_FALSE;
+        }
+    }
+
+    // Create the program and check the link status, the binary is invalid after driver updates
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+
+    GLint status;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE) {
+        glDeleteProgram(program);
+        program = GL_FALSE;
+    }
+
+    std::lock_guard<std::mutex> lock(ProgramCache::mutex);
+    (program != GL_FALSE ? ProgramCache::hits : ProgramCache::misses)++;
+    return program;
+}
+
+// Store the binary of a linked program
+void ProgramCache::store(const std::string &key, const GLuint &program) {
+    if (!ProgramCache::enabled || (program == GL_FALSE))
+        return;
+
+    // Get the program binary
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    GLenum format = GL_NONE;
+    std::vector<char> binary((std::size_t)length);
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    // Write it to a temporary file unique to this process and move it in place, a crash or another instance never leaves a truncated binary
+    std::lock_guard<std::mutex> lock(ProgramCache::mutex);
+    const std::string path = ProgramCache::getPath(key);
+    char suffix[17];
+    std::snprintf(suffix, sizeof(suffix), "%016llx", (unsigned long long)std::random_device()());
+    const std::string temp_path = path + "." + suffix + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary);
+        const std::uint64_t size = (std::uint64_t)length;
+        file.write(ProgramCache::MAGIC, std::strlen(ProgramCache::MAGIC));
+        file.write((const char *)&format, sizeof(format));
+        file.write((const char *)&size, sizeof(size));
+        file.write(binary.data(), length);
+        file.close();
+
+        if (!file) {
+            std::cerr << "warning: could not write the program binary `" << temp_path << "`" << std::endl;
+            std::remove(temp_path.c_str());
+            return;
+        }
+    }
+
+    // The rename does not replace an existing file in every platform
+    if ((std::rename(temp_path.c_str(), path.c_str()) != 0) && ((std::remove(path.c_str()) != 0) || (std::rename(temp_path.c_str(), path.c_str()) != 0))) {
+        std::cerr << "warning: could not move the program binary to `" << path << "`" << std::endl;
+        std::remove(temp_path.c_str());
+        return;
+    }
+
+    ProgramCache::stores++;
+}
+
+
+// Get the enabled status
+bool ProgramCache::isEnabled() {
+    return ProgramCache::enabled;
+}
+
+// Get the number of programs loaded from binaries
+std::size_t ProgramCache::getHits() {
+    std::lock_guard<std::mutex> lock(ProgramCache::mutex);
+    return ProgramCache::hits;
+}
+
+// Get the number of programs that had to be compiled
+std::size_t ProgramCache::getMisses() {
+    std::lock_guard<std::mutex> lock(ProgramCache::mutex);
+    return ProgramCache::misses;
+}
+
+// Get the number of written binaries
+std::size_t ProgramCache::getStores() {
+    std::lock_guard<std::mutex> lock(ProgramCache::mutex);
+    return ProgramCache::stores;
+}
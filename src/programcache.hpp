@@ -0,0 +1,50 @@
+#ifndef __PROGRAM_CACHE_HPP_
+#define __PROGRAM_CACHE_HPP_
+
+#include "glad/glad.h"
+
+#include <cstdint>
+#include <string>
+#include <mutex>
+
+class ProgramCache {
+    private:
+        // Disable constructor, copy and assignation
+        ProgramCache() = delete;
+        ProgramCache(const ProgramCache &) = delete;
+        ProgramCache &operator = (const ProgramCache &) = delete;
+
+        // Hash bytes continuing from a previous hash
+        static std::uint64_t hash(const std::string &data, std::uint64_t seed);
+
+        // Path of the binary of a key
+        static std::string getPath(const std::string &key);
+
+        // Static attributes
+        static std::string directory;
+        static std::string driver;
+        static bool enabled;
+        static std::mutex mutex;
+        static std::size_t hits;
+        static std::size_t misses;
+        static std::size_t stores;
+
+        // Static const attributes
+        static constexpr const char *const MAGIC = "OBJVPRG1";
+        static constexpr const char *const PREFIX = "program_";
+        static constexpr const char *const EXTENSION = ".bin";
+
+    public:
+        static bool init(const std::string &cache_directory);
+
+        static std::string getKey(const std::string &sources);
+        static GLuint load(const std::string &key);
+        static void store(const std::string &key, const GLuint &program);
+
+        static bool isEnabled();
+        static std::size_t getHits();
+        static std::size_t getMisses();
+        static std::size_t getStores();
+};
+
+#endif // __PROGRAM_CACHE_HPP_
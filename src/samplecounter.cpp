@@ -0,0 +1,66 @@
+#include "samplecounter.hpp"
+
+// Static const definitions
+constexpr const std::size_t SampleCounter::FRAMES;
+
+
+// Sample counter constructor
+SampleCounter::SampleCounter(const std::size_t &count) {
+    counters = count;
+    frame = 0U;
+
+    // The results are read some frames later to not stall the pipeline
+    query.resize(SampleCounter::FRAMES * counters);
+    issued.assign(SampleCounter::FRAMES * counters, false);
+    samples.assign(counters, 0U);
+    glGenQueries((GLsizei)query.size(), query.data());
+}
+
+
+// Start counting the samples of a counter
+void SampleCounter::begin(const std::size_t &index) {
+    const std::size_t slot = frame * counters + index;
+    glBeginQuery(GL_SAMPLES_PASSED, query[slot]);
+    issued[slot] = true;
+}
+
+// Stop counting
+void SampleCounter::end() {
+    glEndQuery(GL_SAMPLES_PASSED);
+}
+
+// Start the next frame and read the counters of the oldest one that are available
+void SampleCounter::next() {
+    frame = (frame + 1U) % SampleCounter::FRAMES;
+    const std::size_t first = frame * counters;
+
+    for (std::size_t i = 0U; i < counters; i++) {
+        // The counters not used in the frame are zero
+        if (!issued[first + i]) {
+            samples[i] = 0U;
+            continue;
+        }
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query[first + i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_TRUE) {
+            GLuint64 result;
+            glGetQueryObjectui64v(query[first + i], GL_QUERY_RESULT, &result);
+            samples[i] = (std::uint64_t)result;
+        }
+
+        issued[first + i] = false;
+    }
+}
+
+
+// Get the samples of a counter
+std::uint64_t SampleCounter::getSamples(const std::size_t &index) const {
+    return samples[index];
+}
+
+
+// Sample counter destructor
+SampleCounter::~SampleCounter() {
+    glDeleteQueries((GLsizei)query.size(), query.data());
+}
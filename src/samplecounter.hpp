@@ -0,0 +1,41 @@
+#ifndef __SAMPLE_COUNTER_HPP_
+#define __SAMPLE_COUNTER_HPP_
+
+#include "glad/glad.h"
+
+#include <cstdint>
+#include <vector>
+
+class SampleCounter {
+    private:
+        // Occlusion queries of each frame in flight and their issued status
+        std::vector<GLuint> query;
+        std::vector<bool> issued;
+
+        // Counters per frame and current frame
+        std::size_t counters;
+        std::size_t frame;
+
+        // Samples that passed the depth test in the last finished frame
+        std::vector<std::uint64_t> samples;
+
+        // Disable copy and assignation
+        SampleCounter(const SampleCounter &) = delete;
+        SampleCounter &operator = (const SampleCounter &) = delete;
+
+        // Static const attributes
+        static constexpr const std::size_t FRAMES = 3U;
+
+    public:
+        SampleCounter(const std::size_t &count);
+
+        void begin(const std::size_t &index);
+        void end();
+        void next();
+
+        std::uint64_t getSamples(const std::size_t &index) const;
+
+        ~SampleCounter();
+};
+
+#endif // __SAMPLE_COUNTER_HPP_
@@ -1,4 +1,10 @@
 #include "scene.hpp"
+#include "scenefile.hpp"
+
+#include "../loader.hpp"
+#include "../scheduler.hpp"
+#include "../programcache.hpp"
+#include "../shaderpreprocessor.hpp"
 
 #include "../glad/glad.h"
 
@@ -6,6 +12,9 @@
 #include "../imgui/imgui_impl_glfw.h"
 #include "../imgui/imgui_impl_opengl3.h"
 
+#include <unordered_set>
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 
 
@@ -16,12 +25,19 @@ char Scene::URL[] = "https://github.com/Rebaya17/objviewer/";
 // Static const definitions
 const std::string Scene::CAMERA_ID_TAG   = "###camera";
 const std::string Scene::MODEL_ID_TAG    = "###model";
+const std::string Scene::STREAM_ID_TAG   = "###stream";
 const std::string Scene::MATERIAL_ID_TAG = "###material";
 const std::string Scene::TEXTURE_ID_TAG  = "###texture";
 const std::string Scene::LIGHT_ID_TAG    = "###light";
 const std::string Scene::PROGRAM_ID_TAG  = "###program";
+const std::string Scene::NODE_ID_TAG     = "###node";
 
 constexpr const std::size_t Scene::LIGHTS;
+constexpr const double Scene::WATCH_INTERVAL;
+constexpr const std::size_t Scene::REDRAW_FRAMES;
+constexpr const std::size_t Scene::LIST_ROWS;
+constexpr const std::size_t Scene::VIEWS;
+constexpr const std::size_t Scene::NO_SELECTION;
 constexpr const ImGuiWindowFlags Scene::GUI_FLAGS;
 
 
@@ -113,54 +129,221 @@ void Scene::drawSettingsWindow() {
             ImGui::Text("Height: %d", height);
             if (ImGui::ColorEdit3("Background", &background.r))
                 glClearColor(background.r, background.g, background.b, 1.0F);
+            if (ImGui::Checkbox("Draw on demand", &on_demand))
+                requestRedraw();
+            Scene::HelpMarker("Draw only after an input, a camera\nchange or while the assets load");
+            bool split = split_screen;
+            if (ImGui::Checkbox("Split screen", &split))
+                setSplitScreen(split);
+            Scene::HelpMarker("Draw up to four cameras side by side,\nthe selected one at the top left");
 
             ImGui::TreePop();
             ImGui::Separator();
         }
 
-        // Scene statistics
-        if (ImGui::TreeNode("Statistics*")) {
-            // Calculate models statistics
-            std::size_t polygons = 0U;
-            std::size_t vertices = 0U;
-            std::size_t elements = 0U;
-            std::size_t materials = 0U;
-            std::size_t textures  = 0U;
-            for (SceneModel *const &model : model_stock) {
-                polygons += model->Model::getPolygons();
-                vertices += model->Model::getVertices();
-                elements += model->Model::getElements();
-                materials += model->Model::getMaterials();
-                textures  += model->Model::getTextures();
+        // Frame pacing
+        if (ImGui::TreeNode("Frame pacing")) {
+            float target_fps = (float)pacer->getTargetFPS();
+            if (ImGui::InputFloat("Target FPS", &target_fps, 10.0F, 30.0F, "%.0f"))
+                pacer->setTargetFPS(target_fps);
+            Scene::HelpMarker("Zero draws without limit, the\nlimiter sleeps and spins the rest");
+
+            int vsync = pacer->getVSync();
+            ImGui::TextUnformatted("VSync:");
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Off", &vsync, FramePacer::OFF))
+                pacer->setVSync(FramePacer::OFF);
+            ImGui::SameLine();
+            if (ImGui::RadioButton("On", &vsync, FramePacer::ON))
+                pacer->setVSync(FramePacer::ON);
+            ImGui::SameLine();
+            if (!FramePacer::isAdaptiveSupported()) {
+                ImGui::TextDisabled("Adaptive");
+                Scene::HelpMarker("Needs the swap control\ntear extension");
+            }
+            else if (ImGui::RadioButton("Adaptive", &vsync, FramePacer::ADAPTIVE))
+                pacer->setVSync(FramePacer::ADAPTIVE);
+
+            const std::vector<float> &history = pacer->getHistory();
+            ImGui::PlotLines("##frame_times", history.data(), (int)pacer->getHistoryCount(), (int)pacer->getHistoryOffset(), "Frame time (ms)", 0.0F, 2.0F * pacer->getAverageFrameTime(), ImVec2(223.0F, 60.0F));
+            ImGui::Text("Frame: %.2f ms", pacer->getFrameTime());
+            ImGui::SameLine(140.0F);
+            ImGui::Text("Average: %.2f ms", pacer->getAverageFrameTime());
+            ImGui::Text("Jitter: %.2f ms", pacer->getJitter());
+            ImGui::SameLine(140.0F);
+            ImGui::Text("Camera steps: %u", (unsigned int)pacer->getSteps());
+            ImGui::Text("Min: %.2f ms", pacer->getMinFrameTime());
+            ImGui::SameLine(140.0F);
+            ImGui::Text("Max: %.2f ms", pacer->getMaxFrameTime());
+
+            ImGui::TreePop();
+            ImGui::Separator();
+        }
+
+        // Hot reload
+        if (ImGui::TreeNode("Hot reload")) {
+            bool watching = watcher->isEnabled();
+            if (ImGui::Checkbox("Watch files", &watching))
+                watcher->setEnabled(watching);
+            Scene::HelpMarker("Reload the shaders, models, materials\nand textures when their files change");
+            ImGui::Text("Watched files: %u", (unsigned int)watcher->getPaths());
+            ImGui::SameLine(210.0F);
+            ImGui::TextUnformatted(watcher->isNative() ? "Notifications" : "Polling");
+            ImGui::TreePop();
+            ImGui::Separator();
+        }
+
+        // Renderer
+        if (ImGui::TreeNode("Renderer")) {
+            int deferred = (gbuffer != nullptr ? 1 : 0);
+            if (ImGui::RadioButton("Forward", &deferred, 0))
+                setDeferred(false);
+            ImGui::SameLine();
+            if (!deferred_support) {
+                ImGui::TextDisabled("Deferred");
+                Scene::HelpMarker("Needs a 24 bits depth and\n8 bits stencil framebuffer");
+            }
+            else if (ImGui::RadioButton("Deferred", &deferred, 1))
+                setDeferred(true);
+            if (gbuffer != nullptr)
+                Scene::HelpMarker("The programs without G-buffer\ncode paths are drawn forward");
+
+            // Memory and passes timings
+            ImGui::Text("G-buffer: %.2f MiB", gbuffer != nullptr ? (double)gbuffer->getMemory() / 1048576.0 : 0.0);
+            ImGui::Text("Geometry: %.2f ms", timer->getElapsed(1U));
+            ImGui::SameLine(210.0F);
+            ImGui::Text("Lighting: %.2f ms", timer->getElapsed(2U));
+            ImGui::Text("Forward: %.2f ms", timer->getElapsed(3U)); Scene::HelpMarker("Forward models, streamed\nmodels and lights");
+
+            // Overdraw of the forward models
+            ImGui::Checkbox("Depth pre-pass", &depth_prepass);
+            ImGui::SameLine(210.0F);
+            ImGui::Checkbox("Front to back", &front_to_back);
+            const std::uint64_t shaded = counter->getSamples(1U);
+            const std::uint64_t tested = counter->getSamples(0U);
+            ImGui::Text("Shaded samples: %llu", (unsigned long long)shaded); Scene::HelpMarker("Samples of the forward models\ncovered by the pre-pass that\npassed the depth test");
+            if (depth_prepass && (tested > 0U)) {
+                const std::uint64_t saved = (tested > shaded ? tested - shaded : 0U);
+                ImGui::Text("Saved: %llu (%.1f%%)", (unsigned long long)saved, 100.0 * (double)saved / (double)tested); Scene::HelpMarker("Samples that would have been shaded\nwithout the pre-pass, counted in it");
+            }
+
+            // Transparent materials
+            bool blended = (transparency != nullptr);
+            if (!transparency_support) {
+                ImGui::TextDisabled("Blended transparency");
+                Scene::HelpMarker("Needs a 24 bits depth and\n8 bits stencil framebuffer");
             }
+            else {
+                if (ImGui::Checkbox("Blended transparency", &blended))
+                    setTransparency(blended);
+                Scene::HelpMarker("Blend the materials with alpha maps or\npartial alpha after the opaque ones, in\nany order, else they are alpha tested");
+            }
+            if (transparency != nullptr)
+                ImGui::Text("Transparency: %.2f MiB", (double)transparency->getMemory() / 1048576.0);
+            ImGui::TreePop();
+            ImGui::Separator();
+        }
 
-            // Calculate GLSL programs statistics
-            unsigned int shaders = 0;
-            unsigned int default_shaders = SceneProgram::getDefault()->getShaders() + SceneLight::getProgram()->getShaders();
-            for (SceneProgram *const program : program_stock)
-                shaders += program->getShaders();
+        // Shadows
+        if (ImGui::TreeNode("Shadows")) {
+            bool status = (shadow_maps != nullptr);
+            if (!shadow_support) {
+                ImGui::TextDisabled("Shadow mapping");
+                Scene::HelpMarker("Needs 19 texture units");
+            }
+            else if (ImGui::Checkbox("Shadow mapping", &status))
+                setShadowMapping(status);
+
+            if (shadow_maps != nullptr) {
+                Scene::HelpMarker("Only the maps of the changed lights\nand of the lights reached by the\nchanged models are rendered again");
+                ImGui::Text("Atlas tiles: %u / %u", (unsigned int)shadow_maps->getUsedTiles(), (unsigned int)shadow_maps->getTiles());
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Cascades: %u", (unsigned int)shadow_maps->getUsedCascades()); Scene::HelpMarker("Directional lights with cascades");
+                ImGui::Text("Rendered: %u", (unsigned int)shadow_maps->getRenderedTiles()); Scene::HelpMarker("Tiles and cascades rendered\nin the last frame");
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Time: %.2f ms", timer->getElapsed(0U));
+                ImGui::Text("Memory: %.2f MiB", (double)shadow_maps->getMemory() / 1048576.0);
+            }
+            ImGui::TreePop();
+            ImGui::Separator();
+        }
+
+        // Occlusion culling
+        if (ImGui::TreeNode("Occlusion culling")) {
+            ImGui::Checkbox("Enabled", &occlusion_culling);
+            Scene::HelpMarker("Rasterize the largest models in the CPU\nand skip the models and clusters\nhidden behind them");
+            ImGui::SameLine(210.0F);
+            ImGui::Checkbox("Show depth", &show_occlusion);
+
+            if (occlusion_culling) {
+                const std::size_t models = occlusion->getTested(OcclusionBuffer::MODEL);
+                const std::size_t clusters = occlusion->getTested(OcclusionBuffer::CLUSTER);
+                ImGui::Text("Occluders: %u", (unsigned int)occlusion->getOccluders());
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Triangles: %u", (unsigned int)occlusion->getTriangles());
+                ImGui::Text("Models culled: %u / %u (%.1f%%)", (unsigned int)occlusion->getCulled(OcclusionBuffer::MODEL), (unsigned int)models, models > 0U ? 100.0 * (double)occlusion->getCulled(OcclusionBuffer::MODEL) / (double)models : 0.0);
+                ImGui::Text("Clusters culled: %u / %u (%.1f%%)", (unsigned int)occlusion->getCulled(OcclusionBuffer::CLUSTER), (unsigned int)clusters, clusters > 0U ? 100.0 * (double)occlusion->getCulled(OcclusionBuffer::CLUSTER) / (double)clusters : 0.0);
+                ImGui::Text("Rasterization: %.1f us", occlusion->getRasterTime());
+
+                // Debug view of the occluders depth
+                if (show_occlusion) {
+                    occlusion->upload();
+                    ImGui::Image((void *)(intptr_t)occlusion->getTexture(), ImVec2(2.0F * OcclusionBuffer::WIDTH, 2.0F * OcclusionBuffer::HEIGHT), ImVec2(0.0F, 1.0F), ImVec2(1.0F, 0.0F));
+                }
+            }
+            ImGui::TreePop();
+            ImGui::Separator();
+        }
+
+        // Scene statistics
+        if (ImGui::TreeNode("Statistics*")) {
+            // The models and programs totals are kept up to date as they change
+            const unsigned int default_shaders = SceneProgram::getDefault()->getShaders() + SceneLight::getProgram()->getShaders();
 
             // Cameras
-            ImGui::BulletText("Cameras: %u", camera_stock.size());
+            ImGui::BulletText("Cameras: %u", (unsigned int)camera_stock.size());
 
             // Models
-            if (ImGui::TreeNodeEx("modelsstats", ImGuiTreeNodeFlags_DefaultOpen, "Models: %u", model_stock.size())) {
-                ImGui::Text("Polygons: %u", polygons);
+            if (ImGui::TreeNodeEx("modelsstats", ImGuiTreeNodeFlags_DefaultOpen, "Models: %u", (unsigned int)model_stock.size())) {
+                ImGui::Text("Polygons: %u", (unsigned int)model_totals.polygons);
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Materials: %u", (unsigned int)model_totals.materials);
+                ImGui::Text("Vertices: %u", (unsigned int)model_totals.vertices); Scene::HelpMarker("Unique vertices");
                 ImGui::SameLine(210.0F);
-                ImGui::Text("Materials: %u", materials);
-                ImGui::Text("Vertices: %u", vertices); Scene::HelpMarker("Unique vertices");
+                ImGui::Text("Textures: %u", (unsigned int)model_totals.textures);
+                ImGui::Text("Elements: %u", (unsigned int)model_totals.elements); Scene::HelpMarker("Total of vertices");
                 ImGui::SameLine(210.0F);
-                ImGui::Text("Textures: %u", textures);
-                ImGui::Text("Elements: %u", elements); Scene::HelpMarker("Total of vertices");
+                ImGui::Text("Clusters: %u", (unsigned int)model_totals.clusters);
+                ImGui::Text("Submitted: %u", (unsigned int)submitted_polygons); Scene::HelpMarker("Polygons of the visible clusters\nin the last frame");
+                ImGui::Text("Buffers: %.2f MB", (double)model_totals.memory / 1048576.0); Scene::HelpMarker("GPU memory of the vertex\nand element buffers");
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Textures: %.2f MB", (double)Texture::getTotalMemory() / 1048576.0); Scene::HelpMarker("GPU memory of all the loaded\ntextures and their mipmaps");
                 ImGui::TreePop();
             }
 
             // Lights
-            ImGui::BulletText("Lights: %u", light_stock.size());
+            if (ImGui::TreeNodeEx("lightsstats", ImGuiTreeNodeFlags_DefaultOpen, "Lights: %u", (unsigned int)light_stock.size())) {
+                ImGui::Text("Clustered: %u", (unsigned int)light_grid->getClusteredLights()); Scene::HelpMarker("Point and spot lights inside\nthe view in the last frame");
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Indices: %u", (unsigned int)light_grid->getIndices());
+                ImGui::Text("Max per cluster: %u", (unsigned int)light_grid->getMaxClusterLights());
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Assign: %.1f us", light_grid->getAssignTime());
+                ImGui::TreePop();
+            }
 
             // GLSL programs
-            if (ImGui::TreeNodeEx("programsstats", ImGuiTreeNodeFlags_DefaultOpen, "GLSL programs: %u + 2", program_stock.size())) {
+            if (ImGui::TreeNodeEx("programsstats", ImGuiTreeNodeFlags_DefaultOpen, "GLSL programs: %u + 2", (unsigned int)program_stock.size())) {
                 ImGui::Text("Shaders: %u + %u", shaders, default_shaders); Scene::HelpMarker("Loaded + Defaults");
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Sources: %u", (unsigned int)ShaderPreprocessor::getCached()); Scene::HelpMarker("Cached shader and include files");
+                if (ProgramCache::isEnabled()) {
+                    ImGui::Text("Binary cache hits: %u", (unsigned int)ProgramCache::getHits());
+                    ImGui::SameLine(210.0F);
+                    ImGui::Text("Misses: %u", (unsigned int)ProgramCache::getMisses()); Scene::HelpMarker("Programs compiled because their\nbinary was missing or rejected");
+                }
+                else
+                    ImGui::TextDisabled("Binary cache not supported");
                 ImGui::TreePop();
             }
 
@@ -173,6 +356,86 @@ void Scene::drawSettingsWindow() {
         }
     }
 
+    // Session file
+    if (ImGui::CollapsingHeader("Session")) {
+        ImGui::InputText("File", &session_path);
+        ImGui::Checkbox("JSON mirror", &session_json);
+        Scene::HelpMarker("Also writes a readable copy with\nthe .json extension appended");
+
+        // Save and load buttons
+        if (ImGui::Button("Save", ImVec2(223.0F, 19.0F)) && !session_path.empty())
+            SceneFile::save(this, session_path, session_json);
+        ImGui::SameLine();
+        if (ImGui::Button("Load", ImVec2(223.0F, 19.0F)) && !session_path.empty())
+            SceneFile::load(this, session_path);
+        ImGui::Spacing();
+    }
+
+    // Scene graph
+    if (ImGui::CollapsingHeader("Scene graph")) {
+        ImGui::BulletText("Nodes: %u", (unsigned int)graph->getNodes());
+        ImGui::SameLine(210.0F);
+        ImGui::BulletText("Updated: %u", (unsigned int)graph->getUpdatedNodes());
+        Scene::HelpMarker("Nodes whose world matrix changed\nin the last update");
+        ImGui::Spacing();
+
+        // Hierarchy changes, applied after drawing because the nodes move in the array
+        SceneGraph::Node remove = SceneGraph::NONE;
+        SceneGraph::Node add_child = SceneGraph::NONE;
+        SceneGraph::Node reparent = SceneGraph::NONE;
+        SceneGraph::Node new_parent = SceneGraph::NONE;
+
+        // Draw the nodes in depth first order, the closed ones skip their subtree
+        std::vector<std::size_t> open_end;
+        for (std::size_t i = 0U; i < graph->getNodes();) {
+            // Close the finished subtrees
+            while (!open_end.empty() && (i >= open_end.back())) {
+                ImGui::TreePop();
+                open_end.pop_back();
+            }
+
+            const SceneGraph::Node id = graph->getID(i);
+            const std::string title = graph->getLabel(id) + Scene::NODE_ID_TAG + std::to_string(id);
+            if (!ImGui::TreeNode(title.c_str())) {
+                i += graph->getSubtree(i);
+                continue;
+            }
+
+            // Node widgets
+            SceneGraph::Node parent = graph->getParent(id);
+            bool child = false;
+            if (!Scene::drawNodeGUI(id, parent, child))
+                remove = id;
+            if (child)
+                add_child = id;
+            if (parent != graph->getParent(id)) {
+                reparent = id;
+                new_parent = parent;
+            }
+
+            open_end.push_back(i + graph->getSubtree(i));
+            i++;
+        }
+
+        while (!open_end.empty()) {
+            ImGui::TreePop();
+            open_end.pop_back();
+        }
+
+        // Apply the changes
+        if (reparent != SceneGraph::NONE)
+            graph->setParent(reparent, new_parent);
+        if (add_child != SceneGraph::NONE)
+            graph->push("Node", add_child);
+        graph->pop(remove);
+
+        // Add button
+        ImGui::Spacing();
+        if (ImGui::Button("Add node", ImVec2(454.0F, 19.0F)))
+            graph->push("Node");
+        ImGui::Spacing();
+    }
+
     // Cameras
     if (ImGui::CollapsingHeader("Cameras")) {
         // Selected camera
@@ -182,25 +445,21 @@ void Scene::drawSettingsWindow() {
         ImGui::Unindent();
         ImGui::Spacing();
 
-        // Camera indices
-        std::size_t index = -1;
-        std::size_t remove = -1;
+        // Camera to remove
+        Scene::CameraHandle remove;
 
         // Draw camera node
-        for (SceneCamera *&scene_cam : camera_stock) {
-            const std::string title = scene_cam->getLabel() + Scene::CAMERA_ID_TAG + std::to_string(scene_cam->getGUIID());
-            index++;
-
-            if (ImGui::TreeNode(title.c_str())) {
+        for (std::size_t i = 0U; i < camera_stock.size(); i++) {
+            SceneCamera *const scene_cam = camera_stock[i];
+            if (ImGui::TreeNode(getTitle(scene_cam, scene_cam->getLabel(), Scene::CAMERA_ID_TAG, scene_cam->getGUIID()))) {
                 if (!Scene::drawCameraGUI(scene_cam))
-                    remove = index;
+                    remove = camera_stock.getHandle(i);
                 ImGui::TreePop();
             }
         }
 
         // Remove camera
-        if (remove != -1)
-            popCamera(remove);
+        popCamera(remove);
 
         // Add button
         ImGui::Spacing();
@@ -211,30 +470,89 @@ void Scene::drawSettingsWindow() {
 
     // Models
     if (ImGui::CollapsingHeader("Models")) {
-        // Model indices
-        std::size_t index = -1;
-        std::size_t remove = -1;
-
-        // Draw model node
-        for (SceneModel *&model : model_stock) {
-            const std::string title = model->getLabel() + Scene::MODEL_ID_TAG + std::to_string(model->getGUIID());
-            index++;
-
-            if (ImGui::TreeNode(title.c_str())) {
-                if (!Scene::drawModelGUI(model))
-                    remove = index;
+        // Filtered list of the models, only its visible rows are drawn
+        std::size_t selected = (model_stock.contains(selected_model) ? model_stock.getPosition(selected_model) : Scene::NO_SELECTION);
+        const bool changed = Scene::drawListGUI("models", model_list, model_stock.size(), [this](const std::size_t &i) -> const std::string & {
+            return model_stock[i]->getLabel();
+        }, selected);
+
+        // A newly selected model starts without a selected material
+        if (changed) {
+            selected_model = model_stock.getHandle(selected);
+            selected_material = Scene::NO_SELECTION;
+            material_list.dirty = true;
+        }
+
+        // Widgets of the selected model
+        SceneModel *const *const model = model_stock.find(selected_model);
+        if (model != nullptr) {
+            ImGui::Spacing();
+            ImGui::PushID((int)(*model)->getGUIID());
+            const bool keep = Scene::drawModelGUI(*model);
+            ImGui::PopID();
+
+            // Remove model
+            if (!keep)
+                popModel(selected_model);
+        }
+
+        // Add button, the new model is selected
+        ImGui::Spacing();
+        if (ImGui::Button("Add model", ImVec2(454.0F, 19.0F)))
+            selected_model = pushModel();
+        ImGui::Spacing();
+    }
+
+    // Streamed models
+    if (ImGui::CollapsingHeader("Streamed models")) {
+        // Convert an OBJ file to a chunks file
+        ImGui::InputText("OBJ", &convert_path);
+        ImGui::SameLine();
+        if (converter.joinable())
+            ImGui::TextDisabled("Converting");
+        else if (ImGui::Button("Convert") && !convert_path.empty()) {
+            // Convert in its own thread so the loader keeps uploading, the chunks path is filled when it succeeds
+            const std::string obj_path = convert_path;
+            convert_output = convert_path + ".chunks";
+            convert_error.clear();
+            convert_cancel = false;
+            convert_done = false;
+            converter = std::thread([this, obj_path]() {
+                try {
+                    StreamModel::convert(obj_path, convert_output, &convert_cancel);
+                } catch (std::exception &exception) {
+                    convert_error = exception.what();
+                }
+
+                // Notify the render thread
+                convert_done = true;
+            });
+        }
+        Scene::HelpMarker("Writes the chunks file next to the OBJ file");
+
+        // Streamed model to remove
+        Scene::StreamModelHandle remove;
+
+        // Draw streamed model node, the slot of the handle identifies the node
+        for (std::size_t i = 0U; i < stream_stock.size(); i++) {
+            StreamModel *const model = stream_stock[i];
+            const Scene::StreamModelHandle handle = stream_stock.getHandle(i);
+            if (ImGui::TreeNode(getTitle(model, model->getName(), Scene::STREAM_ID_TAG, handle.index))) {
+                if (!Scene::drawStreamModelGUI(model))
+                    remove = handle;
                 ImGui::TreePop();
             }
         }
 
-        // Remove camera
-        if (remove != -1)
-            popModel(remove);
+        // Remove streamed model
+        popStreamModel(remove);
 
         // Add button
         ImGui::Spacing();
-        if (ImGui::Button("Add model", ImVec2(454.0F, 19.0F)))
-            pushModel();
+        ImGui::InputText("Chunks", &stream_path);
+        ImGui::SameLine();
+        if (ImGui::Button("Add") && !stream_path.empty())
+            pushStreamModel(stream_path);
         ImGui::Spacing();
     }
 
@@ -270,25 +588,21 @@ void Scene::drawSettingsWindow() {
         ImGui::Separator();
 
 
-        // Light indices
-        std::size_t index = -1;
-        std::size_t remove = -1;
+        // Light to remove
+        Scene::LightHandle remove;
 
         // Draw light node
-        for (SceneLight *&light : light_stock) {
-            const std::string title = light->getLabel() + Scene::LIGHT_ID_TAG + std::to_string(light->getGUIID());
-            index++;
-
-            if (ImGui::TreeNode(title.c_str())) {
+        for (std::size_t i = 0U; i < light_stock.size(); i++) {
+            SceneLight *const light = light_stock[i];
+            if (ImGui::TreeNode(getTitle(light, light->getLabel(), Scene::LIGHT_ID_TAG, light->getGUIID()))) {
                 if (!Scene::drawLightGUI(light))
-                    remove = index;
+                    remove = light_stock.getHandle(i);
                 ImGui::TreePop();
             }
         }
 
         // Remove light
-        if (remove != -1)
-            popLight(remove);
+        popLight(remove);
 
         // Show add button if the stock is not full
         ImGui::Spacing();
@@ -301,41 +615,35 @@ void Scene::drawSettingsWindow() {
 
     // GLSL programs
     if (ImGui::CollapsingHeader("GLSL Programs")) {
-        // GLSL program indices
-        std::size_t index = -1;
-        std::size_t remove = -1;
+        // GLSL program to remove
+        Scene::ProgramHandle remove;
 
         // Default GLSL program
         SceneProgram *default_program = SceneProgram::getDefault();
-        std::string title = default_program->getLabel() + Scene::PROGRAM_ID_TAG + std::to_string(default_program->getGUIID());
-        if (ImGui::TreeNode(title.c_str())) {
+        if (ImGui::TreeNode(getTitle(default_program, default_program->getLabel(), Scene::PROGRAM_ID_TAG, default_program->getGUIID()))) {
             Scene::drawProgramGUI(default_program, false);
             ImGui::TreePop();
         }
 
         // Default light GLSL program
         default_program = SceneLight::getDefaultProgram();
-        title = default_program->getLabel() + Scene::PROGRAM_ID_TAG + std::to_string(default_program->getGUIID());
-        if (ImGui::TreeNode(title.c_str())) {
+        if (ImGui::TreeNode(getTitle(default_program, default_program->getLabel(), Scene::PROGRAM_ID_TAG, default_program->getGUIID()))) {
             Scene::drawProgramGUI(default_program, false);
             ImGui::TreePop();
         }
 
         // Draw GLSL program node
-        for (SceneProgram *&program : program_stock) {
-            title = program->getLabel() + Scene::PROGRAM_ID_TAG + std::to_string(program->getGUIID());
-            index++;
-
-            if (ImGui::TreeNode(title.c_str())) {
+        for (std::size_t i = 0U; i < program_stock.size(); i++) {
+            SceneProgram *const program = program_stock[i];
+            if (ImGui::TreeNode(getTitle(program, program->getLabel(), Scene::PROGRAM_ID_TAG, program->getGUIID()))) {
                 if (!Scene::drawProgramGUI(program))
-                    remove = index;
+                    remove = program_stock.getHandle(i);
                 ImGui::TreePop();
             }
         }
 
         // Remove program
-        if (remove != -1)
-            popProgram(remove);
+        popProgram(remove);
 
         // Add button
         ImGui::Spacing();
@@ -379,6 +687,71 @@ void Scene::drawAboutWindow() {
 }
 
 
+// Draw scene graph node data, the parent and the child request are returned by reference, and false if have to remove
+bool Scene::drawNodeGUI(const SceneGraph::Node &id, SceneGraph::Node &parent, bool &add_child) {
+    // Keep flag
+    bool keep = true;
+
+    // Label
+    std::string label = graph->getLabel(id);
+    if (ImGui::InputText("Name", &label))
+        graph->setLabel(id, label);
+
+    // Add child button
+    if (ImGui::Button("Add child"))
+        add_child = true;
+
+    // Remove node button
+    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.60F, 0.24F, 0.24F, 1.00F));
+    ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.80F, 0.16F, 0.16F, 1.00F));
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.70F, 0.21F, 0.21F, 1.00F));
+    ImGui::SameLine();
+    if (ImGui::Button("Remove"))
+        keep = false;
+    ImGui::PopStyleColor(3);
+    Scene::HelpMarker("Removes the subtree, the attached\nelements stay where they are");
+
+    // Parent, the nodes of the subtree are not allowed
+    parent = Scene::drawNodeComboGUI("Parent", parent, id);
+
+    // Position
+    glm::vec3 value = graph->getPosition(id);
+    if (ImGui::DragFloat3("Position", &value.x, 0.01F, 0.0F, 0.0F, "%.4F"))
+        graph->setPosition(id, value);
+
+    // Rotation
+    value = graph->getRotationAngles(id);
+    if (ImGui::DragFloat3("Rotation", &value.x, 0.50F, 0.0F, 0.0F, "%.4F"))
+        graph->setRotation(id, value);
+    Scene::HelpMarker("Angles in degrees");
+
+    // Scale
+    value = graph->getScale(id);
+    if (ImGui::DragFloat3("Scale", &value.x, 0.01F, 0.0F, 0.0F, "%.4F"))
+        graph->setScale(id, value);
+
+    // Attached elements
+    const std::vector<SceneModel *> &models = graph->getModels(id);
+    const std::vector<SceneLight *> &lights = graph->getLights(id);
+    const std::vector<SceneCamera *> &cameras = graph->getCameras(id);
+    const std::string attached_title = "Attached (" + std::to_string(models.size() + lights.size() + cameras.size()) + ")";
+    if (ImGui::TreeNode(attached_title.c_str())) {
+        for (SceneModel *const &model : models)
+            ImGui::BulletText("Model: %s", model->getLabel().c_str());
+        for (SceneLight *const &light : lights)
+            ImGui::BulletText("Light: %s", light->getLabel().c_str());
+        for (SceneCamera *const &scene_cam : cameras)
+            ImGui::BulletText("Camera: %s", scene_cam->getLabel().c_str());
+        ImGui::TreePop();
+    }
+
+    // Separator when the node is open
+    ImGui::Separator();
+
+    // Return keep status
+    return keep;
+}
+
 // Draw camera data and return false if have to remove
 bool Scene::drawCameraGUI(SceneCamera *const scene_cam, const bool select_button) {
     // Keep flag
@@ -389,10 +762,12 @@ bool Scene::drawCameraGUI(SceneCamera *const scene_cam, const bool select_button
 
     // Select and remove camera
     if (select_button) {
-        // Select option
+        // Select option, through its handle so the views are laid out again
         bool selected = (scene_cam == camera);
         if (ImGui::Checkbox("Selected", &selected))
-            camera = scene_cam;
+            for (std::size_t i = 0U; i < camera_stock.size(); i++)
+                if (camera_stock[i] == scene_cam)
+                    selectCamera(camera_stock.getHandle(i));
 
         // Remove button if there are more than one camera
         if (camera_stock.size() > 1U) {
@@ -429,6 +804,12 @@ bool Scene::drawCameraGUI(SceneCamera *const scene_cam, const bool select_button
     if (ImGui::DragFloat3("Direction", &value.x, 0.01F, 0.0F, 0.0F, "%.4F"))
         scene_cam->setLookDirection(value);
 
+    // Scene graph node
+    const SceneGraph::Node node = graph->getNode(scene_cam);
+    const SceneGraph::Node selected_node = Scene::drawNodeComboGUI("Node", node);
+    if (selected_node != node)
+        graph->attach(scene_cam, selected_node);
+
     // Clipping planes
     glm::vec2 clipping = scene_cam->getClipping();
     if (ImGui::DragFloat2("Clipping", &clipping.x, 0.01F, 0.0F, 0.0F, "%.4F"))
@@ -452,15 +833,22 @@ bool Scene::drawModelGUI(SceneModel *const model) {
     bool keep = true;
 
     // Model path
-    if (ImGui::InputText("Path", &model->getPath(), ImGuiInputTextFlags_EnterReturnsTrue))
+    if (ImGui::InputText("Path", &model->getPath(), ImGuiInputTextFlags_EnterReturnsTrue)) {
         model->reload();
+        countModel(model);
+        model_list.dirty = true;
+    }
 
     // Model name
-    ImGui::InputText("Name", &model->getLabel());
+    if (ImGui::InputText("Name", &model->getLabel()))
+        model_list.dirty = true;
 
     // Reload button
-    if (ImGui::Button("Reload model"))
+    if (ImGui::Button("Reload model")) {
         model->reload();
+        countModel(model);
+        model_list.dirty = true;
+    }
 
     // Remove model button
     ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.60F, 0.24F, 0.24F, 1.00F));
@@ -481,6 +869,21 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         return keep;
     }
 
+    // Loading progress
+    if (model->isLoading()) {
+        ImGui::Spacing();
+        const float size = (float)model->getLoadSize() / 1048576.0F;
+        const float loaded = glm::min((float)model->getLoadedBytes() / 1048576.0F, size);
+        char progress[64];
+        std::snprintf(progress, sizeof(progress), "%.1f/%.1f MB", loaded, size);
+        ImGui::ProgressBar(size > 0.0F ? loaded / size : 0.0F, ImVec2(0.0F, 0.0F), progress);
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel"))
+            model->cancelLoading();
+        ImGui::BulletText("Polygons ready: %u", (unsigned int)model->getPolygons());
+        return keep;
+    }
+
     // Enabled status
     ImGui::Spacing();
     bool enabled = model->isEnabled();
@@ -499,16 +902,47 @@ bool Scene::drawModelGUI(SceneModel *const model) {
     if (ImGui::Checkbox("Show bounding box", &show_bounding_box))
         model->showBoundingBox(show_bounding_box);
 
+    // Cluster culling status
+    bool culling = model->isClusterCulling();
+    if (ImGui::Checkbox("Cluster culling", &culling))
+        model->setClusterCulling(culling);
+
+    // Normal cone culling status
+    ImGui::SameLine();
+    culling = model->isConeCulling();
+    if (ImGui::Checkbox("Backface cones", &culling))
+        model->setConeCulling(culling);
+    Scene::HelpMarker("Cull the clusters whose normal cone\nfaces away of the camera");
+
 
     // Sumary
     if (ImGui::TreeNodeEx("Sumary", ImGuiTreeNodeFlags_DefaultOpen)) {
-        ImGui::Text("Polygons: %u", model->Model::getPolygons());
+        ImGui::Text("Polygons: %u", (unsigned int)model->Model::getPolygons());
+        ImGui::SameLine(210.0F);
+        ImGui::Text("Materials: %u", (unsigned int)model->Model::getMaterials());
+        ImGui::Text("Vertices: %u", (unsigned int)model->Model::getVertices()); Scene::HelpMarker("Unique vertices");
         ImGui::SameLine(210.0F);
-        ImGui::Text("Materials: %u", model->Model::getMaterials());
-        ImGui::Text("Vertices: %u", model->Model::getVertices()); Scene::HelpMarker("Unique vertices");
+        ImGui::Text("Textures: %u", (unsigned int)model->Model::getTextures());
+        ImGui::Text("Elements: %u", (unsigned int)model->Model::getElements()); Scene::HelpMarker("Total of vertices");
         ImGui::SameLine(210.0F);
-        ImGui::Text("Textures: %u", model->Model::getTextures());
-        ImGui::Text("Elements: %u", model->Model::getElements()); Scene::HelpMarker("Total of vertices");
+        ImGui::Text("Clusters: %u", (unsigned int)model->Model::getClusters());
+
+        // Submitted polygons
+        const std::size_t polygons = model->Model::getPolygons();
+        const std::size_t submitted = model->Model::getSubmittedPolygons();
+        ImGui::Text("Submitted: %u (%.1f%%)", (unsigned int)submitted, polygons > 0U ? 100.0F * (float)submitted / (float)polygons : 0.0F);
+        Scene::HelpMarker("Polygons of the visible clusters\nin the last frame");
+
+        // GPU memory of the buffers and the textures of the materials
+        std::size_t texture_memory = 0U;
+        for (SceneMaterial *const &scene_material : model->getMaterialStock())
+            for (std::uint8_t i = Texture::AMBIENT; i != 0U; i <<= 1U) {
+                const Texture *const texture = scene_material->getMaterial()->getTexture((Texture::Type)i);
+                texture_memory += (texture != nullptr ? texture->getMemory() : 0U);
+            }
+        ImGui::Text("Buffers: %.2f MB", (double)model->Model::getMemory() / 1048576.0);
+        ImGui::SameLine(210.0F);
+        ImGui::Text("Textures: %.2f MB", (double)texture_memory / 1048576.0); Scene::HelpMarker("Shared textures are counted\nby each material using them");
         ImGui::TreePop();
     }
 
@@ -516,6 +950,12 @@ bool Scene::drawModelGUI(SceneModel *const model) {
     ImGui::Spacing();
     Scene::drawProgramComboGUI(model);
 
+    // Scene graph node
+    const SceneGraph::Node node = graph->getNode(model);
+    const SceneGraph::Node selected_node = Scene::drawNodeComboGUI("Node", node);
+    if (selected_node != node)
+        graph->attach(model, selected_node);
+
     // Geometry
     if (ImGui::TreeNodeEx("Geometry", ImGuiTreeNodeFlags_DefaultOpen)) {
         // Position
@@ -555,8 +995,10 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         ImGui::InputText("Name", &model->getMaterialName(), ImGuiInputTextFlags_ReadOnly); Scene::HelpMarker("Read only");
 
         // Reload
-        if (ImGui::Button("Reload material"))
+        if (ImGui::Button("Reload material")) {
             model->reloadMaterial();
+            countModel(model);
+        }
 
         // Check material status
         if (!model->isMaterialOpen()) {
@@ -574,7 +1016,7 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         // Ambient component
         glm::vec3 color = global->getAmbientColor();
         if (ImGui::ColorEdit3("Ambient", &color.x)) {
-            for (SceneMaterial *&material : model->getMaterialStock())
+            for (SceneMaterial *const &material : model->getMaterialStock())
                 material->getMaterial()->setAmbientColor(color);
             global->setAmbientColor(color);
         }
@@ -582,7 +1024,7 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         // Difusse component
         color = global->getDiffuseColor();
         if (ImGui::ColorEdit3("Diffuse", &color.x)) {
-            for (SceneMaterial *&material : model->getMaterialStock())
+            for (SceneMaterial *const &material : model->getMaterialStock())
                 material->getMaterial()->setDiffuseColor(color);
             global->setDiffuseColor(color);
         }
@@ -590,7 +1032,7 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         // Specular component
         color = global->getSpecularColor();
         if (ImGui::ColorEdit3("Specular", &color.x)) {
-            for (SceneMaterial *&material : model->getMaterialStock())
+            for (SceneMaterial *const &material : model->getMaterialStock())
                 material->getMaterial()->setSpecularColor(color);
             global->setSpecularColor(color);
         }
@@ -598,7 +1040,7 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         // Alpha
         float value = global->getAlpha();
         if (ImGui::DragFloat("Alpha", &value, 0.001F, 0.0F, 1.0F, "%.4F")) {
-            for (SceneMaterial *&material : model->getMaterialStock())
+            for (SceneMaterial *const &material : model->getMaterialStock())
                 material->getMaterial()->setAlpha(value);
             global->setAlpha(value);
         }
@@ -606,7 +1048,7 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         // Shininess
         value = global->getShininess();
         if (ImGui::DragFloat("Shininess", &value, 0.025F, 0.0F, FLT_MAX, "%.4F")) {
-            for (SceneMaterial *&material : model->getMaterialStock())
+            for (SceneMaterial *const &material : model->getMaterialStock())
                 material->getMaterial()->setShininess(value);
             global->setShininess(value);
         }
@@ -614,7 +1056,7 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         // Roughness
         value = global->getRoughness();
         if (ImGui::DragFloat("Roughness", &value, 0.001F, 0.0F, 1.0F, "%.4F")) {
-            for (SceneMaterial *&material : model->getMaterialStock())
+            for (SceneMaterial *const &material : model->getMaterialStock())
                 material->getMaterial()->setRoughness(value);
             global->setRoughness(value);
         }
@@ -622,7 +1064,7 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         // Metalness
         value = global->getMetalness();
         if (ImGui::DragFloat("Metalness", &value, 0.001F, 0.0F, 1.0F, "%.4F")) {
-            for (SceneMaterial *&material : model->getMaterialStock())
+            for (SceneMaterial *const &material : model->getMaterialStock())
                 material->getMaterial()->setMetalness(value);
             global->setMetalness(value);
         }
@@ -637,96 +1079,104 @@ bool Scene::drawModelGUI(SceneModel *const model) {
         ImGui::Separator();
 
 
-        // Material stock
-        for (SceneMaterial *&scene_material : model->getMaterialStock()) {
-            // Get tittle
+        // Filtered list of the materials, only its visible rows are drawn
+        const std::vector<SceneMaterial *> &material_stock = model->getMaterialStock();
+        ImGui::Spacing();
+        Scene::drawListGUI("materials", material_list, material_stock.size(), [&material_stock](const std::size_t &i) -> const std::string & {
+            return material_stock[i]->getLabel();
+        }, selected_material);
+
+        // Widgets of the selected material
+        if (selected_material < material_stock.size()) {
+            // Get the scene material and its ID
+            SceneMaterial *const scene_material = material_stock[selected_material];
             const std::string material_id = std::to_string(scene_material->getGUIID());
-            const std::string material_title = scene_material->getLabel() + Scene::MATERIAL_ID_TAG + material_id;
-
-            // Material node
-            if (ImGui::TreeNode(material_title.c_str())) {
-                // Get the material
-                Material *material = scene_material->getMaterial();
-
-                // Material name
-                ImGui::InputText("Name", &scene_material->getLabel());
-
-
-                // Ambient component
-                glm::vec3 color = material->getAmbientColor();
-                if (ImGui::ColorEdit3("Ambient", &color.x))
-                    material->setAmbientColor(color);
-
-                // Difusse component
-                color = material->getDiffuseColor();
-                if (ImGui::ColorEdit3("Diffuse", &color.x))
-                    material->setDiffuseColor(color);
-
-                // Specular component
-                color = material->getSpecularColor();
-                if (ImGui::ColorEdit3("Specular", &color.x))
-                    material->setSpecularColor(color);
-
-                // Alpha
-                float value = material->getAlpha();
-                if (ImGui::DragFloat("Alpha", &value, 0.001F, 0.0F, 1.0F, "%.4F"))
-                    material->setAlpha(value);
-
-                // Shininess
-                value = material->getShininess();
-                if (ImGui::DragFloat("Shininess", &value, 0.025F, 0.0F, FLT_MAX, "%.4F"))
-                    material->setShininess(value);
-
-                // Roughness
-                value = material->getRoughness();
-                if (ImGui::DragFloat("Roughness", &value, 0.001F, 0.0F, 1.0F, "%.4F"))
-                    material->setRoughness(value);
-
-                // Metalness
-                value = material->getMetalness();
-                if (ImGui::DragFloat("Metalness", &value, 0.001F, 0.0F, 1.0F, "%.4F"))
-                    material->setMetalness(value);
-
-
-                // Textures node
-                ImGui::Spacing();
-                if (ImGui::TreeNode("Textures")) {
-                    for (std::uint8_t i = Texture::AMBIENT; i != 0U; i <<= 1U) {
-                        // Get texture
-                        const Texture::Type type = (Texture::Type)i;
-
-                        // Texture title
-                        const std::string type_str = Texture::to_string(type);
-                        const std::string texture_title = type_str + ": " + scene_material->getTextureLabel(type) + Scene::TEXTURE_ID_TAG + material_id + type_str;
-
-                        if (ImGui::TreeNode(texture_title.c_str())) {
-                            // Texture path
-                            if (ImGui::InputText("Path", &scene_material->getTexturePath(type), ImGuiInputTextFlags_EnterReturnsTrue))
-                                scene_material->reload(type);
-
-                            // Texture name
-                            ImGui::InputText("Name", &scene_material->getTextureLabel(type));
-
-                            // Reload buttons
-                            if (ImGui::Button("Reload texture"))
-                                scene_material->reload(type);
-
-                            // Draw texture
-                            ImGui::Image((void *)(intptr_t)(material->getTexture(type)->getID()), ImVec2(300.0F, 300.0F), ImVec2(0.0F, 1.0F), ImVec2(1.0F, 0.0F));
-
-                            // Pop texture node
-                            ImGui::TreePop();
-                        }
-                    }
+            ImGui::PushID((int)scene_material->getGUIID());
+            ImGui::Spacing();
+
+            // Get the material
+            Material *material = scene_material->getMaterial();
+
+            // Material name
+            if (ImGui::InputText("Name", &scene_material->getLabel()))
+                material_list.dirty = true;
+
+
+            // Ambient component
+            glm::vec3 color = material->getAmbientColor();
+            if (ImGui::ColorEdit3("Ambient", &color.x))
+                material->setAmbientColor(color);
+
+            // Difusse component
+            color = material->getDiffuseColor();
+            if (ImGui::ColorEdit3("Diffuse", &color.x))
+                material->setDiffuseColor(color);
+
+            // Specular component
+            color = material->getSpecularColor();
+            if (ImGui::ColorEdit3("Specular", &color.x))
+                material->setSpecularColor(color);
+
+            // Alpha
+            float value = material->getAlpha();
+            if (ImGui::DragFloat("Alpha", &value, 0.001F, 0.0F, 1.0F, "%.4F"))
+                material->setAlpha(value);
 
-                    // Pop textures node
-                    ImGui::TreePop();
+            // Shininess
+            value = material->getShininess();
+            if (ImGui::DragFloat("Shininess", &value, 0.025F, 0.0F, FLT_MAX, "%.4F"))
+                material->setShininess(value);
+
+            // Roughness
+            value = material->getRoughness();
+            if (ImGui::DragFloat("Roughness", &value, 0.001F, 0.0F, 1.0F, "%.4F"))
+                material->setRoughness(value);
+
+            // Metalness
+            value = material->getMetalness();
+            if (ImGui::DragFloat("Metalness", &value, 0.001F, 0.0F, 1.0F, "%.4F"))
+                material->setMetalness(value);
+
+
+            // Textures node
+            ImGui::Spacing();
+            if (ImGui::TreeNode("Textures")) {
+                for (std::uint8_t i = Texture::AMBIENT; i != 0U; i <<= 1U) {
+                    // Get texture
+                    const Texture::Type type = (Texture::Type)i;
+
+                    // Texture title
+                    const std::string type_str = Texture::to_string(type);
+                    const std::string texture_title = type_str + ": " + scene_material->getTextureLabel(type) + Scene::TEXTURE_ID_TAG + material_id + type_str;
+
+                    if (ImGui::TreeNode(texture_title.c_str())) {
+                        // Texture path
+                        if (ImGui::InputText("Path", &scene_material->getTexturePath(type), ImGuiInputTextFlags_EnterReturnsTrue))
+                            scene_material->reload(type);
+
+                        // Texture name
+                        ImGui::InputText("Name", &scene_material->getTextureLabel(type));
+
+                        // Reload buttons
+                        if (ImGui::Button("Reload texture"))
+                            scene_material->reload(type);
+
+                        // GPU memory and texture
+                        ImGui::Text("Memory: %.2f MB", (double)material->getTexture(type)->getMemory() / 1048576.0);
+                        ImGui::Image((void *)(intptr_t)(material->getTexture(type)->getID()), ImVec2(300.0F, 300.0F), ImVec2(0.0F, 1.0F), ImVec2(1.0F, 0.0F));
+
+                        // Pop texture node
+                        ImGui::TreePop();
+                    }
                 }
 
-                // Pop material node
+                // Pop textures node
                 ImGui::TreePop();
-                ImGui::Separator();
             }
+
+            // Pop the material ID
+            ImGui::PopID();
+            ImGui::Separator();
         }
 
         // Pop materials node
@@ -786,6 +1236,11 @@ bool Scene::drawLightGUI(SceneLight *const light) {
             light->setGrabbed(status);
     }
 
+    // Shadow casting status
+    status = light->castingShadow();
+    if (ImGui::Checkbox("Cast shadow", &status))
+        light->castShadow(status);
+
     // Remove button if there are more than one model
     if (light_stock.size() > 1U) {
         ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.60F, 0.24F, 0.24F, 1.00F));
@@ -808,6 +1263,12 @@ bool Scene::drawLightGUI(SceneLight *const light) {
     value = light->getDirection();
     if (ImGui::DragFloat3("Direction", &value.x, 0.01F, 0.0F, 0.0F, "%.4F"))
         light->setDirection(value);
+
+    // Scene graph node
+    const SceneGraph::Node node = graph->getNode(light);
+    const SceneGraph::Node selected_node = Scene::drawNodeComboGUI("Node", node);
+    if (selected_node != node)
+        graph->attach(light, selected_node);
     ImGui::Spacing();
 
 
@@ -880,6 +1341,12 @@ bool Scene::drawProgramGUI(SceneProgram *const program, const bool &removable) {
     if (ImGui::Button("Reload GLSL program"))
         program->reload();
 
+    // Reloading status
+    if (program->isReloading() || program->isPending()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("Compiling...");
+    }
+
     // Remove program button
     if (removable) {
         ImGui::PushStyleColor(ImGuiCol_Button,        ImVec4(0.60F, 0.24F, 0.24F, 1.00F));
@@ -892,11 +1359,14 @@ bool Scene::drawProgramGUI(SceneProgram *const program, const bool &removable) {
     }
 
     // Check valid status
-    if (!program->isValid()) {
+    if (!program->isValid() && !program->isPending()) {
         ImGui::SameLine();
         ImGui::TextColored(ImVec4(0.80F, 0.16F, 0.16F, 1.00F), "Invalid GLSL program");
     }
 
+    // Compiled variants
+    ImGui::Text("Variants: %u", (unsigned int)program->getVariants()); Scene::HelpMarker("Permutations compiled for the light\ncounts and material texture maps");
+
     // Shaders path
     ImGui::Spacing();
     ImGui::BulletText("Shaders");
@@ -920,6 +1390,59 @@ bool Scene::drawProgramGUI(SceneProgram *const program, const bool &removable) {
 }
 
 
+// Draw the streamed model widget
+bool Scene::drawStreamModelGUI(StreamModel *const model) {
+    // Keep flag
+    bool keep = true;
+
+    // Model path
+    ImGui::Text("Path: %s", model->getPath().c_str());
+
+    // Remove model button
+    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.60F, 0.24F, 0.24F, 1.00F));
+    ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.80F, 0.16F, 0.16F, 1.00F));
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.70F, 0.21F, 0.21F, 1.00F));
+    if (ImGui::Button("Remove"))
+        keep = false;
+    ImGui::PopStyleColor(3);
+
+    // Check open status
+    if (!model->isOpen()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(0.80F, 0.16F, 0.16F, 1.00F), "Could not open the chunks file");
+        return keep;
+    }
+
+    // GPU memory budget
+    ImGui::Spacing();
+    int budget = (int)(model->getBudget() >> 20U);
+    if (ImGui::DragInt("Budget (MB)", &budget, 1.0F, 1, 4096) && (budget > 0))
+        model->setBudget((std::size_t)budget << 20U);
+    const std::string used = std::to_string(model->getResidentChunks()) + "/" + std::to_string(model->getSlots()) + " slots";
+    ImGui::ProgressBar(model->getSlots() == 0U ? 0.0F : (float)model->getResidentChunks() / (float)model->getSlots(), ImVec2(0.0F, 0.0F), used.c_str());
+
+    // Statistics
+    ImGui::BulletText("Chunks: %u", (unsigned int)model->getChunks());
+    ImGui::BulletText("Resident: %u", (unsigned int)model->getResidentChunks());
+    ImGui::BulletText("Drawn: %u", (unsigned int)model->getDrawnChunks());
+    ImGui::BulletText("Uploaded: %u", (unsigned int)model->getUploadedChunks());
+    ImGui::BulletText("Pool memory: %.2f MB", (double)model->getUsedMemory() / 1048576.0);
+    ImGui::BulletText("Polygons: %u", (unsigned int)model->getPolygons());
+
+    // Position
+    ImGui::Spacing();
+    glm::vec3 value = model->getPosition();
+    if (ImGui::DragFloat3("Position", &value.x, 0.01F, 0.0F, 0.0F, "%.4F"))
+        model->setPosition(value);
+
+    // Scale
+    value = model->getScale();
+    if (ImGui::DragFloat3("Scale", &value.x, 0.01F, 0.0F, 0.0F, "%.4F"))
+        model->setScale(value);
+
+    return keep;
+}
+
 // Show combo with available programs
 void Scene::drawProgramComboGUI(SceneModel *const model, const bool &light) {
     // Get title
@@ -968,6 +1491,38 @@ void Scene::drawProgramComboItemGUI(SceneModel *const model, SceneProgram *const
         ImGui::SetItemDefaultFocus();
 }
 
+// Show combo with the scene graph nodes and return the selected one, the subtree of the excluded node is not listed
+SceneGraph::Node Scene::drawNodeComboGUI(const char *const title, const SceneGraph::Node &current, const SceneGraph::Node &exclude) {
+    SceneGraph::Node node = current;
+
+    // Show combo
+    if (ImGui::BeginCombo(title, graph->contains(current) ? graph->getLabel(current).c_str() : "None")) {
+        // Without node
+        if (ImGui::Selectable("None", !graph->contains(current)))
+            node = SceneGraph::NONE;
+
+        // Nodes indented by their depth
+        for (std::size_t i = 0U; i < graph->getNodes(); i++) {
+            const SceneGraph::Node id = graph->getID(i);
+            if (graph->isAncestor(exclude, id))
+                continue;
+
+            const std::string item = std::string(2U * graph->getDepth(i), ' ') + graph->getLabel(id) + Scene::NODE_ID_TAG + std::to_string(id);
+            const bool selected = (id == current);
+            if (ImGui::Selectable(item.c_str(), selected))
+                node = id;
+
+            // Set default focus to selected
+            if (selected)
+                ImGui::SetItemDefaultFocus();
+        }
+
+        ImGui::EndCombo();
+    }
+
+    return node;
+}
+
 
 // Scene constructor
 Scene::Scene(const int &width_res, const int &height_res) {
@@ -978,8 +1533,9 @@ Scene::Scene(const int &width_res, const int &height_res) {
 	// Mouse and camera
 	mouse = new Mouse(width, height);
 	camera = new SceneCamera(width, height);
-	camera_stock.push_back(camera);
+	camera_stock.insert(camera);
 	SceneLight::setCamera(&camera);
+	split_screen = false;
 
 	// GUI flags
 	show_gui = true;
@@ -992,46 +1548,622 @@ Scene::Scene(const int &width_res, const int &height_res) {
 
 	// Set background color
 	background = glm::vec3(0.0F);
+
+	// Light clusters and assets watcher
+	light_grid = new LightGrid();
+	gbuffer = nullptr;
+	deferred_support = GBuffer::isSupported();
+	transparency = nullptr;
+	transparency_program = nullptr;
+	transparency_support = TransparencyBuffer::isSupported();
+	shadow_maps = nullptr;
+	shadow_support = ShadowMaps::isSupported();
+	timer = new GPUTimer(5U);
+
+	// Depth pre-pass
+	depth_program = nullptr;
+	depth_prepass = true;
+	front_to_back = true;
+	counter = new SampleCounter(2U);
+
+	// Occlusion culling
+	occlusion = new OcclusionBuffer();
+	occlusion_culling = false;
+	show_occlusion = false;
+	watcher = new FileWatcher();
+	watch_time = std::chrono::steady_clock::time_point();
+
+	// Scene graph
+	graph = new SceneGraph();
+
+	// Streamed models conversion
+	convert_cancel = false;
+	convert_done = false;
+
+	// Session file
+	session_path = "session.scene";
+	session_json = false;
+
+	// On demand drawing
+	on_demand = true;
+	redraw_frames = Scene::REDRAW_FRAMES;
+	idle = false;
+
+	// Frame pacing and camera travel
+	pacer = new FramePacer();
+	travel_camera = nullptr;
+	travel_previous = glm::vec3(0.0F);
+	travel_current = glm::vec3(0.0F);
+	travel_drawn = glm::vec3(0.0F);
+
+	// Statistics
+	model_totals = Scene::model_stats();
+	submitted_polygons = 0U;
+	shaders = 0U;
+
+	// Models and materials lists
+	model_list.size = 0U;
+	model_list.dirty = true;
+	material_list.size = 0U;
+	material_list.dirty = true;
+	selected_material = Scene::NO_SELECTION;
+}
+
+
+// Watch the paths of the shaders, models, materials and textures
+void Scene::watchAssets() {
+	std::set<std::string> paths;
+
+	// Shaders of the programs
+	std::vector<SceneProgram *> programs(program_stock.begin(), program_stock.end());
+	programs.push_back(SceneProgram::getDefault());
+	programs.push_back(SceneLight::getDefaultProgram());
+	if (depth_program != nullptr)
+		programs.push_back(depth_program);
+	if (transparency_program != nullptr)
+		programs.push_back(transparency_program);
+	for (SceneProgram *const &program : programs) {
+		for (const GLenum type : {GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER})
+			paths.insert(program->getShaderPath(type));
+
+		// Included files
+		const std::set<std::string> dependency = program->getDependencies();
+		paths.insert(dependency.begin(), dependency.end());
+	}
+	paths.insert(GBuffer::getScreenShader());
+
+	// Models, their materials files and textures, the ones still loading are watched when they finish
+	for (SceneModel *const &model : model_stock) {
+		if (model->isLoading())
+			continue;
+
+		paths.insert(model->Model::getPath());
+		paths.insert(model->getMaterialPath());
+
+		for (SceneMaterial *const &material : model->getMaterialStock())
+			for (unsigned int bit = Texture::AMBIENT; bit <= Texture::STENCIL; bit <<= 1U) {
+				const Texture *const texture = material->getMaterial()->getTexture((Texture::Type)bit);
+				if (texture != nullptr)
+					paths.insert(texture->getPath());
+			}
+	}
+
+	watcher->setPaths(paths);
+}
+
+// Join the finished conversion and fill the chunks path if it succeeded
+void Scene::updateConversion() {
+	if (!converter.joinable() || !convert_done)
+		return;
+
+	converter.join();
+	if (convert_error.empty())
+		stream_path = convert_output;
+	else
+		std::cerr << convert_error << std::endl;
+
+	requestRedraw();
+}
+
+// Reload only the assets of the changed paths
+void Scene::reloadAssets(const std::vector<std::string> &paths) {
+	if (paths.empty())
+		return;
+
+	const std::unordered_set<std::string> changed(paths.begin(), paths.end());
+
+	// Drop the changed shader sources from the cache
+	for (const std::string &path : paths)
+		ShaderPreprocessor::invalidate(path);
+
+	// Programs using a changed shader or include, the current program is kept until the new one is linked
+	std::vector<SceneProgram *> programs(program_stock.begin(), program_stock.end());
+	programs.push_back(SceneProgram::getDefault());
+	programs.push_back(SceneLight::getDefaultProgram());
+	if (depth_program != nullptr)
+		programs.push_back(depth_program);
+	if (transparency_program != nullptr)
+		programs.push_back(transparency_program);
+	for (SceneProgram *const &program : programs) {
+		bool reload = false;
+		for (const GLenum type : {GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER})
+			reload |= (changed.count(program->getShaderPath(type)) != 0U);
+
+		for (const std::string &dependency : program->getDependencies())
+			reload |= (changed.count(dependency) != 0U);
+
+		// The lighting variants use the screen vertex shader
+		reload |= ((changed.count(GBuffer::getScreenShader()) != 0U) && program->supports("GBUFFER"));
+
+		if (reload)
+			program->reload();
+	}
+
+	// Models, the geometry reload also reads the materials and textures, the ones still loading are skipped
+	for (SceneModel *const &model : model_stock) {
+		if (model->isLoading())
+			continue;
+
+		if (changed.count(model->Model::getPath()) != 0U) {
+			model->reload();
+			countModel(model);
+			continue;
+		}
+
+		// Materials file, it also reads the textures
+		if (changed.count(model->getMaterialPath()) != 0U) {
+			model->reloadMaterial();
+			countModel(model);
+			continue;
+		}
+
+		// Upload only the changed textures
+		for (SceneMaterial *const &material : model->getMaterialStock())
+			for (unsigned int bit = Texture::AMBIENT; bit <= Texture::STENCIL; bit <<= 1U) {
+				Texture *const texture = material->getMaterial()->getTexture((Texture::Type)bit);
+				if ((texture != nullptr) && (changed.count(texture->getPath()) != 0U))
+					texture->reload();
+			}
+	}
 }
 
 
+// Update the scene before drawing
+void Scene::update() {
+	// Run the callbacks of the finished loader jobs
+	Loader::update();
+
+	// Move the elements attached to the changed scene graph nodes
+	graph->update();
+
+	// Upload the geometry of the models in loading and count them when they finish
+	for (SceneModel *const &model : model_stock)
+		if (model->updateLoading())
+			countModel(model);
+
+	// Light model
+	if (SceneLight::getModel() != nullptr)
+		SceneLight::getModel()->updateLoading();
+
+	// Streamed model conversion
+	updateConversion();
+
+	// Check the programs being compiled, the light program is one of them
+	SceneProgram::getDefault()->updateReload();
+	SceneLight::getDefaultProgram()->updateReload();
+	shaders = 0U;
+	for (SceneProgram *const &program : program_stock) {
+		program->updateReload();
+		shaders += program->getShaders();
+	}
+
+	if (depth_program != nullptr)
+		depth_program->updateReload();
+
+	if (transparency_program != nullptr)
+		transparency_program->updateReload();
+
+	// Update the watched paths periodically and reload the changed assets
+	if (std::chrono::steady_clock::now() - watch_time > std::chrono::duration<double>(Scene::WATCH_INTERVAL)) {
+		watchAssets();
+		watch_time = std::chrono::steady_clock::now();
+	}
+	reloadAssets(watcher->update());
+
+	// Nothing to draw in the on demand mode until an input, a camera change or some work in progress
+	idle = on_demand && (redraw_frames == 0U) && !isBusy();
+}
+
+// Check for loading models and textures, compiling programs, streaming chunks and moving nodes
+bool Scene::isBusy() const {
+	if ((Loader::getJobs() > 0U) || (graph->getUpdatedNodes() > 0U))
+		return true;
+
+	for (SceneModel *const &model : model_stock)
+		if (model->isLoading())
+			return true;
+
+	if ((SceneLight::getModel() != nullptr) && SceneLight::getModel()->isLoading())
+		return true;
+
+	for (StreamModel *const &model : stream_stock)
+		if (model->getUploadedChunks() > 0U)
+			return true;
+
+	for (SceneProgram *const &program : program_stock)
+		if (program->isReloading())
+			return true;
+
+	return SceneProgram::getDefault()->isReloading() || SceneLight::getDefaultProgram()->isReloading() || ((depth_program != nullptr) && depth_program->isReloading()) || ((transparency_program != nullptr) && transparency_program->isReloading());
+}
+
 // Draw the scene
 void Scene::draw() const {
 	// Check camera status
 	if (camera == nullptr) return;
 
-	// Draw models
-	for (const SceneModel *const &model : model_stock) {
-		// Check program and enabled status
-		if (model->isEnabled()) {
+	// Cull the clusters of the enabled models in parallel
+	std::vector<SceneModel *> enabled;
+	for (SceneModel *const &model : model_stock)
+		if (model->isEnabled())
+			enabled.push_back(model);
+
+	// Update the matrices of the moved models in one pass
+	const std::vector<Model *> transformed(enabled.begin(), enabled.end());
+	Model::updateTransforms(transformed);
+
+	// Pack the lights, the shadow maps fill the last texel of the ones casting shadows
+	std::vector<glm::vec4> lights;
+	std::vector<SceneLight *> order;
+	const std::size_t directional = SceneLight::packAll(lights, &order);
+
+	// Render the shadow maps changed since the last frame, all the enabled models are casters
+	const bool shadows = (shadow_maps != nullptr) && (depth_program != nullptr) && depth_program->isValid();
+	timer->stamp(0U);
+	if (shadows) {
+		std::vector<Light *> casting(order.size(), nullptr);
+		for (std::size_t i = 0U; i < order.size(); i++)
+			if (order[i]->isEnabled() && order[i]->castingShadow())
+				casting[i] = order[i];
+
+		shadow_maps->update(lights, casting, transformed, depth_program, camera);
+	}
+	timer->stamp(1U);
+
+	// Draw the views of the cameras, the work above is shared by all of them
+	std::vector<SceneCamera *> view_camera;
+	std::vector<glm::ivec4> view_rect;
+	getViews(view_camera, view_rect);
+
+	const bool split = (view_camera.size() > 1U);
+	if (split)
+		glEnable(GL_SCISSOR_TEST);
+
+	submitted_polygons = 0U;
+	for (std::size_t i = 0U; i < view_camera.size(); i++) {
+		const SceneCamera *const view = view_camera[i];
+		glViewport(view_rect[i].x, view_rect[i].y, view_rect[i].z, view_rect[i].w);
+		glScissor(view_rect[i].x, view_rect[i].y, view_rect[i].z, view_rect[i].w);
+
+		// The lights models face the camera of the view
+		SceneLight::setCamera(&view);
+		drawView(view, glm::ivec2(view_rect[i]), enabled, lights, directional, shadows, i == 0U);
+	}
+
+	// Restore the whole window
+	SceneLight::setCamera(&camera);
+	if (split) {
+		glDisable(GL_SCISSOR_TEST);
+		glViewport(0, 0, width, height);
+	}
+
+	timer->stamp(4U);
+	timer->next();
+	counter->next();
+}
+
+// Draw the scene from a camera in its viewport, the first view also runs the occlusion culling, timers and counters
+void Scene::drawView(const SceneCamera *const view, const glm::ivec2 &origin, std::vector<SceneModel *> enabled, const std::vector<glm::vec4> &lights, const std::size_t &directional, const bool &shadows, const bool &first) const {
+	// Rasterize the largest occluders on the screen and remove the models hidden behind them
+	const OcclusionBuffer *const occluders = (occlusion_culling && first ? occlusion : nullptr);
+	if (occluders != nullptr) {
+		occlusion->begin(view);
+
+		const glm::vec3 view_pos = view->getPosition();
+		std::vector<std::pair<float, SceneModel *> > candidate;
+		for (SceneModel *const &model : enabled) {
+			// The transparent models, blended or alpha tested, do not hide what is behind them, the alpha can change at any time
+			if (!model->isOccluder() || model->isTransparent()) continue;
+
+			const glm::vec4 sphere = model->getBoundingSphere();
+			const glm::vec3 offset = glm::vec3(sphere) - view_pos;
+			candidate.emplace_back(sphere.w * sphere.w / std::max(glm::dot(offset, offset), 1.0E-6F), model);
+		}
+
+		std::sort(candidate.begin(), candidate.end(), [](const std::pair<float, SceneModel *> &a, const std::pair<float, SceneModel *> &b) {
+			return a.first > b.first;
+		});
+
+		std::size_t added = 0U;
+		for (std::size_t i = 0U; (i < candidate.size()) && (added < OcclusionBuffer::MAX_OCCLUDERS); i++)
+			added += (std::size_t)candidate[i].second->addOccluder(occlusion);
+		occlusion->rasterize();
+
+		enabled.erase(std::remove_if(enabled.begin(), enabled.end(), [this](SceneModel *const &model) {
+			return model->isOccluded(occlusion);
+		}), enabled.end());
+	}
+
+	Scheduler::getDefault()->parallelFor(0U, enabled.size(), 1U, [view, &enabled, occluders](const std::size_t &begin, const std::size_t &end) {
+		for (std::size_t i = begin; i < end; i++)
+			enabled[i]->cull(view, occluders);
+	});
+
+	// Polygons of the visible clusters, the occluded models submit none
+	for (SceneModel *const &model : enabled)
+		submitted_polygons += model->Model::getSubmittedPolygons();
+
+	// Sort the models front to back so the early depth test rejects the hidden fragments
+	if (front_to_back) {
+		const glm::vec3 view_pos = view->getPosition();
+		std::vector<std::pair<float, SceneModel *> > sorted;
+		sorted.reserve(enabled.size());
+		for (SceneModel *const &model : enabled) {
+			const glm::vec3 offset = model->getPosition() - view_pos;
+			sorted.emplace_back(glm::dot(offset, offset), model);
+		}
+
+		std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<float, SceneModel *> &a, const std::pair<float, SceneModel *> &b) {
+			return a.first < b.first;
+		});
+
+		for (std::size_t i = 0U; i < sorted.size(); i++)
+			enabled[i] = sorted[i].second;
+	}
+
+	// Assign the point and spot lights to the clusters of the view and upload them
+	light_grid->assign(lights, directional, view, origin);
+	light_grid->upload();
+
+	// Set the camera and lights uniforms of a program once per view
+	std::unordered_set<GLSLProgram *> prepared;
+	const auto prepare = [this, view, &prepared, shadows](GLSLProgram *const program) {
+		if (!prepared.insert(program).second || !program->isValid())
+			return;
+
+		// Use camera, lights and shadows
+		view->use(program);
+		light_grid->bind(program);
+		if (shadows)
+			shadow_maps->bind(program);
+	};
+
+	// Lights and shadows part of the variant defines
+	const std::string light_defines = SceneLight::getDefines() + (shadows ? ShadowMaps::getDefines() : std::string());
+
+	// The transparent material groups are blended after the opaque models when the composite program is ready, else they are alpha tested
+	const bool blended = (transparency != nullptr) && (transparency_program != nullptr) && transparency_program->isValid();
+
+	// Deferred geometry pass of the models with G-buffer code paths, the others are drawn forward
+	std::vector<SceneModel *> forward;
+	std::vector<GLSLProgram *> slot;
+	if (gbuffer != nullptr) {
+		gbuffer->begin();
+
+		for (SceneModel *const &model : enabled) {
+			GLSLProgram *program = model->getProgram();
+			program = ((program != nullptr) && program->isValid() ? program : SceneProgram::getDefault());
+
+			// Stencil value of the program
+			std::vector<GLSLProgram *>::const_iterator found = std::find(slot.begin(), slot.end(), program);
+			if (!program->supports("GBUFFER") || ((found == slot.end()) && (slot.size() == (std::size_t)GBuffer::MAX_PROGRAMS))) {
+				forward.push_back(model);
+				continue;
+			}
+
+			if (found == slot.end())
+				found = slot.insert(slot.end(), program);
+			gbuffer->mark((GLint)(found - slot.begin()) + 1);
+
+			// The material groups are skipped until their variant is ready, the blended ones are drawn in the transparent pass
+			const bool skip = blended && program->supports("TRANSPARENCY");
+			model->draw(program, [&prepare, program, skip](const Material *const material) -> GLSLProgram * {
+				if (skip && material->isTransparent())
+					return nullptr;
+
+				GLSLProgram *const variant = program->findVariant("#define VARIANT\n#define GBUFFER\n" + material->getDefines());
+				if (variant != nullptr)
+					prepare(variant);
+				return variant;
+			});
+		}
+		if (first)
+			timer->stamp(2U);
+
+		// Lighting pass of each program, the stencil selects its pixels
+		gbuffer->resolve();
+		for (std::size_t i = 0U; i < slot.size(); i++) {
+			GLSLProgram *const lighting = slot[i]->findVariant(light_defines + "#define DEFERRED_LIGHTING\n", GBuffer::getScreenShader());
+			if (lighting == nullptr)
+				continue;
+
+			prepare(lighting);
+			gbuffer->shade(lighting, view, (GLint)i + 1, origin);
+		}
+		gbuffer->end();
+	}
+
+	else {
+		forward = enabled;
+		if (first)
+			timer->stamp(2U);
+	}
+	if (first)
+		timer->stamp(3U);
+
+	// Forward programs with the same vertex shader than the depth pre-pass, their groups that are not alpha tested are covered by it
+	const std::string vert_path = ((depth_program != nullptr) && depth_program->isValid() ? depth_program->getShaderPath(GL_VERTEX_SHADER) : std::string());
+	const auto covered = [&vert_path](GLSLProgram *const program) -> bool {
+		return !vert_path.empty() && (program->getShader(GL_VERTEX_SHADER) != nullptr) && (program->getShader(GL_VERTEX_SHADER)->getPath() == vert_path) && (program->getShaders() == 2U);
+	};
+
+	// Depth pre-pass of the covered groups
+	const bool prepass = depth_prepass && !vert_path.empty() && !forward.empty();
+	if (prepass) {
+		view->use(depth_program);
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		if (first)
+			counter->begin(0U);
+
+		for (SceneModel *const &model : forward) {
+			GLSLProgram *program = model->getProgram();
+			program = ((program != nullptr) && program->isValid() ? program : SceneProgram::getDefault());
+			if (!covered(program))
+				continue;
+
+			GLSLProgram *const depth = depth_program;
+			model->draw(depth, [depth](const Material *const material) {
+				return (material->isAlphaTested() ? nullptr : depth);
+			});
+		}
+
+		if (first)
+			counter->end();
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glDepthFunc(GL_LEQUAL);
+	}
+
+	// Draw models, only the visible fragments pass the depth test after the pre-pass. The covered groups are drawn first so that the counters compare the same draws
+	for (const bool counted : {true, false}) {
+		if (first && counted)
+			counter->begin(1U);
+
+		for (SceneModel *const &model : forward) {
 			// Get the correct program
 			GLSLProgram *program = model->getProgram();
 			program = ((program != nullptr) && program->isValid() ? program : SceneProgram::getDefault());
+			const bool cover = covered(program);
+			if (counted && !cover)
+				continue;
+			prepare(program);
+
+			// Draw model with the variant of each material group of the pass, the blended ones are drawn in the transparent pass
+			const bool skip = blended && program->supports("TRANSPARENCY");
+			model->draw(program, [&prepare, &light_defines, program, skip, cover, counted](const Material *const material) -> GLSLProgram * {
+				if ((skip && material->isTransparent()) || ((cover && !material->isAlphaTested()) != counted))
+					return nullptr;
+
+				GLSLProgram *const variant = program->getVariant(light_defines + material->getDefines());
+				prepare(variant);
+				return variant;
+			});
+		}
 
-			// Use camera
-			camera->use(program);
+		if (first && counted)
+			counter->end();
+	}
+	glDepthFunc(GL_LESS);
 
-			// Set the number of lights
-			program->use();
-			program->setUniform("light_size", SceneLight::getNumberOfLights());
 
-			// Update lights
-			for (SceneLight *const &light : light_stock)
-				light->use(program);
+	// Stream the streamed models for the first view and draw their resident chunks visible in each one
+	SceneProgram *const program = SceneProgram::getDefault();
+	if (!stream_stock.empty() && program->isValid()) {
+		view->use(program);
+		light_grid->bind(program);
 
-			// Draw model
+		for (StreamModel *const &model : stream_stock) {
+			if (first)
+				model->update(view);
+			else
+				model->cull(view);
 			model->draw(program);
 		}
 	}
 
-
 	// Draw lights models
 	for (const SceneLight *const &light : light_stock)
 		light->draw();
+
+	// Blend the transparent material groups over the opaque models, the weighted average does not need any sorting
+	if (!blended)
+		return;
+
+	std::vector<std::pair<SceneModel *, GLSLProgram *> > transparent;
+	for (SceneModel *const &model : enabled) {
+		GLSLProgram *program = model->getProgram();
+		program = ((program != nullptr) && program->isValid() ? program : SceneProgram::getDefault());
+		if (program->supports("TRANSPARENCY") && model->isTransparent())
+			transparent.emplace_back(model, program);
+	}
+
+	if (transparent.empty())
+		return;
+
+	transparency->begin();
+	for (const std::pair<SceneModel *, GLSLProgram *> &entry : transparent) {
+		GLSLProgram *const program = entry.second;
+		entry.first->draw(program, [&prepare, &light_defines, program](const Material *const material) -> GLSLProgram * {
+			if (!material->isTransparent())
+				return nullptr;
+
+			GLSLProgram *const variant = program->getVariant(light_defines + "#define TRANSPARENCY\n" + material->getDefines());
+			prepare(variant);
+			return variant;
+		});
+	}
+	transparency->composite(transparency_program);
+}
+
+// Get the cameras of the views and their viewports, the selected camera first and the others in a grid of two columns
+void Scene::getViews(std::vector<SceneCamera *> &cameras, std::vector<glm::ivec4> &viewports) const {
+	cameras.clear();
+	viewports.clear();
+	if (camera == nullptr)
+		return;
+
+	cameras.push_back(camera);
+	if (split_screen) {
+		for (SceneCamera *const &cam : camera_stock) {
+			if (cameras.size() == Scene::VIEWS)
+				break;
+			if (cam != camera)
+				cameras.push_back(cam);
+		}
+	}
+
+	// Rows from the top of the window
+	const int count = (int)cameras.size();
+	const int cols = std::min(count, 2);
+	const int rows = (count + cols - 1) / cols;
+	for (int i = 0; i < count; i++) {
+		const int col = i % cols;
+		const int row = i / cols;
+		const int x0 = width * col / cols;
+		const int x1 = width * (col + 1) / cols;
+		const int y0 = height - height * (row + 1) / rows;
+		const int y1 = height - height * row / rows;
+		viewports.push_back(glm::ivec4(x0, y0, std::max(x1 - x0, 1), std::max(y1 - y0, 1)));
+	}
+}
+
+// Set the resolution of the cameras to their viewports, the cameras out of the views keep the window one
+void Scene::layoutViews() {
+	for (SceneCamera *const &cam : camera_stock)
+		cam->setResolution(width, height);
+
+	std::vector<SceneCamera *> cameras;
+	std::vector<glm::ivec4> viewports;
+	getViews(cameras, viewports);
+	for (std::size_t i = 0U; i < cameras.size(); i++)
+		cameras[i]->setResolution(viewports[i].z, viewports[i].w);
 }
 
 // Draw GUI
 void Scene::drawGUI() {
+	// Count the frame drawn since the last change
+	if (redraw_frames > 0U)
+		redraw_frames--;
+
 	// Check the visibility of all windows
 	if (!show_gui && !show_about && !show_about_gui && !show_metrics)
 		return;
@@ -1093,44 +2225,196 @@ void Scene::showMetrics(const bool &status) {
     focus_scene = show_gui;
 }
 
+// Draw the next frames, the GUI needs some of them to settle after an input
+void Scene::requestRedraw() {
+	redraw_frames = Scene::REDRAW_FRAMES;
+}
+
 
 // Link scene model to scene program
-void Scene::link(const std::size_t &model, const std::size_t &program) {
-	// Get the scene program
-	SceneProgram *scene_program = *std::next(program_stock.begin());
+void Scene::link(const Scene::ModelHandle &model, const Scene::ProgramHandle &program) {
+	// Get the scene model and program
+	SceneModel *const scene_model = getModel(model);
+	SceneProgram *const scene_program = getProgram(program);
+	if ((scene_model == nullptr) || (scene_program == nullptr))
+		return;
 
 	// Remove relations to the scene program
 	scene_program->removeAllRelated();
 
 	// Relate scene program to the scene model
-	scene_program->addRelated(*std::next(model_stock.begin(), model));
+	scene_program->addRelated(scene_model);
 }
 
 // Reload all scene program
 void Scene::reloadPrograms() {
+	// Read the sources again
+	ShaderPreprocessor::clear();
+
 	for (SceneProgram *const &program : program_stock)
 		program->reload();
 }
 
 
-// Select camera by index
-void Scene::selectCamera(const std::size_t &index) {
-	camera = *std::next(camera_stock.begin(), index);
+// Select camera by handle
+void Scene::selectCamera(const Scene::CameraHandle &handle) {
+	SceneCamera *const *const selected = camera_stock.find(handle);
+	if (selected != nullptr)
+		camera = *selected;
+	layoutViews();
+	requestRedraw();
 }
 
 // Apply zoom
 void Scene::zoom(const double &level) {
 	camera->zoom(level);
+	requestRedraw();
 }
 
-// Travell trhough scene
+// Start a fixed step of the camera travel from the position of the last one
+void Scene::stepCamera() {
+	syncTravel();
+	travel_previous = travel_current;
+}
+
+// Travell trhough scene during a fixed step, the camera is drawn where the interpolation puts it
 void Scene::travell(const Camera::Movement &direction) {
-	camera->move(direction, Scene::io->DeltaTime);
+	syncTravel();
+	camera->setPosition(travel_current);
+	camera->move(direction, FramePacer::STEP);
+	travel_current = camera->getPosition();
+	camera->setPosition(travel_drawn);
+	requestRedraw();
+}
+
+// Place the camera between the last two steps, the alpha is the fraction of step not simulated yet
+void Scene::interpolateCamera(const double &alpha) {
+	syncTravel();
+
+	// Stopped, the camera stays at the last step instead of the last blend
+	if (travel_previous == travel_current) {
+		travel_drawn = travel_current;
+		camera->setPosition(travel_current);
+		return;
+	}
+
+	travel_drawn = glm::mix(travel_previous, travel_current, (float)alpha);
+	camera->setPosition(travel_drawn);
+}
+
+// Start the travel again from the camera place if it was selected or moved by other means
+void Scene::syncTravel() {
+	if ((camera == travel_camera) && (camera->getPosition() == travel_drawn))
+		return;
+
+	travel_camera = camera;
+	travel_previous = camera->getPosition();
+	travel_current = travel_previous;
+	travel_drawn = travel_previous;
+}
+
+
+// Add the current statistics of a model to the totals, replacing the counted ones
+void Scene::countModel(const SceneModel *const model) {
+	uncountModel(model);
+
+	Scene::model_stats &counted = model_counted[model];
+	counted.polygons = model->Model::getPolygons();
+	counted.vertices = model->Model::getVertices();
+	counted.elements = model->Model::getElements();
+	counted.materials = model->Model::getMaterials();
+	counted.textures = model->Model::getTextures();
+	counted.clusters = model->Model::getClusters();
+	counted.memory = model->Model::getMemory();
+
+	model_totals.polygons += counted.polygons;
+	model_totals.vertices += counted.vertices;
+	model_totals.elements += counted.elements;
+	model_totals.materials += counted.materials;
+	model_totals.textures += counted.textures;
+	model_totals.clusters += counted.clusters;
+	model_totals.memory += counted.memory;
+
+	// The materials may have changed too
+	material_list.dirty = true;
+}
+
+// Remove the counted statistics of a model from the totals
+void Scene::uncountModel(const SceneModel *const model) {
+	const std::unordered_map<const SceneModel *, Scene::model_stats>::const_iterator counted = model_counted.find(model);
+	if (counted == model_counted.end())
+		return;
+
+	model_totals.polygons -= counted->second.polygons;
+	model_totals.vertices -= counted->second.vertices;
+	model_totals.elements -= counted->second.elements;
+	model_totals.materials -= counted->second.materials;
+	model_totals.textures -= counted->second.textures;
+	model_totals.clusters -= counted->second.clusters;
+	model_totals.memory -= counted->second.memory;
+	model_counted.erase(counted);
+}
+
+// Draw a filtered list of labels clipped to the visible rows and return true if the selection changed
+bool Scene::drawListGUI(const char *const id, Scene::list_data &list, const std::size_t &size, const std::function<const std::string &(const std::size_t &)> &label, std::size_t &selected) {
+	ImGui::PushID(id);
+
+	// The rows passing the filter are searched again only when it or the list changes
+	if (list.filter.Draw("Filter", 300.0F) || list.dirty || (list.size != size)) {
+		list.row.clear();
+		if (list.filter.IsActive())
+			for (std::size_t i = 0U; i < size; i++)
+				if (list.filter.PassFilter(label(i).c_str()))
+					list.row.push_back(i);
+
+		list.size = size;
+		list.dirty = false;
+	}
+	Scene::HelpMarker("Comma separated terms, the\nones starting with - exclude");
+
+	// Rows in a child window of fixed height
+	const std::size_t rows = (list.filter.IsActive() ? list.row.size() : size);
+	const float height = (float)std::max<std::size_t>(std::min(rows, Scene::LIST_ROWS), 1U) * ImGui::GetTextLineHeightWithSpacing() + 2.0F * ImGui::GetStyle().WindowPadding.y;
+	ImGui::BeginChild("rows", ImVec2(0.0F, height), true);
+
+	// Draw only the visible rows, the ID of each one is its index
+	bool changed = false;
+	ImGuiListClipper clipper((int)rows, ImGui::GetTextLineHeightWithSpacing());
+	while (clipper.Step())
+		for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+			const std::size_t i = (list.filter.IsActive() ? list.row[row] : (std::size_t)row);
+			if (i >= size)
+				continue;
+
+			ImGui::PushID((int)i);
+			if (ImGui::Selectable(label(i).c_str(), i == selected) && (i != selected)) {
+				selected = i;
+				changed = true;
+			}
+			ImGui::PopID();
+		}
+
+	ImGui::EndChild();
+	ImGui::PopID();
+
+	return changed;
+}
+
+// Tree node title of a stock element, built again only when its label changes
+const char *Scene::getTitle(const void *const element, const std::string &label, const std::string &tag, const std::uint32_t &id) {
+	Scene::title_data &cached = gui_title[element];
+	if (cached.title.empty() || (cached.label != label)) {
+		cached.label = label;
+		cached.title = label + tag + std::to_string(id);
+	}
+
+	return cached.title.c_str();
 }
 
 // Look around
 void Scene::lookAround(const double &xpos, const double &ypos) {
 	camera->rotate(mouse->translate(xpos, ypos));
+	requestRedraw();
 }
 
 // Update the mouse position
@@ -1140,126 +2424,159 @@ void Scene::setTranslationPoint(const double &xpos, const double &ypos) {
 
 
 // Push a new camera
-std::size_t Scene::pushCamera(const bool &ortho) {
+Scene::CameraHandle Scene::pushCamera(const bool &ortho) {
 	// Store the camera
     SceneCamera *const new_camera = new SceneCamera(width, height, ortho);
-	camera_stock.push_back(new_camera);
+	const Scene::CameraHandle handle = camera_stock.insert(new_camera);
 
 	// Select new camera if is the only one
-	const std::size_t index = camera_stock.size() - 1;
-	if (camera_stock.size() == 0)
+	if (camera_stock.size() == 1U)
 		camera = new_camera;
 
-	return index;
+	layoutViews();
+	return handle;
 }
 
 // Push a new light
-std::size_t Scene::pushLight(const Light::Type &type) {
+Scene::LightHandle Scene::pushLight(const Light::Type &type) {
     // Add light if the stock is not full
     if (light_stock.size() < Scene::LIGHTS)
-        light_stock.push_back(new SceneLight(type));
+        return light_stock.insert(new SceneLight(type));
 
     // If the stock is full
-    else
-        std::cerr << "error: the light stock is full" << std::endl;
-
-	return light_stock.size() - 1;
+    std::cerr << "error: the light stock is full" << std::endl;
+	return Scene::LightHandle();
 }
 
 // Push an empty scene model
-std::size_t Scene::pushModel() {
-    model_stock.push_back(new SceneModel(""));
-    return model_stock.size() - 1;
+Scene::ModelHandle Scene::pushModel() {
+    SceneModel *const model = new SceneModel("");
+    countModel(model);
+    model_list.dirty = true;
+    return model_stock.insert(model);
 }
 
 // Push a new scene model and relate to a scene program
-std::size_t Scene::pushModel(const std::string &path, const std::size_t &program) {
+Scene::ModelHandle Scene::pushModel(const std::string &path, const Scene::ProgramHandle &program) {
 	// Store the new scene model
-	SceneModel *const model = new SceneModel(path);
-	model_stock.push_back(model);
+	SceneModel *const model = new SceneModel(path, nullptr, true);
+	const Scene::ModelHandle handle = model_stock.insert(model);
+	countModel(model);
+	model_list.dirty = true;
 
 	// Relate to the scene program
-	if (program != -1)
-		(*std::next(program_stock.begin(), program))->addRelated(model);
+	SceneProgram *const scene_program = getProgram(program);
+	if (scene_program != nullptr)
+		scene_program->addRelated(model);
 
-	return model_stock.size() - 1;
+	return handle;
 }
 
 // Push an empty scene program
-std::size_t Scene::pushProgram() {
-    program_stock.push_back(new SceneProgram());
-    return program_stock.size() - 1;
+Scene::ProgramHandle Scene::pushProgram() {
+    return program_stock.insert(new SceneProgram());
 }
 
 // Push a new scene program
-std::size_t Scene::pushProgram(const std::string &vert_path, const std::string &frag_path) {
-	program_stock.push_back(new SceneProgram(vert_path, frag_path));
-	return program_stock.size() - 1;
+Scene::ProgramHandle Scene::pushProgram(const std::string &vert_path, const std::string &frag_path) {
+	return program_stock.insert(new SceneProgram(vert_path, frag_path));
 }
 
 // Push a new scene program
-std::size_t Scene::pushProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path) {
-	program_stock.push_back(new SceneProgram(vert_path, geom_path, frag_path));
-	return program_stock.size() - 1;
+Scene::ProgramHandle Scene::pushProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path) {
+	return program_stock.insert(new SceneProgram(vert_path, geom_path, frag_path));
 }
 
 // Push a new scene program
-std::size_t Scene::pushProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path) {
-	program_stock.push_back(new SceneProgram(vert_path, tesc_path, tese_path, geom_path, frag_path));
-	return program_stock.size() - 1;
+Scene::ProgramHandle Scene::pushProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path) {
+	return program_stock.insert(new SceneProgram(vert_path, tesc_path, tese_path, geom_path, frag_path));
 }
 
 
 // Pop camera
-void Scene::popCamera(const std::size_t &index) {
-    // Return if is it only one camera
-    if (camera_stock.size() == 1)
+void Scene::popCamera(const Scene::CameraHandle &handle) {
+    // Return if is it only one camera or the handle is not valid
+    if ((camera_stock.size() == 1U) || !camera_stock.contains(handle))
         return;
 
 	// Get camera
-	std::list<SceneCamera *>::const_iterator old_camera = std::next(camera_stock.begin(), index);
+	const std::size_t position = camera_stock.getPosition(handle);
+	SceneCamera *const old_camera = camera_stock[position];
 
-	// Update the selected camera if it is to be deleted
-	if (camera == *old_camera)
-		camera = *std::next(old_camera, (*old_camera != *camera_stock.rbegin() ? 1 : -1));
+	// Delete camera and remove from stock, scene graph and titles, the selection is checked before the pointer dangles
+	const bool selected = (camera == old_camera);
+	graph->detach(old_camera);
+	gui_title.erase(old_camera);
+	delete old_camera;
+	camera_stock.erase(handle);
 
-	// Delete camera and remove from list
-	delete *old_camera;
-	camera_stock.erase(old_camera);
+	// Update the selected camera if it was deleted, the last camera took its place
+	if (selected)
+		camera = camera_stock[std::min(position, camera_stock.size() - 1U)];
+
+	layoutViews();
 }
 
-// Pop scene light by index
-void Scene::popLight(const std::size_t &index) {
-	// Get program
-	std::list<SceneLight *>::const_iterator light = std::next(light_stock.begin(), index);
+// Pop scene light by handle
+void Scene::popLight(const Scene::LightHandle &handle) {
+	// Get light
+	SceneLight *const *const light = light_stock.find(handle);
+	if (light == nullptr)
+		return;
 
-	// Delete light and remove from list
+	// Delete light and remove from stock, scene graph and titles
+	graph->detach(*light);
+	gui_title.erase(*light);
 	delete *light;
-	light_stock.erase(light);
+	light_stock.erase(handle);
 }
 
-// Pop scene model by index
-void Scene::popModel(const std::size_t &index) {
+// Pop scene model by handle
+void Scene::popModel(const Scene::ModelHandle &handle) {
 	// Get model
-	std::list<SceneModel *>::const_iterator model = std::next(model_stock.begin(), index);
+	SceneModel *const *const model = model_stock.find(handle);
+	if (model == nullptr)
+		return;
 
 	// Update program
     if ((*model)->getProgram() != nullptr)
 	    (*model)->getProgram()->removeRelated(*model);
 
-	// Delete model and remove from list
+	// Delete model and remove from stock, scene graph and statistics
+	graph->detach(*model);
+	uncountModel(*model);
+	model_list.dirty = true;
 	delete *model;
-	model_stock.erase(model);
+	model_stock.erase(handle);
+}
+
+// Push streamed model
+Scene::StreamModelHandle Scene::pushStreamModel(const std::string &path) {
+	return stream_stock.insert(new StreamModel(path));
 }
 
-// Pop scene program by index
-void Scene::popProgram(const std::size_t &index) {
+// Pop streamed model by handle
+void Scene::popStreamModel(const Scene::StreamModelHandle &handle) {
+	StreamModel *const *const model = stream_stock.find(handle);
+	if (model == nullptr)
+		return;
+
+	gui_title.erase(*model);
+	delete *model;
+	stream_stock.erase(handle);
+}
+
+// Pop scene program by handle
+void Scene::popProgram(const Scene::ProgramHandle &handle) {
 	// Get program
-	std::list<SceneProgram *>::const_iterator program = std::next(program_stock.begin(), index);
+	SceneProgram *const *const program = program_stock.find(handle);
+	if (program == nullptr)
+		return;
 
-	// Delete and remove from list
+	// Delete and remove from stock and titles
+	gui_title.erase(*program);
 	delete *program;
-	program_stock.erase(program);
+	program_stock.erase(handle);
 }
 
 
@@ -1271,10 +2588,18 @@ void Scene::setResolution(const int &width_res, const int &height_res) {
 
 	// Set resolution to mouse
 	mouse->setResolution(width, height);
+	requestRedraw();
 
-	// Set resolution to all cameras
-	for (Camera *const &cam : camera_stock)
-		cam->setResolution(width, height);
+	// Set resolution to all cameras, or to their viewports in split screen
+	layoutViews();
+
+	// Resize the G-buffer
+	if (gbuffer != nullptr)
+		gbuffer->setResolution(width, height);
+
+	// Resize the transparency targets
+	if (transparency != nullptr)
+		transparency->setResolution(width, height);
 }
 
 // Set the background color
@@ -1283,6 +2608,83 @@ void Scene::setBackground(const glm::vec3 &color) {
 	glClearColor(background.r, background.g, background.b, 1.0F);
 }
 
+// Use the deferred or the forward renderer, the G-buffer only exists with the deferred one
+void Scene::setDeferred(const bool &status) {
+	if (status == (gbuffer != nullptr))
+		return;
+
+	if (status && !deferred_support) {
+		std::cerr << "warning: the deferred renderer needs a 24 bits depth and 8 bits stencil framebuffer" << std::endl;
+		return;
+	}
+
+	delete gbuffer;
+	gbuffer = (status ? new GBuffer(width, height) : nullptr);
+}
+
+// Set the depth pre-pass status
+void Scene::setDepthPrepass(const bool &status) {
+	depth_prepass = status;
+}
+
+// Set the occlusion culling status
+void Scene::setOcclusionCulling(const bool &status) {
+	occlusion_culling = status;
+}
+
+// Set the shadow mapping status, the shadow maps only exist with it
+void Scene::setShadowMapping(const bool &status) {
+	if (status == (shadow_maps != nullptr))
+		return;
+
+	if (status && !shadow_support) {
+		std::cerr << "warning: the shadow maps need " << ShadowMaps::UNIT + 3U << " texture units" << std::endl;
+		return;
+	}
+
+	delete shadow_maps;
+	shadow_maps = (status ? new ShadowMaps() : nullptr);
+}
+
+// Set the on demand drawing status, without it every frame is drawn
+void Scene::setOnDemand(const bool &status) {
+	on_demand = status;
+	requestRedraw();
+}
+
+// Set the split screen status and fit the cameras to their viewports
+void Scene::setSplitScreen(const bool &status) {
+	split_screen = status;
+	layoutViews();
+	requestRedraw();
+}
+
+// Set the program of the depth pre-pass and the shadow maps, it must use the vertex shader of the shading programs
+void Scene::setDepthProgram(SceneProgram *const program) {
+	delete depth_program;
+	depth_program = program;
+}
+
+// Set the blended transparency status, without it the transparent materials are alpha tested
+void Scene::setTransparency(const bool &status) {
+	if (status == (transparency != nullptr))
+		return;
+
+	if (status && !transparency_support) {
+		std::cerr << "warning: the blended transparency needs a 24 bits depth and 8 bits stencil framebuffer" << std::endl;
+		return;
+	}
+
+	delete transparency;
+	transparency = (status ? new TransparencyBuffer(width, height) : nullptr);
+}
+
+// Set the program that blends the transparency targets over the opaque models, it must use the screen vertex shader
+void Scene::setTransparencyProgram(SceneProgram *const program) {
+	delete transparency_program;
+	transparency_program = program;
+}
+
 
 // Get the showing GUI status
 bool Scene::showingGUI() const {
@@ -1304,6 +2706,46 @@ bool Scene::showingMetrics() const {
     return show_metrics;
 }
 
+// Get the deferred renderer status
+bool Scene::isDeferred() const {
+	return gbuffer != nullptr;
+}
+
+// Get the blended transparency status
+bool Scene::isTransparency() const {
+	return transparency != nullptr;
+}
+
+// Get the depth pre-pass status
+bool Scene::isDepthPrepass() const {
+	return depth_prepass;
+}
+
+// Get the occlusion culling status
+bool Scene::isOcclusionCulling() const {
+	return occlusion_culling;
+}
+
+// Get the shadow mapping status
+bool Scene::isShadowMapping() const {
+	return shadow_maps != nullptr;
+}
+
+// Get the split screen status
+bool Scene::isSplitScreen() const {
+	return split_screen;
+}
+
+// Get the on demand drawing status
+bool Scene::isOnDemand() const {
+	return on_demand;
+}
+
+// Check if the last update found nothing to draw
+bool Scene::isIdle() const {
+	return idle;
+}
+
 
 // Get the resolution
 glm::ivec2 Scene::getResolution() const {
@@ -1326,47 +2768,73 @@ SceneCamera *Scene::getSelectedCamera() {
 	return camera;
 }
 
-// Get camera by index
-SceneCamera *Scene::getCamera(const std::size_t &index) const {
-	return *std::next(camera_stock.begin(), index);
+// Get camera by handle, null if it was removed
+SceneCamera *Scene::getCamera(const Scene::CameraHandle &handle) const {
+	SceneCamera *const *const scene_cam = camera_stock.find(handle);
+	return (scene_cam != nullptr ? *scene_cam : nullptr);
 }
 
-// Get scene light by index
-SceneLight *Scene::getLight(const std::size_t &index) const {
-	return *std::next(light_stock.begin(), index);
+// Get scene light by handle, null if it was removed
+SceneLight *Scene::getLight(const Scene::LightHandle &handle) const {
+	SceneLight *const *const light = light_stock.find(handle);
+	return (light != nullptr ? *light : nullptr);
 }
 
-// Get scene model by index
-SceneModel *Scene::getModel(const std::size_t &index) const {
-	return *std::next(model_stock.begin(), index);
+// Get scene model by handle, null if it was removed
+SceneModel *Scene::getModel(const Scene::ModelHandle &handle) const {
+	SceneModel *const *const model = model_stock.find(handle);
+	return (model != nullptr ? *model : nullptr);
 }
 
-// Get scene program by index
-SceneProgram *Scene::getProgram(const std::size_t &index) {
-	return *std::next(program_stock.begin(), index);
+// Get streamed model by handle, null if it was removed
+StreamModel *Scene::getStreamModel(const Scene::StreamModelHandle &handle) const {
+	StreamModel *const *const model = stream_stock.find(handle);
+	return (model != nullptr ? *model : nullptr);
+}
+
+// Get scene program by handle, null if it was removed
+SceneProgram *Scene::getProgram(const Scene::ProgramHandle &handle) const {
+	SceneProgram *const *const program = program_stock.find(handle);
+	return (program != nullptr ? *program : nullptr);
+}
+
+
+// Get the scene graph
+SceneGraph *Scene::getGraph() const {
+	return graph;
+}
+
+// Get the frame pacer
+FramePacer *Scene::getFramePacer() const {
+	return pacer;
 }
 
 
 // Get the camera stock
-const std::list<SceneCamera *> Scene::getCameraStock() const {
+const SlotMap<SceneCamera *> &Scene::getCameraStock() const {
 	return camera_stock;
 }
 
 // Get the scene light stock
-std::list<SceneLight *> Scene::getLightStock() const {
+const SlotMap<SceneLight *> &Scene::getLightStock() const {
 	return light_stock;
 }
 
 // Get the scene model stock
-std::list<SceneModel *> Scene::getModelStock() const {
+const SlotMap<SceneModel *> &Scene::getModelStock() const {
 	return model_stock;
 }
 
 // Get the scene program stock
-std::list<SceneProgram *> Scene::getProgramStock() const {
+const SlotMap<SceneProgram *> &Scene::getProgramStock() const {
 	return program_stock;
 }
 
+// Get the streamed model stock
+const SlotMap<StreamModel *> &Scene::getStreamModelStock() const {
+	return stream_stock;
+}
+
 
 // Load the ImGuiIO pointer
 void Scene::loadImGuiIO() {
@@ -1375,8 +2843,26 @@ void Scene::loadImGuiIO() {
 
 // Scene destructor
 Scene::~Scene() {
-	// Delete mouse
+	// Cancel the conversion, its temporary files are removed
+	if (converter.joinable()) {
+		convert_cancel = true;
+		converter.join();
+	}
+
+	// Delete mouse, light clusters and watcher
 	delete mouse;
+	delete light_grid;
+	delete gbuffer;
+	delete transparency;
+	delete transparency_program;
+	delete shadow_maps;
+	delete timer;
+	delete depth_program;
+	delete counter;
+	delete occlusion;
+	delete watcher;
+	delete graph;
+	delete pacer;
 
 	// Delete all cameras and clear camera stock
 	for (const Camera *const &cam : camera_stock)
@@ -1390,6 +2876,10 @@ Scene::~Scene() {
 	for (const SceneModel *const &model : model_stock)
 		delete model;
 
+	// Delete all streamed models
+	for (const StreamModel *const &model : stream_stock)
+		delete model;
+
 	// Delete all programs and clear camera stock
 	for (const SceneProgram *const &program : program_stock)
 		delete program;
@@ -6,15 +6,70 @@
 #include "scenemodel.hpp"
 #include "scenelight.hpp"
 #include "sceneprogram.hpp"
+#include "scenegraph.hpp"
+#include "../streammodel.hpp"
+#include "../filewatcher.hpp"
+#include "../lightgrid.hpp"
+#include "../gbuffer.hpp"
+#include "../transparencybuffer.hpp"
+#include "../gputimer.hpp"
+#include "../samplecounter.hpp"
+#include "../occlusionbuffer.hpp"
+#include "../shadowmaps.hpp"
+#include "../framepacer.hpp"
+#include "../slotmap.hpp"
 
 #include "../imgui/imgui.h"
 
 #include <glm/glm.hpp>
 
-#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 class Scene {
+	public:
+		// Stable handles of the stocks elements
+		typedef SlotMap<SceneCamera *>::Handle CameraHandle;
+		typedef SlotMap<SceneLight *>::Handle LightHandle;
+		typedef SlotMap<SceneModel *>::Handle ModelHandle;
+		typedef SlotMap<SceneProgram *>::Handle ProgramHandle;
+		typedef SlotMap<StreamModel *>::Handle StreamModelHandle;
+
+		// Maximum number of lights
+		static constexpr const std::size_t LIGHTS = 1024;
+
 	private:
+		// Statistics of a model, or their totals
+		struct model_stats {
+			std::size_t polygons;
+			std::size_t vertices;
+			std::size_t elements;
+			std::size_t materials;
+			std::size_t textures;
+			std::size_t clusters;
+			std::size_t memory;
+		};
+
+		// Tree node title of a stock element and the label it was built with
+		struct title_data {
+			std::string label;
+			std::string title;
+		};
+
+		// Filter of a virtualized list, the rows passing it and the list size they were searched in
+		struct list_data {
+			ImGuiTextFilter filter;
+			std::vector<std::size_t> row;
+			std::size_t size;
+			bool dirty;
+		};
+
 		// Resolution
 		int width;
 		int height;
@@ -23,6 +78,9 @@ class Scene {
 		Mouse *mouse;
         SceneCamera *camera;
 
+        // Split screen status, the other cameras are drawn next to the selected one
+        bool split_screen;
+
 		// Scene background
 		glm::vec3 background;
 
@@ -38,15 +96,106 @@ class Scene {
 
 
 		// Stocks
-		std::list<SceneCamera *> camera_stock;
-		std::list<SceneLight *> light_stock;
-		std::list<SceneModel *> model_stock;
-		std::list<SceneProgram *> program_stock;
+		SlotMap<SceneCamera *> camera_stock;
+		SlotMap<SceneLight *> light_stock;
+		SlotMap<SceneModel *> model_stock;
+		SlotMap<SceneProgram *> program_stock;
+        SlotMap<StreamModel *> stream_stock;
+
+        // Streamed models paths and conversion thread, the chunks path and error are read when it is done
+        std::string convert_path;
+        std::string stream_path;
+        std::thread converter;
+        std::string convert_output;
+        std::string convert_error;
+        std::atomic<bool> convert_cancel;
+        std::atomic<bool> convert_done;
+
+        // Session file path and JSON mirror status
+        std::string session_path;
+        bool session_json;
+
+        // Clusters of the point and spot lights
+        LightGrid *light_grid;
+
+        // G-buffer of the deferred renderer, null with the forward one, and its support
+        GBuffer *gbuffer;
+        bool deferred_support;
+
+        // Targets of the blended transparency, null when the transparent materials are alpha tested, their composite program and support
+        TransparencyBuffer *transparency;
+        SceneProgram *transparency_program;
+        bool transparency_support;
+
+        // Shadow maps of the lights, null without shadows, and their support
+        ShadowMaps *shadow_maps;
+        bool shadow_support;
+
+        // Timestamps of the shadow, geometry, lighting and forward passes
+        GPUTimer *timer;
+
+        // Depth pre-pass program and status, and front to back sorting status
+        SceneProgram *depth_program;
+        bool depth_prepass;
+        bool front_to_back;
+
+        // Samples of the depth pre-pass and the forward shading pass
+        SampleCounter *counter;
+
+        // Occluders depth in the CPU, and the culling and debug view status
+        OcclusionBuffer *occlusion;
+        bool occlusion_culling;
+        bool show_occlusion;
+
+        // Watcher of the assets files and time of the last paths update
+        FileWatcher *watcher;
+        std::chrono::steady_clock::time_point watch_time;
+
+        // Hierarchy of transformations of the models, lights and cameras
+        SceneGraph *graph;
+
+        // On demand drawing status, frames left to draw since the last change, and idle status of the last update
+        bool on_demand;
+        std::size_t redraw_frames;
+        bool idle;
+
+        // Frame rate limit, swap interval and fixed steps of the camera movement
+        FramePacer *pacer;
+
+        // Totals of the models statistics and the values counted for each model, updated when they change
+        Scene::model_stats model_totals;
+        std::unordered_map<const SceneModel *, Scene::model_stats> model_counted;
+
+        // Polygons submitted in the last frame and shaders of the programs in stock
+        mutable std::size_t submitted_polygons;
+        unsigned int shaders;
+
+        // Cached tree node titles of the stocks elements
+        std::unordered_map<const void *, Scene::title_data> gui_title;
+
+        // Lists of the models and the materials of the selected model, and their selections
+        Scene::list_data model_list;
+        Scene::list_data material_list;
+        Scene::ModelHandle selected_model;
+        std::size_t selected_material;
+
+        // Camera moved by the fixed steps, its position in the last two steps and the drawn one
+        const SceneCamera *travel_camera;
+        glm::vec3 travel_previous;
+        glm::vec3 travel_current;
+        glm::vec3 travel_drawn;
 
 		// Disable copy and assignation
 		Scene(const Scene &) = delete;
 		Scene &operator = (const Scene &) = delete;
 
+        // Draw the scene from a camera in its viewport
+        void drawView(const SceneCamera *const view, const glm::ivec2 &origin, std::vector<SceneModel *> enabled, const std::vector<glm::vec4> &lights, const std::size_t &directional, const bool &shadows, const bool &first) const;
+
+        // Cameras of the views and their viewports, and the resolution of each camera set to its viewport
+        void getViews(std::vector<SceneCamera *> &cameras, std::vector<glm::ivec4> &viewports) const;
+        void layoutViews();
+
         // Draw the about window
         void drawSettingsWindow();
         void drawAboutWindow();
@@ -56,11 +205,39 @@ class Scene {
         bool drawModelGUI(SceneModel *const model);
         bool drawLightGUI(SceneLight *const light);
         bool drawProgramGUI(SceneProgram *const program, const bool &removable = true);
+        bool drawStreamModelGUI(StreamModel *const model);
+        bool drawNodeGUI(const SceneGraph::Node &id, SceneGraph::Node &parent, bool &add_child);
+
+        // Check for work in progress that shows as it arrives
+        bool isBusy() const;
+
+        // Start the travel again from the camera place if it was selected or moved by other means
+        void syncTravel();
+
+        // Add the current statistics of a model to the totals, replacing the counted ones
+        void countModel(const SceneModel *const model);
+        void uncountModel(const SceneModel *const model);
+
+        // Filtered list of labels that draws only its visible rows
+        bool drawListGUI(const char *const id, Scene::list_data &list, const std::size_t &size, const std::function<const std::string &(const std::size_t &)> &label, std::size_t &selected);
+
+        // Tree node title of a stock element, built again only when its label changes
+        const char *getTitle(const void *const element, const std::string &label, const std::string &tag, const std::uint32_t &id);
+
+        // Publish the result of the finished conversion
+        void updateConversion();
+
+        // Watch the assets paths and reload the changed ones
+        void watchAssets();
+        void reloadAssets(const std::vector<std::string> &paths);
 
         // Program combo
         void drawProgramComboGUI(SceneModel *const model, const bool &light = false);
         void drawProgramComboItemGUI(SceneModel *const model, SceneProgram *const current, SceneProgram *const program, const bool &light);
 
+        // Scene graph node combo
+        SceneGraph::Node drawNodeComboGUI(const char *const title, const SceneGraph::Node &current, const SceneGraph::Node &exclude = SceneGraph::NONE);
+
 		// Static attributes
         static ImGuiIO *io;
         static char URL[];
@@ -68,11 +245,17 @@ class Scene {
 		// Static const attributes
 		static const std::string CAMERA_ID_TAG;
         static const std::string MODEL_ID_TAG;
+        static const std::string STREAM_ID_TAG;
         static const std::string MATERIAL_ID_TAG;
         static const std::string TEXTURE_ID_TAG;
         static const std::string LIGHT_ID_TAG;
         static const std::string PROGRAM_ID_TAG;
-        static constexpr const std::size_t LIGHTS = 5;
+        static const std::string NODE_ID_TAG;
+        static constexpr const double WATCH_INTERVAL = 0.5;
+        static constexpr const std::size_t REDRAW_FRAMES = 3U;
+        static constexpr const std::size_t LIST_ROWS = 10U;
+        static constexpr const std::size_t VIEWS = 4U;
+        static constexpr const std::size_t NO_SELECTION = ~(std::size_t)0U;
 		static constexpr const ImGuiWindowFlags GUI_FLAGS = ImGuiWindowFlags_NoResize |
 															ImGuiWindowFlags_NoMove |
 															ImGuiWindowFlags_NoBringToFrontOnFocus;
@@ -84,6 +267,7 @@ class Scene {
 	public:
 		Scene(const int &width_res, const int &height_res);
 
+		void update();
 		void draw() const;
 		void drawGUI();
 
@@ -91,56 +275,82 @@ class Scene {
         void showAbout(const bool &status);
         void showAboutGUI(const bool &status);
 		void showMetrics(const bool &status);
+		void requestRedraw();
 
-		void link(const std::size_t &model, const std::size_t &program);
+		void link(const Scene::ModelHandle &model, const Scene::ProgramHandle &program);
 		void reloadPrograms();
 
-		void selectCamera(const std::size_t &index);
+		void selectCamera(const Scene::CameraHandle &handle);
 		void zoom(const double &level);
+		void stepCamera();
 		void travell(const Camera::Movement &direction);
+		void interpolateCamera(const double &alpha);
 		void lookAround(const double &xpos, const double &ypos);
 
         void setTranslationPoint(const double &xpos, const double &ypos);
 
-		std::size_t pushCamera(const bool &ortho = false);
-		std::size_t pushLight(const Light::Type &type = Light::DIRECTIONAL);
+		Scene::CameraHandle pushCamera(const bool &ortho = false);
+		Scene::LightHandle pushLight(const Light::Type &type = Light::DIRECTIONAL);
 
-        std::size_t pushModel();
-		std::size_t pushModel(const std::string &path, const std::size_t &program = -1);
+        Scene::ModelHandle pushModel();
+		Scene::ModelHandle pushModel(const std::string &path, const Scene::ProgramHandle &program = Scene::ProgramHandle());
 
-        std::size_t pushProgram();
-		std::size_t pushProgram(const std::string &vert_path, const std::string &frag_path);
-		std::size_t pushProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path);
-		std::size_t pushProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path);
+        Scene::ProgramHandle pushProgram();
+		Scene::ProgramHandle pushProgram(const std::string &vert_path, const std::string &frag_path);
+		Scene::ProgramHandle pushProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path);
+		Scene::ProgramHandle pushProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path);
+        Scene::StreamModelHandle pushStreamModel(const std::string &path);
 
-		void popCamera(const std::size_t &index);
-		void popLight(const std::size_t &index);
-		void popModel(const std::size_t &index);
-		void popProgram(const std::size_t &index);
+		void popCamera(const Scene::CameraHandle &handle);
+		void popLight(const Scene::LightHandle &handle);
+		void popModel(const Scene::ModelHandle &handle);
+		void popProgram(const Scene::ProgramHandle &handle);
+		void popStreamModel(const Scene::StreamModelHandle &handle);
 
 		void setResolution(const int &width_res, const int &height_res);
 		void setBackground(const glm::vec3 &color);
+		void setDeferred(const bool &status);
+		void setDepthPrepass(const bool &status);
+		void setDepthProgram(SceneProgram *const program);
+		void setOcclusionCulling(const bool &status);
+		void setShadowMapping(const bool &status);
+		void setTransparency(const bool &status);
+		void setTransparencyProgram(SceneProgram *const program);
+		void setOnDemand(const bool &status);
+		void setSplitScreen(const bool &status);
 
 
 		bool showingGUI() const;
         bool showingAbout() const;
         bool showingAboutGUI() const;
 		bool showingMetrics() const;
+		bool isDeferred() const;
+		bool isDepthPrepass() const;
+		bool isOcclusionCulling() const;
+		bool isShadowMapping() const;
+		bool isTransparency() const;
+		bool isOnDemand() const;
+		bool isIdle() const;
+		bool isSplitScreen() const;
 
 		glm::ivec2 getResolution() const;
 		glm::vec3 getBacground() const;
 
 		Mouse *getMouse() const;
+		SceneGraph *getGraph() const;
+		FramePacer *getFramePacer() const;
         SceneCamera *getSelectedCamera();
-        SceneCamera *getCamera(const std::size_t &index) const;
-		SceneLight *getLight(const std::size_t &index) const;
-		SceneModel *getModel(const std::size_t &index) const;
-		SceneProgram *getProgram(const std::size_t &index); const
-
-		std::list<SceneCamera *> getCameraStock() const;
-		std::list<SceneLight *> getLightStock() const;
-		std::list<SceneModel *> getModelStock() const;
-		std::list<SceneProgram *> getProgramStock() const;
+        SceneCamera *getCamera(const Scene::CameraHandle &handle) const;
+		SceneLight *getLight(const Scene::LightHandle &handle) const;
+		SceneModel *getModel(const Scene::ModelHandle &handle) const;
+		StreamModel *getStreamModel(const Scene::StreamModelHandle &handle) const;
+		SceneProgram *getProgram(const Scene::ProgramHandle &handle) const;
+
+		const SlotMap<SceneCamera *> &getCameraStock() const;
+		const SlotMap<SceneLight *> &getLightStock() const;
+		const SlotMap<SceneModel *> &getModelStock() const;
+		const SlotMap<SceneProgram *> &getProgramStock() const;
+		const SlotMap<StreamModel *> &getStreamModelStock() const;
 
 
         static void loadImGuiIO();
@@ -0,0 +1,927 @@
+#include "scenefile.hpp"
+
+#include <type_traits>
+#include <unordered_map>
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <memory>
+
+// Static const definitions
+constexpr const std::uint32_t SceneFile::MAGIC;
+constexpr const std::uint32_t SceneFile::VERSION;
+constexpr const std::uint32_t SceneFile::NONE;
+constexpr const std::size_t SceneFile::TEXTURES;
+constexpr const std::size_t SceneFile::SHADERS;
+
+
+// Take the state of the scene, the elements reference the programs and nodes by their index
+void SceneFile::collect(Scene *const scene, SceneFile::scene_data &data) {
+    // Scene settings
+    data.background = scene->getBacground();
+    data.deferred = scene->isDeferred();
+    data.depth_prepass = scene->isDepthPrepass();
+    data.occlusion_culling = scene->isOcclusionCulling();
+    data.shadow_mapping = scene->isShadowMapping();
+
+    // Scene graph nodes in depth first order, so the parents are stored before their children
+    SceneGraph *const graph = scene->getGraph();
+    std::unordered_map<SceneGraph::Node, std::uint32_t> node_index;
+    data.node.resize(graph->getNodes());
+    for (std::size_t i = 0U; i < graph->getNodes(); i++) {
+        const SceneGraph::Node id = graph->getID(i);
+        const SceneGraph::Node parent = graph->getParent(id);
+        node_index[id] = (std::uint32_t)i;
+
+        SceneFile::node_data &node = data.node[i];
+        node.label = graph->getLabel(id);
+        node.parent = (parent != SceneGraph::NONE ? node_index[parent] : SceneFile::NONE);
+        node.position = graph->getPosition(id);
+        node.rotation = graph->getRotationQuaternion(id);
+        node.scale = graph->getScale(id);
+    }
+
+    // Index of the node of an element
+    const auto node_of = [&node_index](const SceneGraph::Node &id) {
+        return (id != SceneGraph::NONE ? node_index[id] : SceneFile::NONE);
+    };
+
+    // Programs
+    const SlotMap<SceneProgram *> &program_stock = scene->getProgramStock();
+    std::unordered_map<const SceneProgram *, std::uint32_t> program_index;
+    data.program.resize(program_stock.size());
+    for (std::size_t i = 0U; i < program_stock.size(); i++) {
+        SceneProgram *const program = program_stock[i];
+        program_index[program] = (std::uint32_t)i;
+
+        SceneFile::program_data &saved = data.program[i];
+        saved.label = program->getLabel();
+        for (const GLenum type : {GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER})
+            saved.shader.push_back(program->getShaderPath(type));
+    }
+
+    // Cameras
+    const SlotMap<SceneCamera *> &camera_stock = scene->getCameraStock();
+    const SceneCamera *const selected = scene->getSelectedCamera();
+    data.selected_camera = 0U;
+    data.camera.resize(camera_stock.size());
+    for (std::size_t i = 0U; i < camera_stock.size(); i++) {
+        SceneCamera *const scene_cam = camera_stock[i];
+        if (scene_cam == selected)
+            data.selected_camera = (std::uint32_t)i;
+
+        SceneFile::camera_data &saved = data.camera[i];
+        saved.label = scene_cam->getLabel();
+        saved.orthogonal = scene_cam->isOrthogonal();
+        saved.position = scene_cam->getPosition();
+        saved.look = scene_cam->getLookDirection();
+        saved.up = scene_cam->getUp();
+        saved.fov = scene_cam->getFOV();
+        saved.clipping = scene_cam->getClipping();
+        saved.node = node_of(graph->getNode(scene_cam));
+    }
+
+    // Lights
+    const SlotMap<SceneLight *> &light_stock = scene->getLightStock();
+    data.light.resize(light_stock.size());
+    for (std::size_t i = 0U; i < light_stock.size(); i++) {
+        SceneLight *const light = light_stock[i];
+
+        SceneFile::light_data &saved = data.light[i];
+        saved.label = light->getLabel();
+        saved.type = light->getType();
+        saved.enabled = light->isEnabled();
+        saved.draw_model = light->drawingModel();
+        saved.cast_shadow = light->castingShadow();
+        saved.scale = light->getScale();
+        saved.position = light->getPosition();
+        saved.direction = light->getDirection();
+        saved.ambient = light->getAmbient();
+        saved.diffuse = light->getDiffuse();
+        saved.specular = light->getSpecular();
+        saved.ambient_level = light->getAmbientLevel();
+        saved.specular_level = light->getSpecularLevel();
+        saved.shininess = light->getShininess();
+        saved.attenuation = light->getAttenuation();
+        saved.cutoff = light->getCutoff();
+        saved.node = node_of(graph->getNode(light));
+    }
+
+    // Models, their program and material overrides
+    const SlotMap<SceneModel *> &model_stock = scene->getModelStock();
+    data.model.resize(model_stock.size());
+    for (std::size_t i = 0U; i < model_stock.size(); i++) {
+        SceneModel *const model = model_stock[i];
+        const std::unordered_map<const SceneProgram *, std::uint32_t>::const_iterator program = program_index.find(model->getProgram());
+
+        SceneFile::model_data &saved = data.model[i];
+        saved.label = model->getLabel();
+        saved.path = model->Model::getPath();
+        saved.program = (program != program_index.end() ? program->second : SceneFile::NONE);
+        saved.enabled = model->isEnabled();
+        saved.lock_scale = model->isScaleLocked();
+        saved.textures_enabled = model->isTexturesEnabled();
+        saved.show_normals = model->showingNormals();
+        saved.show_boundingbox = model->showingBoundingBox();
+        saved.cluster_culling = model->isClusterCulling();
+        saved.cone_culling = model->isConeCulling();
+        saved.position = model->getPosition();
+        saved.rotation = model->getRotationQuaternion();
+        saved.scale = model->getScale();
+        saved.node = node_of(graph->getNode(model));
+
+        SceneFile::collectMaterial(model->getGlobalMaterial(), saved.global);
+        for (SceneMaterial *const &material : model->getMaterialStock()) {
+            saved.material.push_back(SceneFile::material_data());
+            SceneFile::collectMaterial(material, saved.material.back());
+        }
+    }
+
+    // Streamed models
+    const SlotMap<StreamModel *> &stream_stock = scene->getStreamModelStock();
+    data.stream.resize(stream_stock.size());
+    for (std::size_t i = 0U; i < stream_stock.size(); i++) {
+        StreamModel *const model = stream_stock[i];
+
+        SceneFile::stream_data &saved = data.stream[i];
+        saved.path = model->getPath();
+        saved.budget = model->getBudget();
+        saved.position = model->getPosition();
+        saved.rotation = model->getRotationQuaternion();
+        saved.scale = model->getScale();
+    }
+}
+
+// Replace the scene elements, the models and textures are read in background by their own loaders
+void SceneFile::restore(Scene *const scene, const SceneFile::scene_data &data) {
+    // Remove the current elements, the last camera is removed when the new ones exist
+    while (!scene->getModelStock().empty())
+        scene->popModel(scene->getModelStock().getHandle(0U));
+    while (!scene->getStreamModelStock().empty())
+        scene->popStreamModel(scene->getStreamModelStock().getHandle(0U));
+    while (!scene->getLightStock().empty())
+        scene->popLight(scene->getLightStock().getHandle(0U));
+    while (!scene->getProgramStock().empty())
+        scene->popProgram(scene->getProgramStock().getHandle(0U));
+
+    std::vector<Scene::CameraHandle> old_camera;
+    for (std::size_t i = 0U; i < scene->getCameraStock().size(); i++)
+        old_camera.push_back(scene->getCameraStock().getHandle(i));
+
+    SceneGraph *const graph = scene->getGraph();
+    while (graph->getNodes() > 0U)
+        graph->pop(graph->getID(0U));
+
+    // Scene settings
+    scene->setBackground(data.background);
+    scene->setDeferred(data.deferred);
+    scene->setDepthPrepass(data.depth_prepass);
+    scene->setOcclusionCulling(data.occlusion_culling);
+    scene->setShadowMapping(data.shadow_mapping);
+
+    // Scene graph nodes, updated before attaching so the elements stay where they were saved
+    std::vector<SceneGraph::Node> node_id;
+    for (const SceneFile::node_data &saved : data.node) {
+        const SceneGraph::Node id = graph->push(saved.label, saved.parent != SceneFile::NONE ? node_id[saved.parent] : SceneGraph::NONE);
+        graph->setPosition(id, saved.position);
+        graph->setRotation(id, saved.rotation);
+        graph->setScale(id, saved.scale);
+        node_id.push_back(id);
+    }
+    graph->update();
+
+    // Node of an element
+    const auto node_of = [&node_id](const std::uint32_t &index) {
+        return (index != SceneFile::NONE ? node_id[index] : SceneGraph::NONE);
+    };
+
+    // Programs, compiled in the loader context when it is available
+    std::vector<Scene::ProgramHandle> program_handle;
+    for (const SceneFile::program_data &saved : data.program) {
+        const Scene::ProgramHandle handle = scene->pushProgram();
+        SceneProgram *const program = scene->getProgram(handle);
+        program_handle.push_back(handle);
+
+        const GLenum type[] = {GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER};
+        for (std::size_t i = 0U; i < SceneFile::SHADERS; i++)
+            program->getShaderPath(type[i]) = saved.shader[i];
+
+        // The reload replaces the label, so it is set again at the end
+        program->setLabel(saved.label);
+        if (!saved.shader[0].empty() && !saved.shader[SceneFile::SHADERS - 1U].empty()) {
+            const std::string label = saved.label;
+            program->reload([program, label]() {
+                program->setLabel(label);
+            });
+        }
+    }
+
+    // Cameras, the old ones are removed once the selected one exists
+    for (std::size_t i = 0U; i < data.camera.size(); i++) {
+        const SceneFile::camera_data &saved = data.camera[i];
+        const Scene::CameraHandle handle = scene->pushCamera(saved.orthogonal);
+        SceneCamera *const scene_cam = scene->getCamera(handle);
+
+        scene_cam->setLabel(saved.label);
+        scene_cam->setOrthogonal(saved.orthogonal);
+        scene_cam->setPosition(saved.position);
+        scene_cam->setLookDirection(saved.look);
+        scene_cam->setUp(saved.up);
+        scene_cam->setFOV(saved.fov);
+        scene_cam->setClipping(saved.clipping.x, saved.clipping.y);
+        graph->attach(scene_cam, node_of(saved.node));
+
+        if (i == data.selected_camera)
+            scene->selectCamera(handle);
+    }
+
+    for (const Scene::CameraHandle &handle : old_camera)
+        scene->popCamera(handle);
+
+    // Lights
+    for (const SceneFile::light_data &saved : data.light) {
+        SceneLight *const light = scene->getLight(scene->pushLight((Light::Type)saved.type));
+
+        light->setLabel(saved.label);
+        light->setEnabled(saved.enabled);
+        light->drawModel(saved.draw_model);
+        light->castShadow(saved.cast_shadow);
+        light->setScale(saved.scale);
+        light->setPosition(saved.position);
+        light->setDirection(saved.direction);
+        light->setAmbient(saved.ambient);
+        light->setDiffuse(saved.diffuse);
+        light->setSpecular(saved.specular);
+        light->setAmbientLevel(saved.ambient_level);
+        light->setSpecularLevel(saved.specular_level);
+        light->setShininess(saved.shininess);
+        light->setAttenuation(saved.attenuation);
+        light->setCutoff(saved.cutoff);
+        graph->attach(light, node_of(saved.node));
+    }
+
+    // Models, every one starts reading in its own thread before any of them finishes
+    for (const SceneFile::model_data &saved : data.model) {
+        const Scene::ProgramHandle program = (saved.program != SceneFile::NONE ? program_handle[saved.program] : Scene::ProgramHandle());
+        SceneModel *model = nullptr;
+        if (saved.path.empty()) {
+            model = scene->getModel(scene->pushModel());
+            if (program != Scene::ProgramHandle())
+                scene->getProgram(program)->addRelated(model);
+        }
+        else
+            model = scene->getModel(scene->pushModel(saved.path, program));
+
+        // Geometry and status
+        model->setLabel(saved.label);
+        model->setScaleLocked(saved.lock_scale);
+        model->setTexturesEnabled(saved.textures_enabled);
+        model->showNormals(saved.show_normals);
+        model->showBoundingBox(saved.show_boundingbox);
+        model->setClusterCulling(saved.cluster_culling);
+        model->setConeCulling(saved.cone_culling);
+        model->setPosition(saved.position);
+        model->setRotation(saved.rotation);
+        model->Model::setScale(saved.scale);
+        SceneFile::restoreMaterial(model->getGlobalMaterial(), saved.global);
+        graph->attach(model, node_of(saved.node));
+
+        // The materials exist once the loading finishes
+        const std::shared_ptr<const std::vector<SceneFile::material_data> > material = std::make_shared<const std::vector<SceneFile::material_data> >(saved.material);
+        const bool enabled = saved.enabled;
+        model->whenLoaded([model, material, enabled]() {
+            model->setEnabled(enabled && model->isOpen());
+            for (SceneMaterial *const &target : model->getMaterialStock())
+                for (const SceneFile::material_data &saved_material : *material)
+                    if (saved_material.name == target->getMaterial()->getName()) {
+                        SceneFile::restoreMaterial(target, saved_material);
+                        break;
+                    }
+        });
+    }
+
+    // Streamed models
+    for (const SceneFile::stream_data &saved : data.stream) {
+        StreamModel *const model = scene->getStreamModel(scene->pushStreamModel(saved.path));
+        model->setBudget((std::size_t)saved.budget);
+        model->setPosition(saved.position);
+        model->setRotation(saved.rotation);
+        model->setScale(saved.scale);
+    }
+}
+
+
+// Take the attributes and textures of a material
+void SceneFile::collectMaterial(SceneMaterial *const source, SceneFile::material_data &data) {
+    const Material *const material = source->getMaterial();
+
+    data.name = material->getName();
+    data.ambient_color = material->getAmbientColor();
+    data.diffuse_color = material->getDiffuseColor();
+    data.specular_color = material->getSpecularColor();
+    data.transmission_color = material->getTransmissionColor();
+    data.alpha = material->getAlpha();
+    data.sharpness = material->getSharpness();
+    data.shininess = material->getShininess();
+    data.roughness = material->getRoughness();
+    data.metalness = material->getMetalness();
+    data.refractive_index = material->getRefractiveIndex();
+
+    data.texture.clear();
+    for (unsigned int bit = Texture::AMBIENT; bit <= Texture::STENCIL; bit <<= 1U) {
+        const Texture *const texture = material->getTexture((Texture::Type)bit);
+        data.texture.push_back(texture != nullptr ? texture->getPath() : "");
+    }
+}
+
+// Apply the attributes of a material and reload only the textures that changed
+void SceneFile::restoreMaterial(SceneMaterial *const target, const SceneFile::material_data &data) {
+    Material *const material = target->getMaterial();
+
+    material->setAmbientColor(data.ambient_color);
+    material->setDiffuseColor(data.diffuse_color);
+    material->setSpecularColor(data.specular_color);
+    material->setTransmissionColor(data.transmission_color);
+    material->setAlpha(data.alpha);
+    material->setSharpness(data.sharpness);
+    material->setShininess(data.shininess);
+    material->setRoughness(data.roughness);
+    material->setMetalness(data.metalness);
+    material->setRefractiveIndex(data.refractive_index);
+
+    unsigned int changed = 0U;
+    std::size_t index = 0U;
+    for (unsigned int bit = Texture::AMBIENT; bit <= Texture::STENCIL; bit <<= 1U, index++) {
+        const Texture *const texture = material->getTexture((Texture::Type)bit);
+        if ((texture != nullptr ? texture->getPath() : "") == data.texture[index])
+            continue;
+
+        target->getTexturePath((Texture::Type)bit) = data.texture[index];
+        changed |= bit;
+    }
+
+    if (changed != 0U)
+        target->reload((Texture::Type)changed);
+}
+
+
+// Check the references between the elements before touching the scene
+void SceneFile::validate(const SceneFile::scene_data &data) {
+    if (data.camera.empty() || (data.selected_camera >= data.camera.size()))
+        throw std::runtime_error("error: the scene file has no selected camera");
+
+    for (std::size_t i = 0U; i < data.node.size(); i++)
+        if ((data.node[i].parent != SceneFile::NONE) && (data.node[i].parent >= i))
+            throw std::runtime_error("error: scene graph node stored before its parent");
+
+    for (const SceneFile::program_data &program : data.program)
+        if (program.shader.size() != SceneFile::SHADERS)
+            throw std::runtime_error("error: wrong number of shaders in the scene file");
+
+    // Element references
+    const auto check_node = [&data](const std::uint32_t &node) {
+        if ((node != SceneFile::NONE) && (node >= data.node.size()))
+            throw std::runtime_error("error: element attached to an unknown scene graph node");
+    };
+
+    const auto check_material = [](const SceneFile::material_data &material) {
+        if (material.texture.size() != SceneFile::TEXTURES)
+            throw std::runtime_error("error: wrong number of textures in the scene file");
+    };
+
+    for (const SceneFile::camera_data &scene_cam : data.camera)
+        check_node(scene_cam.node);
+
+    if (data.light.size() > Scene::LIGHTS)
+        throw std::runtime_error("error: the scene file has more than " + std::to_string(Scene::LIGHTS) + " lights");
+
+    for (const SceneFile::light_data &light : data.light) {
+        if (light.type > Light::SPOTLIGHT)
+            throw std::runtime_error("error: unknown light type in the scene file");
+        check_node(light.node);
+    }
+
+    for (const SceneFile::model_data &model : data.model) {
+        if ((model.program != SceneFile::NONE) && (model.program >= data.program.size()))
+            throw std::runtime_error("error: model related to an unknown program");
+        check_node(model.node);
+        check_material(model.global);
+        for (const SceneFile::material_data &material : model.material)
+            check_material(material);
+    }
+}
+
+
+// Append the bytes of a plain value
+template <typename T>
+void SceneFile::write(std::string &buffer, const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values are written as bytes");
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Append the count and the elements
+template <typename T>
+void SceneFile::write(std::string &buffer, const std::vector<T> &values) {
+    SceneFile::write(buffer, (std::uint32_t)values.size());
+    for (const T &value : values)
+        SceneFile::write(buffer, value);
+}
+
+// Append a boolean as one byte
+void SceneFile::write(std::string &buffer, const bool &value) {
+    SceneFile::write(buffer, (std::uint8_t)value);
+}
+
+// Append the length and the characters
+void SceneFile::write(std::string &buffer, const std::string &value) {
+    SceneFile::write(buffer, (std::uint32_t)value.size());
+    buffer.append(value);
+}
+
+void SceneFile::write(std::string &buffer, const SceneFile::material_data &value) {
+    SceneFile::write(buffer, value.name);
+    SceneFile::write(buffer, value.ambient_color);
+    SceneFile::write(buffer, value.diffuse_color);
+    SceneFile::write(buffer, value.specular_color);
+    SceneFile::write(buffer, value.transmission_color);
+    SceneFile::write(buffer, value.alpha);
+    SceneFile::write(buffer, value.sharpness);
+    SceneFile::write(buffer, value.shininess);
+    SceneFile::write(buffer, value.roughness);
+    SceneFile::write(buffer, value.metalness);
+    SceneFile::write(buffer, value.refractive_index);
+    SceneFile::write(buffer, value.texture);
+}
+
+void SceneFile::write(std::string &buffer, const SceneFile::program_data &value) {
+    SceneFile::write(buffer, value.label);
+    SceneFile::write(buffer, value.shader);
+}
+
+void SceneFile::write(std::string &buffer, const SceneFile::camera_data &value) {
+    SceneFile::write(buffer, value.label);
+    SceneFile::write(buffer, value.orthogonal);
+    SceneFile::write(buffer, value.position);
+    SceneFile::write(buffer, value.look);
+    SceneFile::write(buffer, value.up);
+    SceneFile::write(buffer, value.fov);
+    SceneFile::write(buffer, value.clipping);
+    SceneFile::write(buffer, value.node);
+}
+
+void SceneFile::write(std::string &buffer, const SceneFile::light_data &value) {
+    SceneFile::write(buffer, value.label);
+    SceneFile::write(buffer, value.type);
+    SceneFile::write(buffer, value.enabled);
+    SceneFile::write(buffer, value.draw_model);
+    SceneFile::write(buffer, value.cast_shadow);
+    SceneFile::write(buffer, value.scale);
+    SceneFile::write(buffer, value.position);
+    SceneFile::write(buffer, value.direction);
+    SceneFile::write(buffer, value.ambient);
+    SceneFile::write(buffer, value.diffuse);
+    SceneFile::write(buffer, value.specular);
+    SceneFile::write(buffer, value.ambient_level);
+    SceneFile::write(buffer, value.specular_level);
+    SceneFile::write(buffer, value.shininess);
+    SceneFile::write(buffer, value.attenuation);
+    SceneFile::write(buffer, value.cutoff);
+    SceneFile::write(buffer, value.node);
+}
+
+void SceneFile::write(std::string &buffer, const SceneFile::model_data &value) {
+    SceneFile::write(buffer, value.label);
+    SceneFile::write(buffer, value.path);
+    SceneFile::write(buffer, value.program);
+    SceneFile::write(buffer, value.enabled);
+    SceneFile::write(buffer, value.lock_scale);
+    SceneFile::write(buffer, value.textures_enabled);
+    SceneFile::write(buffer, value.show_normals);
+    SceneFile::write(buffer, value.show_boundingbox);
+    SceneFile::write(buffer, value.cluster_culling);
+    SceneFile::write(buffer, value.cone_culling);
+    SceneFile::write(buffer, value.position);
+    SceneFile::write(buffer, value.rotation);
+    SceneFile::write(buffer, value.scale);
+    SceneFile::write(buffer, value.global);
+    SceneFile::write(buffer, value.material);
+    SceneFile::write(buffer, value.node);
+}
+
+void SceneFile::write(std::string &buffer, const SceneFile::stream_data &value) {
+    SceneFile::write(buffer, value.path);
+    SceneFile::write(buffer, value.budget);
+    SceneFile::write(buffer, value.position);
+    SceneFile::write(buffer, value.rotation);
+    SceneFile::write(buffer, value.scale);
+}
+
+void SceneFile::write(std::string &buffer, const SceneFile::node_data &value) {
+    SceneFile::write(buffer, value.label);
+    SceneFile::write(buffer, value.parent);
+    SceneFile::write(buffer, value.position);
+    SceneFile::write(buffer, value.rotation);
+    SceneFile::write(buffer, value.scale);
+}
+
+
+// Read the bytes of a plain value
+template <typename T>
+void SceneFile::read(const std::string &buffer, std::size_t &offset, T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values are read as bytes");
+    if (sizeof(T) > buffer.size() - offset)
+        throw std::runtime_error("error: truncated scene file");
+
+    std::memcpy(&value, buffer.data() + offset, sizeof(T));
+    offset += sizeof(T);
+}
+
+// Read the count and the elements, each element takes at least one byte
+template <typename T>
+void SceneFile::read(const std::string &buffer, std::size_t &offset, std::vector<T> &values) {
+    std::uint32_t count;
+    SceneFile::read(buffer, offset, count);
+    if (count > buffer.size() - offset)
+        throw std::runtime_error("error: truncated scene file");
+
+    values.resize(count);
+    for (T &value : values)
+        SceneFile::read(buffer, offset, value);
+}
+
+// Read a boolean from one byte
+void SceneFile::read(const std::string &buffer, std::size_t &offset, bool &value) {
+    std::uint8_t byte;
+    SceneFile::read(buffer, offset, byte);
+    value = (byte != 0U);
+}
+
+// Read the length and the characters
+void SceneFile::read(const std::string &buffer, std::size_t &offset, std::string &value) {
+    std::uint32_t length;
+    SceneFile::read(buffer, offset, length);
+    if (length > buffer.size() - offset)
+        throw std::runtime_error("error: truncated scene file");
+
+    value.assign(buffer, offset, length);
+    offset += length;
+}
+
+void SceneFile::read(const std::string &buffer, std::size_t &offset, SceneFile::material_data &value) {
+    SceneFile::read(buffer, offset, value.name);
+    SceneFile::read(buffer, offset, value.ambient_color);
+    SceneFile::read(buffer, offset, value.diffuse_color);
+    SceneFile::read(buffer, offset, value.specular_color);
+    SceneFile::read(buffer, offset, value.transmission_color);
+    SceneFile::read(buffer, offset, value.alpha);
+    SceneFile::read(buffer, offset, value.sharpness);
+    SceneFile::read(buffer, offset, value.shininess);
+    SceneFile::read(buffer, offset, value.roughness);
+    SceneFile::read(buffer, offset, value.metalness);
+    SceneFile::read(buffer, offset, value.refractive_index);
+    SceneFile::read(buffer, offset, value.texture);
+}
+
+void SceneFile::read(const std::string &buffer, std::size_t &offset, SceneFile::program_data &value) {
+    SceneFile::read(buffer, offset, value.label);
+    SceneFile::read(buffer, offset, value.shader);
+}
+
+void SceneFile::read(const std::string &buffer, std::size_t &offset, SceneFile::camera_data &value) {
+    SceneFile::read(buffer, offset, value.label);
+    SceneFile::read(buffer, offset, value.orthogonal);
+    SceneFile::read(buffer, offset, value.position);
+    SceneFile::read(buffer, offset, value.look);
+    SceneFile::read(buffer, offset, value.up);
+    SceneFile::read(buffer, offset, value.fov);
+    SceneFile::read(buffer, offset, value.clipping);
+    SceneFile::read(buffer, offset, value.node);
+}
+
+void SceneFile::read(const std::string &buffer, std::size_t &offset, SceneFile::light_data &value) {
+    SceneFile::read(buffer, offset, value.label);
+    SceneFile::read(buffer, offset, value.type);
+    SceneFile::read(buffer, offset, value.enabled);
+    SceneFile::read(buffer, offset, value.draw_model);
+    SceneFile::read(buffer, offset, value.cast_shadow);
+    SceneFile::read(buffer, offset, value.scale);
+    SceneFile::read(buffer, offset, value.position);
+    SceneFile::read(buffer, offset, value.direction);
+    SceneFile::read(buffer, offset, value.ambient);
+    SceneFile::read(buffer, offset, value.diffuse);
+    SceneFile::read(buffer, offset, value.specular);
+    SceneFile::read(buffer, offset, value.ambient_level);
+    SceneFile::read(buffer, offset, value.specular_level);
+    SceneFile::read(buffer, offset, value.shininess);
+    SceneFile::read(buffer, offset, value.attenuation);
+    SceneFile::read(buffer, offset, value.cutoff);
+    SceneFile::read(buffer, offset, value.node);
+}
+
+void SceneFile::read(const std::string &buffer, std::size_t &offset, SceneFile::model_data &value) {
+    SceneFile::read(buffer, offset, value.label);
+    SceneFile::read(buffer, offset, value.path);
+    SceneFile::read(buffer, offset, value.program);
+    SceneFile::read(buffer, offset, value.enabled);
+    SceneFile::read(buffer, offset, value.lock_scale);
+    SceneFile::read(buffer, offset, value.textures_enabled);
+    SceneFile::read(buffer, offset, value.show_normals);
+    SceneFile::read(buffer, offset, value.show_boundingbox);
+    SceneFile::read(buffer, offset, value.cluster_culling);
+    SceneFile::read(buffer, offset, value.cone_culling);
+    SceneFile::read(buffer, offset, value.position);
+    SceneFile::read(buffer, offset, value.rotation);
+    SceneFile::read(buffer, offset, value.scale);
+    SceneFile::read(buffer, offset, value.global);
+    SceneFile::read(buffer, offset, value.material);
+    SceneFile::read(buffer, offset, value.node);
+}
+
+void SceneFile::read(const std::string &buffer, std::size_t &offset, SceneFile::stream_data &value) {
+    SceneFile::read(buffer, offset, value.path);
+    SceneFile::read(buffer, offset, value.budget);
+    SceneFile::read(buffer, offset, value.position);
+    SceneFile::read(buffer, offset, value.rotation);
+    SceneFile::read(buffer, offset, value.scale);
+}
+
+void SceneFile::read(const std::string &buffer, std::size_t &offset, SceneFile::node_data &value) {
+    SceneFile::read(buffer, offset, value.label);
+    SceneFile::read(buffer, offset, value.parent);
+    SceneFile::read(buffer, offset, value.position);
+    SceneFile::read(buffer, offset, value.rotation);
+    SceneFile::read(buffer, offset, value.scale);
+}
+
+
+// Write the session as indented JSON next to the binary file
+void SceneFile::writeJSON(const SceneFile::scene_data &data, const std::string &path) {
+    std::ostringstream json;
+    json << std::setprecision(9);
+
+    // Escape the quotes, backslashes and control characters
+    const auto string = [&json](const std::string &value) {
+        json << '"';
+        for (const char &character : value) {
+            if ((character == '"') || (character == '\\'))
+                json << '\\' << character;
+            else if ((unsigned char)character < 0x20U)
+                json << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (unsigned int)character << std::dec << std::setfill(' ');
+            else
+                json << character;
+        }
+        json << '"';
+    };
+
+    const auto vector = [&json](const float *const value, const std::size_t &count) {
+        json << '[';
+        for (std::size_t i = 0U; i < count; i++)
+            json << (i > 0U ? ", " : "") << value[i];
+        json << ']';
+    };
+
+    const auto index = [&json](const std::uint32_t &value) {
+        if (value != SceneFile::NONE)
+            json << value;
+        else
+            json << "null";
+    };
+
+    const auto boolean = [&json](const bool &value) {
+        json << (value ? "true" : "false");
+    };
+
+    const auto material = [&](const SceneFile::material_data &value, const std::string &indent) {
+        json << "{\n" << indent << "    \"name\": "; string(value.name);
+        json << ",\n" << indent << "    \"ambient_color\": "; vector(&value.ambient_color.x, 3U);
+        json << ",\n" << indent << "    \"diffuse_color\": "; vector(&value.diffuse_color.x, 3U);
+        json << ",\n" << indent << "    \"specular_color\": "; vector(&value.specular_color.x, 3U);
+        json << ",\n" << indent << "    \"transmission_color\": "; vector(&value.transmission_color.x, 3U);
+        json << ",\n" << indent << "    \"alpha\": " << value.alpha;
+        json << ",\n" << indent << "    \"sharpness\": " << value.sharpness;
+        json << ",\n" << indent << "    \"shininess\": " << value.shininess;
+        json << ",\n" << indent << "    \"roughness\": " << value.roughness;
+        json << ",\n" << indent << "    \"metalness\": " << value.metalness;
+        json << ",\n" << indent << "    \"refractive_index\": " << value.refractive_index;
+        json << ",\n" << indent << "    \"textures\": [";
+        for (std::size_t i = 0U; i < value.texture.size(); i++) {
+            json << (i > 0U ? ", " : "");
+            string(value.texture[i]);
+        }
+        json << "]\n" << indent << '}';
+    };
+
+    // Settings
+    json << "{\n    \"version\": " << SceneFile::VERSION;
+    json << ",\n    \"background\": "; vector(&data.background.x, 3U);
+    json << ",\n    \"deferred\": "; boolean(data.deferred);
+    json << ",\n    \"depth_prepass\": "; boolean(data.depth_prepass);
+    json << ",\n    \"occlusion_culling\": "; boolean(data.occlusion_culling);
+    json << ",\n    \"shadow_mapping\": "; boolean(data.shadow_mapping);
+    json << ",\n    \"selected_camera\": " << data.selected_camera;
+
+    // Programs
+    json << ",\n    \"programs\": [";
+    for (std::size_t i = 0U; i < data.program.size(); i++) {
+        const SceneFile::program_data &program = data.program[i];
+        json << (i > 0U ? "," : "") << "\n        {\n            \"label\": "; string(program.label);
+        json << ",\n            \"shaders\": [";
+        for (std::size_t j = 0U; j < program.shader.size(); j++) {
+            json << (j > 0U ? ", " : "");
+            string(program.shader[j]);
+        }
+        json << "]\n        }";
+    }
+    json << (data.program.empty() ? "]" : "\n    ]");
+
+    // Cameras
+    json << ",\n    \"cameras\": [";
+    for (std::size_t i = 0U; i < data.camera.size(); i++) {
+        const SceneFile::camera_data &scene_cam = data.camera[i];
+        json << (i > 0U ? "," : "") << "\n        {\n            \"label\": "; string(scene_cam.label);
+        json << ",\n            \"orthogonal\": "; boolean(scene_cam.orthogonal);
+        json << ",\n            \"position\": "; vector(&scene_cam.position.x, 3U);
+        json << ",\n            \"look\": "; vector(&scene_cam.look.x, 3U);
+        json << ",\n            \"up\": "; vector(&scene_cam.up.x, 3U);
+        json << ",\n            \"fov\": " << scene_cam.fov;
+        json << ",\n            \"clipping\": "; vector(&scene_cam.clipping.x, 2U);
+        json << ",\n            \"node\": "; index(scene_cam.node);
+        json << "\n        }";
+    }
+    json << (data.camera.empty() ? "]" : "\n    ]");
+
+    // Lights
+    json << ",\n    \"lights\": [";
+    for (std::size_t i = 0U; i < data.light.size(); i++) {
+        const SceneFile::light_data &light = data.light[i];
+        json << (i > 0U ? "," : "") << "\n        {\n            \"label\": "; string(light.label);
+        json << ",\n            \"type\": "; string(Light::to_string((Light::Type)light.type));
+        json << ",\n            \"enabled\": "; boolean(light.enabled);
+        json << ",\n            \"draw_model\": "; boolean(light.draw_model);
+        json << ",\n            \"cast_shadow\": "; boolean(light.cast_shadow);
+        json << ",\n            \"scale\": " << light.scale;
+        json << ",\n            \"position\": "; vector(&light.position.x, 3U);
+        json << ",\n            \"direction\": "; vector(&light.direction.x, 3U);
+        json << ",\n            \"ambient\": "; vector(&light.ambient.x, 3U);
+        json << ",\n            \"diffuse\": "; vector(&light.diffuse.x, 3U);
+        json << ",\n            \"specular\": "; vector(&light.specular.x, 3U);
+        json << ",\n            \"ambient_level\": " << light.ambient_level;
+        json << ",\n            \"specular_level\": " << light.specular_level;
+        json << ",\n            \"shininess\": " << light.shininess;
+        json << ",\n            \"attenuation\": "; vector(&light.attenuation.x, 3U);
+        json << ",\n            \"cutoff\": "; vector(&light.cutoff.x, 2U);
+        json << ",\n            \"node\": "; index(light.node);
+        json << "\n        }";
+    }
+    json << (data.light.empty() ? "]" : "\n    ]");
+
+    // Models
+    json << ",\n    \"models\": [";
+    for (std::size_t i = 0U; i < data.model.size(); i++) {
+        const SceneFile::model_data &model = data.model[i];
+        json << (i > 0U ? "," : "") << "\n        {\n            \"label\": "; string(model.label);
+        json << ",\n            \"path\": "; string(model.path);
+        json << ",\n            \"program\": "; index(model.program);
+        json << ",\n            \"enabled\": "; boolean(model.enabled);
+        json << ",\n            \"lock_scale\": "; boolean(model.lock_scale);
+        json << ",\n            \"textures_enabled\": "; boolean(model.textures_enabled);
+        json << ",\n            \"show_normals\": "; boolean(model.show_normals);
+        json << ",\n            \"show_boundingbox\": "; boolean(model.show_boundingbox);
+        json << ",\n            \"cluster_culling\": "; boolean(model.cluster_culling);
+        json << ",\n            \"cone_culling\": "; boolean(model.cone_culling);
+        json << ",\n            \"position\": "; vector(&model.position.x, 3U);
+        json << ",\n            \"rotation\": "; vector(&model.rotation.x, 4U);
+        json << ",\n            \"scale\": "; vector(&model.scale.x, 3U);
+        json << ",\n            \"node\": "; index(model.node);
+        json << ",\n            \"global_material\": "; material(model.global, "            ");
+        json << ",\n            \"materials\": [";
+        for (std::size_t j = 0U; j < model.material.size(); j++) {
+            json << (j > 0U ? ", " : "");
+            material(model.material[j], "            ");
+        }
+        json << "]\n        }";
+    }
+    json << (data.model.empty() ? "]" : "\n    ]");
+
+    // Streamed models
+    json << ",\n    \"streamed_models\": [";
+    for (std::size_t i = 0U; i < data.stream.size(); i++) {
+        const SceneFile::stream_data &model = data.stream[i];
+        json << (i > 0U ? "," : "") << "\n        {\n            \"path\": "; string(model.path);
+        json << ",\n            \"budget\": " << model.budget;
+        json << ",\n            \"position\": "; vector(&model.position.x, 3U);
+        json << ",\n            \"rotation\": "; vector(&model.rotation.x, 4U);
+        json << ",\n            \"scale\": "; vector(&model.scale.x, 3U);
+        json << "\n        }";
+    }
+    json << (data.stream.empty() ? "]" : "\n    ]");
+
+    // Scene graph nodes
+    json << ",\n    \"nodes\": [";
+    for (std::size_t i = 0U; i < data.node.size(); i++) {
+        const SceneFile::node_data &node = data.node[i];
+        json << (i > 0U ? "," : "") << "\n        {\n            \"label\": "; string(node.label);
+        json << ",\n            \"parent\": "; index(node.parent);
+        json << ",\n            \"position\": "; vector(&node.position.x, 3U);
+        json << ",\n            \"rotation\": "; vector(&node.rotation.x, 4U);
+        json << ",\n            \"scale\": "; vector(&node.scale.x, 3U);
+        json << "\n        }";
+    }
+    json << (data.node.empty() ? "]" : "\n    ]") << "\n}\n";
+
+    // Write file
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open() || !(file << json.str()))
+        throw std::runtime_error("error: could not write the scene file '" + path + "'");
+}
+
+
+// Save the session in the binary format, and optionally its JSON mirror with the .json extension appended
+bool SceneFile::save(Scene *const scene, const std::string &path, const bool &json) {
+    try {
+        SceneFile::scene_data data;
+        SceneFile::collect(scene, data);
+
+        // Encode the whole session in memory and write it at once
+        std::string buffer;
+        SceneFile::write(buffer, SceneFile::MAGIC);
+        SceneFile::write(buffer, SceneFile::VERSION);
+        SceneFile::write(buffer, data.background);
+        SceneFile::write(buffer, data.deferred);
+        SceneFile::write(buffer, data.depth_prepass);
+        SceneFile::write(buffer, data.occlusion_culling);
+        SceneFile::write(buffer, data.shadow_mapping);
+        SceneFile::write(buffer, data.selected_camera);
+        SceneFile::write(buffer, data.program);
+        SceneFile::write(buffer, data.camera);
+        SceneFile::write(buffer, data.light);
+        SceneFile::write(buffer, data.model);
+        SceneFile::write(buffer, data.stream);
+        SceneFile::write(buffer, data.node);
+
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(buffer.data(), buffer.size()))
+            throw std::runtime_error("error: could not write the scene file '" + path + "'");
+
+        if (json)
+            SceneFile::writeJSON(data, path + ".json");
+    } catch (std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Load a session, the file is read and checked whole before the scene is modified
+bool SceneFile::load(Scene *const scene, const std::string &path) {
+    SceneFile::scene_data data;
+
+    try {
+        // Read the whole file at once
+        std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            throw std::runtime_error("error: could not open the scene file '" + path + "'");
+
+        std::string buffer((std::size_t)file.tellg(), '\0');
+        file.seekg(0, std::ios::beg);
+        if (!file.read(&buffer[0], buffer.size()))
+            throw std::runtime_error("error: could not read the scene file '" + path + "'");
+
+        // Check the header
+        std::size_t offset = 0U;
+        std::uint32_t magic;
+        std::uint32_t version;
+        SceneFile::read(buffer, offset, magic);
+        SceneFile::read(buffer, offset, version);
+        if (magic != SceneFile::MAGIC)
+            throw std::runtime_error("error: '" + path + "' is not a scene file");
+        if (version != SceneFile::VERSION)
+            throw std::runtime_error("error: unsupported scene file version " + std::to_string(version));
+
+        // Decode the session
+        SceneFile::read(buffer, offset, data.background);
+        SceneFile::read(buffer, offset, data.deferred);
+        SceneFile::read(buffer, offset, data.depth_prepass);
+        SceneFile::read(buffer, offset, data.occlusion_culling);
+        SceneFile::read(buffer, offset, data.shadow_mapping);
+        SceneFile::read(buffer, offset, data.selected_camera);
+        SceneFile::read(buffer, offset, data.program);
+        SceneFile::read(buffer, offset, data.camera);
+        SceneFile::read(buffer, offset, data.light);
+        SceneFile::read(buffer, offset, data.model);
+        SceneFile::read(buffer, offset, data.stream);
+        SceneFile::read(buffer, offset, data.node);
+
+        SceneFile::validate(data);
+    } catch (std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return false;
+    }
+
+    SceneFile::restore(scene, data);
+    return true;
+}
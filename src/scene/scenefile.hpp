@@ -0,0 +1,180 @@
+#ifndef __SCENE_FILE_HPP_
+#define __SCENE_FILE_HPP_
+
+#include "scene.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SceneFile {
+    private:
+        // Material overrides, matched by name with the materials of the loaded model
+        struct material_data {
+            std::string name;
+            glm::vec3 ambient_color;
+            glm::vec3 diffuse_color;
+            glm::vec3 specular_color;
+            glm::vec3 transmission_color;
+            float alpha;
+            float sharpness;
+            float shininess;
+            float roughness;
+            float metalness;
+            float refractive_index;
+            std::vector<std::string> texture;
+        };
+
+        // Shader paths in vertex, tessellation control, tessellation evaluation, geometry and fragment order
+        struct program_data {
+            std::string label;
+            std::vector<std::string> shader;
+        };
+
+        struct camera_data {
+            std::string label;
+            bool orthogonal;
+            glm::vec3 position;
+            glm::vec3 look;
+            glm::vec3 up;
+            float fov;
+            glm::vec2 clipping;
+            std::uint32_t node;
+        };
+
+        struct light_data {
+            std::string label;
+            std::uint32_t type;
+            bool enabled;
+            bool draw_model;
+            bool cast_shadow;
+            float scale;
+            glm::vec3 position;
+            glm::vec3 direction;
+            glm::vec3 ambient;
+            glm::vec3 diffuse;
+            glm::vec3 specular;
+            float ambient_level;
+            float specular_level;
+            float shininess;
+            glm::vec3 attenuation;
+            glm::vec2 cutoff;
+            std::uint32_t node;
+        };
+
+        struct model_data {
+            std::string label;
+            std::string path;
+            std::uint32_t program;
+            bool enabled;
+            bool lock_scale;
+            bool textures_enabled;
+            bool show_normals;
+            bool show_boundingbox;
+            bool cluster_culling;
+            bool cone_culling;
+            glm::vec3 position;
+            glm::quat rotation;
+            glm::vec3 scale;
+            SceneFile::material_data global;
+            std::vector<SceneFile::material_data> material;
+            std::uint32_t node;
+        };
+
+        struct stream_data {
+            std::string path;
+            std::uint64_t budget;
+            glm::vec3 position;
+            glm::quat rotation;
+            glm::vec3 scale;
+        };
+
+        // Scene graph node, the parents come before their children
+        struct node_data {
+            std::string label;
+            std::uint32_t parent;
+            glm::vec3 position;
+            glm::quat rotation;
+            glm::vec3 scale;
+        };
+
+        // Whole session, the elements reference the programs, cameras and nodes by their index
+        struct scene_data {
+            glm::vec3 background;
+            bool deferred;
+            bool depth_prepass;
+            bool occlusion_culling;
+            bool shadow_mapping;
+            std::uint32_t selected_camera;
+            std::vector<SceneFile::program_data> program;
+            std::vector<SceneFile::camera_data> camera;
+            std::vector<SceneFile::light_data> light;
+            std::vector<SceneFile::model_data> model;
+            std::vector<SceneFile::stream_data> stream;
+            std::vector<SceneFile::node_data> node;
+        };
+
+        // Disable constructor, copy and assignation
+        SceneFile() = delete;
+        SceneFile(const SceneFile &) = delete;
+        SceneFile &operator = (const SceneFile &) = delete;
+
+        // Take the state of the scene and restore it through the push methods
+        static void collect(Scene *const scene, SceneFile::scene_data &data);
+        static void restore(Scene *const scene, const SceneFile::scene_data &data);
+
+        // Material overrides
+        static void collectMaterial(SceneMaterial *const source, SceneFile::material_data &data);
+        static void restoreMaterial(SceneMaterial *const target, const SceneFile::material_data &data);
+
+        // Check the references between the elements
+        static void validate(const SceneFile::scene_data &data);
+
+        // Binary fields, the counts and strings are prefixed by their 32 bits length
+        template <typename T>
+        static void write(std::string &buffer, const T &value);
+        template <typename T>
+        static void write(std::string &buffer, const std::vector<T> &values);
+        static void write(std::string &buffer, const bool &value);
+        static void write(std::string &buffer, const std::string &value);
+        static void write(std::string &buffer, const SceneFile::material_data &value);
+        static void write(std::string &buffer, const SceneFile::program_data &value);
+        static void write(std::string &buffer, const SceneFile::camera_data &value);
+        static void write(std::string &buffer, const SceneFile::light_data &value);
+        static void write(std::string &buffer, const SceneFile::model_data &value);
+        static void write(std::string &buffer, const SceneFile::stream_data &value);
+        static void write(std::string &buffer, const SceneFile::node_data &value);
+
+        template <typename T>
+        static void read(const std::string &buffer, std::size_t &offset, T &value);
+        template <typename T>
+        static void read(const std::string &buffer, std::size_t &offset, std::vector<T> &values);
+        static void read(const std::string &buffer, std::size_t &offset, bool &value);
+        static void read(const std::string &buffer, std::size_t &offset, std::string &value);
+        static void read(const std::string &buffer, std::size_t &offset, SceneFile::material_data &value);
+        static void read(const std::string &buffer, std::size_t &offset, SceneFile::program_data &value);
+        static void read(const std::string &buffer, std::size_t &offset, SceneFile::camera_data &value);
+        static void read(const std::string &buffer, std::size_t &offset, SceneFile::light_data &value);
+        static void read(const std::string &buffer, std::size_t &offset, SceneFile::model_data &value);
+        static void read(const std::string &buffer, std::size_t &offset, SceneFile::stream_data &value);
+        static void read(const std::string &buffer, std::size_t &offset, SceneFile::node_data &value);
+
+        // JSON mirror for inspection and diffs, it is not read back
+        static void writeJSON(const SceneFile::scene_data &data, const std::string &path);
+
+        // Static const attributes
+        static constexpr const std::uint32_t MAGIC = 0x4E435356U;
+        static constexpr const std::uint32_t VERSION = 1U;
+        static constexpr const std::uint32_t NONE = 0xFFFFFFFFU;
+        static constexpr const std::size_t TEXTURES = 8U;
+        static constexpr const std::size_t SHADERS = 5U;
+
+    public:
+        static bool save(Scene *const scene, const std::string &path, const bool &json = false);
+        static bool load(Scene *const scene, const std::string &path);
+};
+
+#endif // __SCENE_FILE_HPP_
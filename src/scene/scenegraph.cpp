@@ -0,0 +1,465 @@
+#include "scenegraph.hpp"
+
+#include <glm/gtx/matrix_decompose.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+// Static const definitions
+constexpr const SceneGraph::Node SceneGraph::NONE;
+constexpr const std::size_t SceneGraph::ROOT;
+constexpr const float SceneGraph::MIN_SCALE;
+
+
+// Scene graph constructor
+SceneGraph::SceneGraph() : updated(0U) {}
+
+
+// Mark the node as changed and its ancestors as containing a changed node
+void SceneGraph::setDirty(const std::size_t &index) {
+    node[index].dirty = true;
+    for (std::size_t i = node[index].parent; (i != SceneGraph::ROOT) && !node[i].child_dirty; i = node[i].parent)
+        node[i].child_dirty = true;
+}
+
+// Store the position of the identifiers from a node onwards
+void SceneGraph::refreshPositions(const std::size_t &first) {
+    for (std::size_t i = first; i < node.size(); i++)
+        position_of[node[i].id] = i;
+}
+
+// Local matrix of a node
+glm::mat4 SceneGraph::getLocalMatrix(const SceneGraph::node_data &data) {
+    return glm::translate(data.position) * glm::mat4_cast(data.rotation) * glm::scale(data.scale);
+}
+
+// World matrix of a node from the current local transformations, the stored one may be outdated
+glm::mat4 SceneGraph::getCurrentWorldMatrix(const std::size_t &index) const {
+    glm::mat4 world = SceneGraph::getLocalMatrix(node[index]);
+    for (std::size_t i = node[index].parent; i != SceneGraph::ROOT; i = node[i].parent)
+        world = SceneGraph::getLocalMatrix(node[i]) * world;
+
+    return world;
+}
+
+// Frame of a model, its transformation
+glm::mat4 SceneGraph::getFrame(const SceneModel *const model) {
+    return glm::translate(model->getPosition()) * glm::mat4_cast(model->getRotationQuaternion()) * glm::scale(model->getScale());
+}
+
+// Frame of a light, the direction is the first column and the position the last one
+glm::mat4 SceneGraph::getFrame(const SceneLight *const light) {
+    glm::mat4 frame(1.0F);
+    frame[0] = glm::vec4(light->getDirection(), 0.0F);
+    frame[3] = glm::vec4(light->getPosition(), 1.0F);
+    return frame;
+}
+
+// Frame of a camera, the look direction is the first column and the position the last one
+glm::mat4 SceneGraph::getFrame(const SceneCamera *const scene_cam) {
+    glm::mat4 frame(1.0F);
+    frame[0] = glm::vec4(scene_cam->getLookDirection(), 0.0F);
+    frame[3] = glm::vec4(scene_cam->getPosition(), 1.0F);
+    return frame;
+}
+
+// Set the frame of a model, the skew of a non uniform scale over a rotation is lost in the decomposition but not accumulated
+void SceneGraph::setFrame(SceneModel *const model, const glm::mat4 &frame) {
+    model->setMatrix(frame);
+}
+
+// Set the frame of a light
+void SceneGraph::setFrame(SceneLight *const light, const glm::mat4 &frame) {
+    light->setPosition(glm::vec3(frame[3]));
+    light->setDirection(glm::vec3(frame[0]));
+}
+
+// Set the frame of a camera
+void SceneGraph::setFrame(SceneCamera *const scene_cam, const glm::mat4 &frame) {
+    scene_cam->setPosition(glm::vec3(frame[3]));
+    scene_cam->setLookDirection(glm::vec3(frame[0]));
+}
+
+// Place the attached elements from their frames relative to the node, the ones changed outside the graph take their new place relative to the previous world matrix
+template <typename T>
+void SceneGraph::moveAttached(std::unordered_map<const T *, SceneGraph::attached_data> &attached, const std::vector<T *> &elements, const glm::mat4 &previous, const glm::mat4 &world) {
+    for (T *const &element : elements) {
+        SceneGraph::attached_data &entry = attached[element];
+        const glm::mat4 frame = SceneGraph::getFrame(element);
+        if (frame != entry.placed)
+            entry.local = glm::inverse(previous) * frame;
+
+        SceneGraph::setFrame(element, world * entry.local);
+        entry.placed = SceneGraph::getFrame(element);
+    }
+}
+
+// Add an element to the list of a node, it keeps its current place relative to the last world matrix of the node
+template <typename T>
+void SceneGraph::attach(std::unordered_map<const T *, SceneGraph::attached_data> &attached, std::vector<T *> SceneGraph::node_data::*list, T *const element, const SceneGraph::Node &id) {
+    detach(attached, list, element);
+    if (!contains(id))
+        return;
+
+    SceneGraph::node_data &data = node[position_of[id]];
+    const glm::mat4 frame = SceneGraph::getFrame(element);
+    (data.*list).push_back(element);
+    attached[element] = SceneGraph::attached_data{id, glm::inverse(data.world_mat) * frame, frame};
+}
+
+// Remove an element from the list of its node
+template <typename T>
+bool SceneGraph::detach(std::unordered_map<const T *, SceneGraph::attached_data> &attached, std::vector<T *> SceneGraph::node_data::*list, T *const element) {
+    typename std::unordered_map<const T *, SceneGraph::attached_data>::iterator result = attached.find(element);
+    if (result == attached.end())
+        return false;
+
+    std::vector<T *> &elements = node[position_of[result->second.id]].*list;
+    elements.erase(std::remove(elements.begin(), elements.end(), element), elements.end());
+    attached.erase(result);
+    return true;
+}
+
+
+// Add a node after the subtree of its parent, or at the end if it is a root
+SceneGraph::Node SceneGraph::push(const std::string &label, const SceneGraph::Node &parent) {
+    std::size_t at = node.size();
+    std::size_t parent_index = SceneGraph::ROOT;
+    if (contains(parent)) {
+        parent_index = position_of[parent];
+        at = parent_index + node[parent_index].subtree;
+        for (std::size_t i = parent_index; i != SceneGraph::ROOT; i = node[i].parent)
+            node[i].subtree++;
+    }
+
+    // The nodes after the new one move one place
+    for (SceneGraph::node_data &data : node)
+        if ((data.parent != SceneGraph::ROOT) && (data.parent >= at))
+            data.parent++;
+
+    // The new node starts at the place of its parent
+    const SceneGraph::Node id = (SceneGraph::Node)position_of.size();
+    const glm::mat4 world = (parent_index != SceneGraph::ROOT ? node[parent_index].world_mat : glm::mat4(1.0F));
+    node.insert(node.begin() + at, SceneGraph::node_data{id, parent_index, 1U, label, glm::vec3(0.0F), glm::quat(), glm::vec3(1.0F), world, false, false, false, {}, {}, {}});
+    position_of.push_back(at);
+    refreshPositions(at);
+
+    return id;
+}
+
+// Remove a node and its subtree, the attached elements stay where they are
+void SceneGraph::pop(const SceneGraph::Node &id) {
+    if (!contains(id))
+        return;
+
+    const std::size_t index = position_of[id];
+    const std::size_t count = node[index].subtree;
+
+    // Detach the elements and invalidate the identifiers
+    for (std::size_t i = index; i < index + count; i++) {
+        for (SceneModel *const &model : node[i].model)
+            model_node.erase(model);
+        for (SceneLight *const &light : node[i].light)
+            light_node.erase(light);
+        for (SceneCamera *const &scene_cam : node[i].camera)
+            camera_node.erase(scene_cam);
+
+        position_of[node[i].id] = SceneGraph::ROOT;
+    }
+
+    // Remove the subtree
+    for (std::size_t i = node[index].parent; i != SceneGraph::ROOT; i = node[i].parent)
+        node[i].subtree -= count;
+    node.erase(node.begin() + index, node.begin() + index + count);
+
+    for (SceneGraph::node_data &data : node)
+        if ((data.parent != SceneGraph::ROOT) && (data.parent > index))
+            data.parent -= count;
+    refreshPositions(index);
+}
+
+// Move a node and its subtree under another parent keeping its world placement, fails if the parent is in the subtree
+bool SceneGraph::setParent(const SceneGraph::Node &id, const SceneGraph::Node &parent) {
+    if (!contains(id) || ((parent != SceneGraph::NONE) && !contains(parent)) || isAncestor(id, parent) || (getParent(id) == parent))
+        return false;
+
+    const std::size_t index = position_of[id];
+    const std::size_t count = node[index].subtree;
+
+    // Local transformation that keeps the world matrix under the new parent
+    const glm::mat4 parent_world = (contains(parent) ? getCurrentWorldMatrix(position_of[parent]) : glm::mat4(1.0F));
+    const glm::mat4 local = glm::inverse(parent_world) * getCurrentWorldMatrix(index);
+
+    // Take the subtree out
+    std::vector<SceneGraph::node_data> block(node.begin() + index, node.begin() + index + count);
+    for (std::size_t i = node[index].parent; i != SceneGraph::ROOT; i = node[i].parent)
+        node[i].subtree -= count;
+    node.erase(node.begin() + index, node.begin() + index + count);
+
+    for (SceneGraph::node_data &data : node)
+        if ((data.parent != SceneGraph::ROOT) && (data.parent > index))
+            data.parent -= count;
+
+    // Insert it after the subtree of the new parent
+    std::size_t at = node.size();
+    std::size_t parent_index = SceneGraph::ROOT;
+    if (contains(parent)) {
+        parent_index = position_of[parent];
+        if (parent_index > index)
+            parent_index -= count;
+
+        at = parent_index + node[parent_index].subtree;
+        for (std::size_t i = parent_index; i != SceneGraph::ROOT; i = node[i].parent)
+            node[i].subtree += count;
+    }
+
+    for (SceneGraph::node_data &data : node)
+        if ((data.parent != SceneGraph::ROOT) && (data.parent >= at))
+            data.parent += count;
+
+    block[0].parent = parent_index;
+    for (std::size_t i = 1U; i < count; i++)
+        block[i].parent = block[i].parent - index + at;
+
+    node.insert(node.begin() + at, block.begin(), block.end());
+    refreshPositions(std::min(index, at));
+
+    // New local transformation
+    glm::vec3 skew;
+    glm::vec4 perspective;
+    glm::decompose(local, node[at].scale, node[at].rotation, node[at].position, skew, perspective);
+    setDirty(at);
+
+    return true;
+}
+
+
+// Compute the world matrices of the changed nodes in one pass, the subtrees without changes are skipped
+void SceneGraph::update() {
+    updated = 0U;
+    for (std::size_t i = 0U; i < node.size();) {
+        SceneGraph::node_data &data = node[i];
+        const bool parent_moved = (data.parent != SceneGraph::ROOT) && node[data.parent].moved;
+        if (!data.dirty && !data.child_dirty && !parent_moved) {
+            data.moved = false;
+            i += data.subtree;
+            continue;
+        }
+
+        // The parents come first so their world matrices are already updated
+        data.moved = data.dirty || parent_moved;
+        if (data.moved) {
+            const glm::mat4 parent_world = (data.parent != SceneGraph::ROOT ? node[data.parent].world_mat : glm::mat4(1.0F));
+            const glm::mat4 world = parent_world * SceneGraph::getLocalMatrix(data);
+            moveAttached(model_node, data.model, data.world_mat, world);
+            moveAttached(light_node, data.light, data.world_mat, world);
+            moveAttached(camera_node, data.camera, data.world_mat, world);
+            data.world_mat = world;
+            updated++;
+        }
+
+        data.dirty = false;
+        data.child_dirty = false;
+        i++;
+    }
+}
+
+
+// Attach a model to a node, it follows the node changes from its current place
+void SceneGraph::attach(SceneModel *const model, const SceneGraph::Node &id) {
+    attach(model_node, &SceneGraph::node_data::model, model, id);
+}
+
+// Attach a light to a node, it follows the node changes from its current place
+void SceneGraph::attach(SceneLight *const light, const SceneGraph::Node &id) {
+    attach(light_node, &SceneGraph::node_data::light, light, id);
+}
+
+// Attach a camera to a node, it follows the node changes from its current place
+void SceneGraph::attach(SceneCamera *const scene_cam, const SceneGraph::Node &id) {
+    attach(camera_node, &SceneGraph::node_data::camera, scene_cam, id);
+}
+
+// Detach a model from its node
+void SceneGraph::detach(SceneModel *const model) {
+    detach(model_node, &SceneGraph::node_data::model, model);
+}
+
+// Detach a light from its node
+void SceneGraph::detach(SceneLight *const light) {
+    detach(light_node, &SceneGraph::node_data::light, light);
+}
+
+// Detach a camera from its node
+void SceneGraph::detach(SceneCamera *const scene_cam) {
+    detach(camera_node, &SceneGraph::node_data::camera, scene_cam);
+}
+
+
+// Set the local position
+void SceneGraph::setPosition(const SceneGraph::Node &id, const glm::vec3 &position) {
+    if (!contains(id))
+        return;
+
+    node[position_of[id]].position = position;
+    setDirty(position_of[id]);
+}
+
+// Set the local rotation from angles in degrees
+void SceneGraph::setRotation(const SceneGraph::Node &id, const glm::vec3 &angles) {
+    if (!contains(id))
+        return;
+
+    SceneGraph::node_data &data = node[position_of[id]];
+    data.rotation = glm::normalize(glm::quat(glm::radians(angles - glm::degrees(glm::eulerAngles(data.rotation)))) * data.rotation);
+    setDirty(position_of[id]);
+}
+
+// Set the local rotation
+void SceneGraph::setRotation(const SceneGraph::Node &id, const glm::quat &rotation) {
+    if (!contains(id))
+        return;
+
+    node[position_of[id]].rotation = glm::normalize(rotation);
+    setDirty(position_of[id]);
+}
+
+// Set the local scale, it is kept away from zero so the world matrix stays invertible
+void SceneGraph::setScale(const SceneGraph::Node &id, const glm::vec3 &scale) {
+    if (!contains(id))
+        return;
+
+    glm::vec3 &value = node[position_of[id]].scale;
+    for (int i = 0; i < 3; i++)
+        value[i] = (std::isfinite(scale[i]) && (std::abs(scale[i]) >= SceneGraph::MIN_SCALE) ? scale[i] : SceneGraph::MIN_SCALE);
+    setDirty(position_of[id]);
+}
+
+// Set the label
+void SceneGraph::setLabel(const SceneGraph::Node &id, const std::string &label) {
+    if (contains(id))
+        node[position_of[id]].label = label;
+}
+
+
+// Check if the identifier references a node
+bool SceneGraph::contains(const SceneGraph::Node &id) const {
+    return (id < position_of.size()) && (position_of[id] != SceneGraph::ROOT);
+}
+
+// Check if a node is the other one or one of its ancestors
+bool SceneGraph::isAncestor(const SceneGraph::Node &ancestor, const SceneGraph::Node &id) const {
+    if (!contains(ancestor) || !contains(id))
+        return false;
+
+    const std::size_t first = position_of[ancestor];
+    const std::size_t index = position_of[id];
+    return (index >= first) && (index < first + node[first].subtree);
+}
+
+
+// Get the local position
+glm::vec3 SceneGraph::getPosition(const SceneGraph::Node &id) const {
+    return (contains(id) ? node[position_of[id]].position : glm::vec3(0.0F));
+}
+
+// Get the local rotation angles in degrees
+glm::vec3 SceneGraph::getRotationAngles(const SceneGraph::Node &id) const {
+    return glm::degrees(glm::eulerAngles(getRotationQuaternion(id)));
+}
+
+// Get the local rotation
+glm::quat SceneGraph::getRotationQuaternion(const SceneGraph::Node &id) const {
+    return (contains(id) ? node[position_of[id]].rotation : glm::quat());
+}
+
+// Get the local scale
+glm::vec3 SceneGraph::getScale(const SceneGraph::Node &id) const {
+    return (contains(id) ? node[position_of[id]].scale : glm::vec3(1.0F));
+}
+
+// Get the world matrix of the last update
+glm::mat4 SceneGraph::getWorldMatrix(const SceneGraph::Node &id) const {
+    return (contains(id) ? node[position_of[id]].world_mat : glm::mat4(1.0F));
+}
+
+// Get the label
+std::string SceneGraph::getLabel(const SceneGraph::Node &id) const {
+    return (contains(id) ? node[position_of[id]].label : std::string());
+}
+
+
+// Get the parent node, none for the roots
+SceneGraph::Node SceneGraph::getParent(const SceneGraph::Node &id) const {
+    if (!contains(id))
+        return SceneGraph::NONE;
+
+    const std::size_t parent = node[position_of[id]].parent;
+    return (parent != SceneGraph::ROOT ? node[parent].id : SceneGraph::NONE);
+}
+
+// Get the node of a model, none if it is not attached
+SceneGraph::Node SceneGraph::getNode(const SceneModel *const model) const {
+    std::unordered_map<const SceneModel *, SceneGraph::attached_data>::const_iterator result = model_node.find(model);
+    return (result != model_node.end() ? result->second.id : SceneGraph::NONE);
+}
+
+// Get the node of a light, none if it is not attached
+SceneGraph::Node SceneGraph::getNode(const SceneLight *const light) const {
+    std::unordered_map<const SceneLight *, SceneGraph::attached_data>::const_iterator result = light_node.find(light);
+    return (result != light_node.end() ? result->second.id : SceneGraph::NONE);
+}
+
+// Get the node of a camera, none if it is not attached
+SceneGraph::Node SceneGraph::getNode(const SceneCamera *const scene_cam) const {
+    std::unordered_map<const SceneCamera *, SceneGraph::attached_data>::const_iterator result = camera_node.find(scene_cam);
+    return (result != camera_node.end() ? result->second.id : SceneGraph::NONE);
+}
+
+
+// Get the number of nodes
+std::size_t SceneGraph::getNodes() const {
+    return node.size();
+}
+
+// Get the number of nodes recomputed in the last update
+std::size_t SceneGraph::getUpdatedNodes() const {
+    return updated;
+}
+
+// Get the identifier of the node at a position of the depth first order
+SceneGraph::Node SceneGraph::getID(const std::size_t &index) const {
+    return node[index].id;
+}
+
+// Get the depth of the node at a position of the depth first order
+std::size_t SceneGraph::getDepth(const std::size_t &index) const {
+    std::size_t depth = 0U;
+    for (std::size_t i = node[index].parent; i != SceneGraph::ROOT; i = node[i].parent)
+        depth++;
+
+    return depth;
+}
+
+// Get the size of the subtree of the node at a position of the depth first order
+std::size_t SceneGraph::getSubtree(const std::size_t &index) const {
+    return node[index].subtree;
+}
+
+
+// Get the models attached to a node
+const std::vector<SceneModel *> &SceneGraph::getModels(const SceneGraph::Node &id) const {
+    return node[position_of[id]].model;
+}
+
+// Get the lights attached to a node
+const std::vector<SceneLight *> &SceneGraph::getLights(const SceneGraph::Node &id) const {
+    return node[position_of[id]].light;
+}
+
+// Get the cameras attached to a node
+const std::vector<SceneCamera *> &SceneGraph::getCameras(const SceneGraph::Node &id) const {
+    return node[position_of[id]].camera;
+}
@@ -0,0 +1,152 @@
+#ifndef __SCENE_GRAPH_HPP_
+#define __SCENE_GRAPH_HPP_
+
+#include "scenecamera.hpp"
+#include "scenelight.hpp"
+#include "scenemodel.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class SceneGraph {
+    public:
+        // Stable node identifier
+        typedef std::uint32_t Node;
+
+        // Identifier of no node, the parent of the roots
+        static constexpr const Node NONE = 0xFFFFFFFFU;
+
+    private:
+        // Node in depth first order, each subtree is contiguous and the parents come before their children
+        struct node_data {
+            SceneGraph::Node id;
+            std::size_t parent;
+            std::size_t subtree;
+            std::string label;
+
+            // Local transformation and world matrix of the last update
+            glm::vec3 position;
+            glm::quat rotation;
+            glm::vec3 scale;
+            glm::mat4 world_mat;
+
+            // Local transformation changed, some descendant changed, and world matrix changed in the last update
+            bool dirty;
+            bool child_dirty;
+            bool moved;
+
+            // Attached elements
+            std::vector<SceneModel *> model;
+            std::vector<SceneLight *> light;
+            std::vector<SceneCamera *> camera;
+        };
+
+        // Attached element, its frame relative to the node and the world frame given in the last update
+        struct attached_data {
+            SceneGraph::Node id;
+            glm::mat4 local;
+            glm::mat4 placed;
+        };
+
+        // Nodes and position of each identifier
+        std::vector<SceneGraph::node_data> node;
+        std::vector<std::size_t> position_of;
+
+        // Node of each attached element
+        std::unordered_map<const SceneModel *, SceneGraph::attached_data> model_node;
+        std::unordered_map<const SceneLight *, SceneGraph::attached_data> light_node;
+        std::unordered_map<const SceneCamera *, SceneGraph::attached_data> camera_node;
+
+        // Nodes recomputed in the last update
+        std::size_t updated;
+
+        // Disable copy and assignation
+        SceneGraph(const SceneGraph &) = delete;
+        SceneGraph &operator = (const SceneGraph &) = delete;
+
+        // Mark a node and its ancestors
+        void setDirty(const std::size_t &index);
+
+        // Refresh the positions of the identifiers from a node onwards
+        void refreshPositions(const std::size_t &first);
+
+        // World matrix from the current local transformations
+        glm::mat4 getCurrentWorldMatrix(const std::size_t &index) const;
+
+        // Place the attached elements with the new world matrix of their node
+        template <typename T>
+        void moveAttached(std::unordered_map<const T *, SceneGraph::attached_data> &attached, const std::vector<T *> &elements, const glm::mat4 &previous, const glm::mat4 &world);
+
+        // Attach or detach an element from its node list
+        template <typename T>
+        void attach(std::unordered_map<const T *, SceneGraph::attached_data> &attached, std::vector<T *> SceneGraph::node_data::*list, T *const element, const SceneGraph::Node &id);
+        template <typename T>
+        bool detach(std::unordered_map<const T *, SceneGraph::attached_data> &attached, std::vector<T *> SceneGraph::node_data::*list, T *const element);
+
+        // Static methods
+        static glm::mat4 getLocalMatrix(const SceneGraph::node_data &data);
+        static glm::mat4 getFrame(const SceneModel *const model);
+        static glm::mat4 getFrame(const SceneLight *const light);
+        static glm::mat4 getFrame(const SceneCamera *const scene_cam);
+        static void setFrame(SceneModel *const model, const glm::mat4 &frame);
+        static void setFrame(SceneLight *const light, const glm::mat4 &frame);
+        static void setFrame(SceneCamera *const scene_cam, const glm::mat4 &frame);
+
+        // Static const attributes
+        static constexpr const std::size_t ROOT = (std::size_t)-1;
+        static constexpr const float MIN_SCALE = 0.001F;
+
+    public:
+        SceneGraph();
+
+        SceneGraph::Node push(const std::string &label, const SceneGraph::Node &parent = SceneGraph::NONE);
+        void pop(const SceneGraph::Node &id);
+        bool setParent(const SceneGraph::Node &id, const SceneGraph::Node &parent);
+
+        void update();
+
+        void attach(SceneModel *const model, const SceneGraph::Node &id);
+        void attach(SceneLight *const light, const SceneGraph::Node &id);
+        void attach(SceneCamera *const scene_cam, const SceneGraph::Node &id);
+        void detach(SceneModel *const model);
+        void detach(SceneLight *const light);
+        void detach(SceneCamera *const scene_cam);
+
+        void setPosition(const SceneGraph::Node &id, const glm::vec3 &position);
+        void setRotation(const SceneGraph::Node &id, const glm::vec3 &angles);
+        void setRotation(const SceneGraph::Node &id, const glm::quat &rotation);
+        void setScale(const SceneGraph::Node &id, const glm::vec3 &scale);
+        void setLabel(const SceneGraph::Node &id, const std::string &label);
+
+        bool contains(const SceneGraph::Node &id) const;
+        bool isAncestor(const SceneGraph::Node &ancestor, const SceneGraph::Node &id) const;
+
+        glm::vec3 getPosition(const SceneGraph::Node &id) const;
+        glm::vec3 getRotationAngles(const SceneGraph::Node &id) const;
+        glm::quat getRotationQuaternion(const SceneGraph::Node &id) const;
+        glm::vec3 getScale(const SceneGraph::Node &id) const;
+        glm::mat4 getWorldMatrix(const SceneGraph::Node &id) const;
+        std::string getLabel(const SceneGraph::Node &id) const;
+
+        SceneGraph::Node getParent(const SceneGraph::Node &id) const;
+        SceneGraph::Node getNode(const SceneModel *const model) const;
+        SceneGraph::Node getNode(const SceneLight *const light) const;
+        SceneGraph::Node getNode(const SceneCamera *const scene_cam) const;
+
+        std::size_t getNodes() const;
+        std::size_t getUpdatedNodes() const;
+        SceneGraph::Node getID(const std::size_t &index) const;
+        std::size_t getDepth(const std::size_t &index) const;
+        std::size_t getSubtree(const std::size_t &index) const;
+
+        const std::vector<SceneModel *> &getModels(const SceneGraph::Node &id) const;
+        const std::vector<SceneLight *> &getLights(const SceneGraph::Node &id) const;
+        const std::vector<SceneCamera *> &getCameras(const SceneGraph::Node &id) const;
+};
+
+#endif // __SCENE_GRAPH_HPP_
@@ -9,7 +9,7 @@ constexpr const glm::vec3 SceneLight::BLACK;
 
 // Static variables declaration
 std::uint32_t SceneLight::count = 0U;
-std::unordered_set<std::uint32_t> SceneLight::stock;
+std::map<std::uint32_t, SceneLight *> SceneLight::stock;
 
 const SceneCamera *const *SceneLight::camera = nullptr;
 SceneProgram *SceneLight::default_program = nullptr;
@@ -21,7 +21,7 @@ SceneModel *SceneLight::model = nullptr;
 SceneLight::SceneLight(const Light::Type &light_type) : Light(light_type) {
     // Set GUI ID and store
     gui_id = SceneLight::count++;
-    SceneLight::stock.insert(gui_id);
+    SceneLight::stock[gui_id] = this;
 
     // Default label
     label = "[" + std::to_string(gui_id) + "]";
@@ -40,54 +40,21 @@ SceneLight::SceneLight(const Light::Type &light_type) : Light(light_type) {
 	scale = 0.0625F;
 }
 
-// Use light
-void SceneLight::use(GLSLProgram *const glslprogram, const bool &as_array) {
-    // Check program
-    if (!glslprogram->isValid()) return;
+// Pack the light in the texels of the light buffer
+void SceneLight::pack(glm::vec4 *const texel) const {
+    Light::pack(texel);
 
-    // Use GLSL program
-    glslprogram->use();
-
-    // Uniform name
-    std::string uniform = "light";
-
-    // Array index
-    if (as_array)
-        uniform.append("[").append(std::to_string(std::distance(SceneLight::stock.begin(), SceneLight::stock.find(gui_id)))).append("]");
-
-    // Uniform dot
-    uniform.append(".");
-
-    // Persistent values
-    glslprogram->setUniform(uniform + "type", Light::type);
-    glslprogram->setUniform(uniform + "direction", -(grabbed ? (*SceneLight::camera)->getLookDirection() : Light::direction));
-
-    glslprogram->setUniform(uniform + "ambient_level", Light::ambient_level);
-    glslprogram->setUniform(uniform + "specular_level", Light::specular_level);
-    glslprogram->setUniform(uniform + "shininess", Light::shininess);
-
-    // Non directional lights attributes
-    if (Light::type != Light::DIRECTIONAL) {
-        glslprogram->setUniform(uniform + "position", grabbed ? (*SceneLight::camera)->getPosition() : Light::position);
-        glslprogram->setUniform(uniform + "attenuation", Light::attenuation);
-
-        // Spotlights attributes
-        if (Light::type == Light::SPOTLIGHT)
-            glslprogram->setUniform(uniform + "cutoff", glm::cos(Light::cutoff));
-    }
-
-    // Light on
-    if (enabled) {
-        glslprogram->setUniform(uniform + "ambient", Light::ambient);
-        glslprogram->setUniform(uniform + "diffuse", Light::diffuse);
-        glslprogram->setUniform(uniform + "specular", Light::specular);
+    // Grabbed lights follow the camera
+    if (grabbed) {
+        texel[0] = glm::vec4((*SceneLight::camera)->getPosition(), texel[0].w);
+        texel[1] = glm::vec4(-(*SceneLight::camera)->getLookDirection(), texel[1].w);
     }
 
     // Light off
-    else {
-        glslprogram->setUniform(uniform + "ambient", SceneLight::BLACK);
-        glslprogram->setUniform(uniform + "diffuse", SceneLight::BLACK);
-        glslprogram->setUniform(uniform + "specular", SceneLight::BLACK);
+    if (!enabled) {
+        texel[2] = glm::vec4(SceneLight::BLACK, texel[2].w);
+        texel[3] = glm::vec4(SceneLight::BLACK, texel[3].w);
+        texel[4] = glm::vec4(SceneLight::BLACK, texel[4].w);
     }
 }
 
@@ -242,6 +209,49 @@ std::size_t SceneLight::getNumberOfLights() {
     return SceneLight::stock.size();
 }
 
+// Get the number of lights of a type
+std::size_t SceneLight::getNumberOfLights(const Light::Type &type) {
+    std::size_t count = 0U;
+    for (const std::pair<const std::uint32_t, SceneLight *> &light : SceneLight::stock)
+        count += (light.second->getType() == type);
+
+    return count;
+}
+
+// Get the shader defines of the number of directional lights and the clustered light types
+std::string SceneLight::getDefines() {
+    std::string defines = "#define VARIANT\n"
+        "#define DIRECTIONAL_LIGHTS " + std::to_string(SceneLight::getNumberOfLights(Light::DIRECTIONAL)) + "U\n";
+
+    if (SceneLight::getNumberOfLights(Light::POINT) > 0U)
+        defines.append("#define HAS_POINT_LIGHTS\n");
+    if (SceneLight::getNumberOfLights(Light::SPOTLIGHT) > 0U)
+        defines.append("#define HAS_SPOT_LIGHTS\n");
+
+    return defines;
+}
+
+// Pack all the lights, the directional ones first, and get the number of directional lights and optionally their order
+std::size_t SceneLight::packAll(std::vector<glm::vec4> &data, std::vector<SceneLight *> *const order) {
+    data.clear();
+    data.reserve(SceneLight::stock.size() * LightGrid::TEXELS);
+    if (order != nullptr)
+        order->clear();
+
+    std::size_t directional = 0U;
+    for (const bool first : {true, false})
+        for (const std::pair<const std::uint32_t, SceneLight *> &light : SceneLight::stock)
+            if ((light.second->getType() == Light::DIRECTIONAL) == first) {
+                data.resize(data.size() + LightGrid::TEXELS);
+                light.second->pack(&data[data.size() - LightGrid::TEXELS]);
+                directional += first;
+                if (order != nullptr)
+                    order->push_back(light.second);
+            }
+
+    return directional;
+}
+
 // Get the camera
 const SceneCamera *const SceneLight::getCamera() {
 	return *SceneLight::camera;
@@ -2,6 +2,7 @@
 #define __SCENE_LIGHT_HPP_
 
 #include "../light.hpp"
+#include "../lightgrid.hpp"
 
 #include "scenecamera.hpp"
 #include "sceneprogram.hpp"
@@ -10,7 +11,9 @@
 #include <glm/glm.hpp>
 
 #include <cstdint>
-#include <unordered_set>
+#include <string>
+#include <vector>
+#include <map>
 
 
 class SceneLight : public Light {
@@ -33,7 +36,7 @@ class SceneLight : public Light {
 
 		// Static attributes
         static std::uint32_t count;
-        static std::unordered_set<std::uint32_t> stock;
+        static std::map<std::uint32_t, SceneLight *> stock;
 
 		static const SceneCamera *const *camera;
         static SceneProgram *default_program;
@@ -47,7 +50,7 @@ class SceneLight : public Light {
 	public:
 		SceneLight(const Light::Type &light_type);
 
-		void use(GLSLProgram *const glslprogram, const bool &as_array = true);
+		void pack(glm::vec4 *const texel) const;
 		void draw() const;
 
 
@@ -77,6 +80,9 @@ class SceneLight : public Light {
 		static void setModel(SceneModel *const model);
 
         static std::size_t getNumberOfLights();
+        static std::size_t getNumberOfLights(const Light::Type &type);
+        static std::string getDefines();
+        static std::size_t packAll(std::vector<glm::vec4> &data, std::vector<SceneLight *> *const order = nullptr);
 		static const SceneCamera *const getCamera();
         static SceneProgram *const getDefaultProgram();
 		static SceneProgram *const getProgram();
@@ -1,6 +1,7 @@
 #include "scenematerial.hpp"
 
 #include <stdexcept>
+#include <memory>
 
 // Static variables declaration
 std::uint32_t SceneMaterial::count = 0U;
@@ -37,44 +38,54 @@ SceneMaterial::SceneMaterial(Material *const source) {
 }
 
 // Reload texture
-void SceneMaterial::reload(const Texture::Type &texture) {
+void SceneMaterial::reload(const Texture::Type &texture, const std::function<void()> &callback) {
+    // Call back when all the requested textures have been loaded
+    std::shared_ptr<std::size_t> remaining = std::make_shared<std::size_t>(0U);
+    for (unsigned int bit = Texture::AMBIENT; bit <= Texture::STENCIL; bit <<= 1U)
+        *remaining += ((texture & bit) != 0U);
+
+    const std::function<void()> loaded = [remaining, callback]() {
+        if ((--(*remaining) == 0U) && callback)
+            callback();
+    };
+
     if (texture & Texture::AMBIENT) {
-        material->setTexture(ambient_path, Texture::AMBIENT);
+        material->setTexture(ambient_path, Texture::AMBIENT, loaded);
         ambient_label = material->getTexture(Texture::AMBIENT)->getName();
     }
 
     if (texture & Texture::DIFFUSE) {
-        material->setTexture(diffuse_path, Texture::DIFFUSE);
+        material->setTexture(diffuse_path, Texture::DIFFUSE, loaded);
         diffuse_label = material->getTexture(Texture::DIFFUSE)->getName();
     }
 
     if (texture & Texture::SPECULAR) {
-        material->setTexture(specular_path, Texture::SPECULAR);
+        material->setTexture(specular_path, Texture::SPECULAR, loaded);
         specular_label = material->getTexture(Texture::SPECULAR)->getName();
     }
 
     if (texture & Texture::SHININESS) {
-        material->setTexture(shininess_path, Texture::SHININESS);
+        material->setTexture(shininess_path, Texture::SHININESS, loaded);
         shininess_label = material->getTexture(Texture::SHININESS)->getName();
     }
 
     if (texture & Texture::ALPHA) {
-        material->setTexture(alpha_path, Texture::ALPHA);
+        material->setTexture(alpha_path, Texture::ALPHA, loaded);
         alpha_label = material->getTexture(Texture::ALPHA)->getName();
     }
 
     if (texture & Texture::BUMP) {
-        material->setTexture(bump_path, Texture::BUMP);
+        material->setTexture(bump_path, Texture::BUMP, loaded);
         bump_label = material->getTexture(Texture::BUMP)->getName();
     }
 
     if (texture & Texture::DISPLACEMENT) {
-        material->setTexture(displacement_path, Texture::DISPLACEMENT);
+        material->setTexture(displacement_path, Texture::DISPLACEMENT, loaded);
         displacement_label = material->getTexture(Texture::DISPLACEMENT)->getName();
     }
 
     if (texture & Texture::STENCIL) {
-        material->setTexture(stencil_path, Texture::STENCIL);
+        material->setTexture(stencil_path, Texture::STENCIL, loaded);
         stencil_label = material->getTexture(Texture::STENCIL)->getName();
     }
 }
@@ -3,6 +3,7 @@
 
 #include "../material.hpp"
 
+#include <functional>
 #include <string>
 #include <cstdint>
 
@@ -47,7 +48,7 @@ class SceneMaterial {
 	public:
 		SceneMaterial(Material *const source);
 
-        void reload(const Texture::Type &texture);
+        void reload(const Texture::Type &texture, const std::function<void()> &callback = nullptr);
         void reset();
 
         std::uint32_t getGUIID() const;
@@ -13,7 +13,7 @@ std::uint32_t SceneModel::count = 0U;
 
 
 // Scene model constructor
-SceneModel::SceneModel(const std::string &file_path, SceneProgram *model_program) : Model(file_path) {
+SceneModel::SceneModel(const std::string &file_path, SceneProgram *model_program, const bool &async) : Model(file_path, async) {
 	// GUI ID
 	gui_id = SceneModel::count++;
 
@@ -45,58 +45,64 @@ SceneModel::SceneModel(const std::string &file_path, SceneProgram *model_program
 }
 
 
-// Reload model
-void SceneModel::reload() {
-    // Clear model stock
-    Model::model_stock.clear();
+// Upload the loaded geometry and fill the scene material stock when the loading finishes
+bool SceneModel::updateLoading() {
+    if (!Model::updateLoading())
+        return false;
 
-    // Clear material stocks
-    std::list<Material *>::const_iterator material = Model::material_stock.begin();
-    std::list<SceneMaterial *>::const_iterator scene_material = scenematerial_stock.begin();
-    while ((material != Model::material_stock.end())) {
-        delete *material;
-        delete *scene_material;
-
-        material = Model::material_stock.erase(material);
-        scene_material = scenematerial_stock.erase(scene_material);
-    }
+    // Fill the scene material stock
+    for (Material *const &material : Model::material_stock)
+        scenematerial_stock.push_back(new SceneMaterial(material));
+
+    // Store the name of the associated material for each model
+    model_material.clear();
+    for (Model::model_data &model : Model::model_stock)
+        model_material[&model] = (model.material != nullptr ? model.material->getName() : "Default");
+
+    // Keep the textures status
+    if (!textures_enabled)
+        setTexturesEnabled(false);
 
-    // Delete buffers
-    glDeleteBuffers(1, &vbo);
-    glDeleteBuffers(1, &ebo);
+    // Notify the end of the reload
+    std::function<void()> callback;
+    callback.swap(reload_callback);
+    if (callback)
+        callback();
 
-    // Delete vertex array object
-    glDeleteVertexArrays(1, &vao);
+    return true;
+}
+
+// Reload model in background, the callback runs when the loading finishes
+void SceneModel::reload(const std::function<void()> &callback) {
+    // Store the callback
+    reload_callback = callback;
+
+    // Clear model stock
+    Model::model_stock.clear();
 
+    // Clear material stocks
+    for (Material *const &material : Model::material_stock)
+        delete material;
+    for (SceneMaterial *const &scene_material : scenematerial_stock)
+        delete scene_material;
+    Model::material_stock.clear();
+    scenematerial_stock.clear();
 
     // Reset model path, name and label
     Model::path = path;
     Model::name = path.substr(path.find_last_of(DIR_SEP) + 1);
     label = "[" + std::to_string(gui_id) + "] " + Model::name;
 
-    // Initialize attributes
-    Model::polygons = 0U;
-    Model::vertices = 0U;
-    Model::elements = 0U;
-    Model::materials = 0U;
-    Model::textures = 0U;
-    Model::min = glm::vec3(std::numeric_limits<float>::max());
-    Model::max = glm::vec3(std::numeric_limits<float>::min());
-
     // Default status
     enabled = true;
-    Model::open = false;
-    Model::material_open = false;
-
-    if (!path.empty()) {
-        try {
-            // Read file and load data to GPU
-            Model::readOBJ();
-            Model::loadData();
-            Model::open = true;
-        } catch (std::exception &exception) {
-            std::cerr << exception.what() << std::endl;
-        }
+    model_material.clear();
+
+    // Read file in background and load data to GPU as it arrives
+    Model::load(true);
+    if (!Model::loading) {
+        reload_callback = nullptr;
+        if (callback)
+            callback();
     }
 
     // Initialize matrices
@@ -104,24 +110,29 @@ void SceneModel::reload() {
 
     // Reset global material to defaults
     global_material->reset();
+}
 
-    // Fill the scene material stock
-    for (Material *const &material : Model::material_stock)
-        scenematerial_stock.push_back(new SceneMaterial(material));
+// Run the callback when the loading finishes, at once if the model is not loading
+void SceneModel::whenLoaded(const std::function<void()> &callback) {
+    if (Model::loading)
+        reload_callback = callback;
+    else if (callback)
+        callback();
 }
 
 // Reload the materials
 void SceneModel::reloadMaterial() {
+    // The materials are read when the loading finishes
+    if (Model::loading)
+        return;
+
     // Clear material stocks
-    std::list<Material *>::const_iterator material = Model::material_stock.begin();
-    std::list<SceneMaterial *>::const_iterator scene_material = scenematerial_stock.begin();
-    while (material != Model::material_stock.end()) {
-        delete *material;
-        delete *scene_material;
-
-        material = Model::material_stock.erase(material);
-        scene_material = scenematerial_stock.erase(scene_material);
-    }
+    for (Material *const &material : Model::material_stock)
+        delete material;
+    for (SceneMaterial *const &scene_material : scenematerial_stock)
+        delete scene_material;
+    Model::material_stock.clear();
+    scenematerial_stock.clear();
 
     // Reload materials
     Model::material_open = false;
@@ -208,7 +219,7 @@ SceneMaterial *SceneModel::getGlobalMaterial() const {
 }
 
 // Get the scene material stock
-std::list<SceneMaterial *> SceneModel::getMaterialStock() const {
+const std::vector<SceneMaterial *> &SceneModel::getMaterialStock() const {
 	return scenematerial_stock;
 }
 
@@ -7,9 +7,10 @@
 #include "sceneprogram.hpp"
 #include "../glslprogram.hpp"
 
+#include <functional>
 #include <cstdint>
 #include <string>
-#include <list>
+#include <vector>
 
 
 // Forward declaration of SceneProgram
@@ -36,9 +37,12 @@ class SceneModel : public Model {
 		// GLSL program
 		SceneProgram *program;
 
+		// Reload completion callback
+		std::function<void()> reload_callback;
+
 		// Scene material stock
 		SceneMaterial *global_material;
-		std::list<SceneMaterial *> scenematerial_stock;
+		std::vector<SceneMaterial *> scenematerial_stock;
         std::map<Model::model_data *, std::string> model_material;
 
 		// Disable copy and assignation
@@ -50,10 +54,13 @@ class SceneModel : public Model {
 		static std::uint32_t count;
 
 	public:
-		SceneModel(const std::string &file_path, SceneProgram *model_program = nullptr);
+		SceneModel(const std::string &file_path, SceneProgram *model_program = nullptr, const bool &async = false);
+
+		bool updateLoading();
 
-		void reload();
+		void reload(const std::function<void()> &callback = nullptr);
         void reloadMaterial();
+        void whenLoaded(const std::function<void()> &callback);
 
 		bool isEnabled() const;
         bool isScaleLocked() const;
@@ -68,7 +75,7 @@ class SceneModel : public Model {
 
 		SceneProgram *getProgram() const;
 		SceneMaterial *getGlobalMaterial() const;
-		std::list<SceneMaterial *> getMaterialStock() const;
+		const std::vector<SceneMaterial *> &getMaterialStock() const;
 
 		void setEnabled(const bool &status);
         void setScaleLocked(const bool &status);
@@ -2,9 +2,11 @@
 
 #include "../glslexception.hpp"
 #include "../shader.hpp"
+#include "../loader.hpp"
 
 #include <stdexcept>
 #include <iostream>
+#include <memory>
 
 // Static variables declaration
 std::uint32_t SceneProgram::count = 0U;
@@ -18,6 +20,8 @@ constexpr const char *const SceneProgram::ARROW;
 SceneProgram::SceneProgram() : GLSLProgram() {
     // Set GUI ID
     gui_id = SceneProgram::count++;
+    reload_job = 0U;
+    reload_program = nullptr;
 
     // Default label
     label.append("[").append(std::to_string(gui_id)).append("] Empty GLSL Program");
@@ -27,6 +31,8 @@ SceneProgram::SceneProgram() : GLSLProgram() {
 SceneProgram::SceneProgram(const std::string &vert_path, const std::string &frag_path) : GLSLProgram(vert_path, frag_path) {
     // Set GUI ID
     gui_id = SceneProgram::count++;
+    reload_job = 0U;
+    reload_program = nullptr;
 
     // Default label
     label.append("[").append(std::to_string(gui_id)).append("] ")
@@ -42,6 +48,8 @@ SceneProgram::SceneProgram(const std::string &vert_path, const std::string &frag
 SceneProgram::SceneProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path) : GLSLProgram(vert_path, geom_path, frag_path) {
     // Set GUI ID
     gui_id = SceneProgram::count++;
+    reload_job = 0U;
+    reload_program = nullptr;
 
     // Label
     label.append("[").append(std::to_string(gui_id)).append("] ")
@@ -59,6 +67,8 @@ SceneProgram::SceneProgram(const std::string &vert_path, const std::string &geom
 SceneProgram::SceneProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path) : GLSLProgram(vert_path, tesc_path, tese_path, geom_path, frag_path) {
     // Set GUI ID
     gui_id = SceneProgram::count++;
+    reload_job = 0U;
+    reload_program = nullptr;
 
     // Default label
     label.append("[").append(std::to_string(gui_id)).append("] ")
@@ -76,36 +86,54 @@ SceneProgram::SceneProgram(const std::string &vert_path, const std::string &tesc
 	frag = GLSLProgram::frag->getPath();
 }
 
-// Reload the shader
-void SceneProgram::reload() {
-	// Clear uniform locations
-	GLSLProgram::location.clear();
-
-	// Destroy program
-	glDeleteProgram(program);
-	program = GL_FALSE;
-
-    // Delete shaders
-    if (GLSLProgram::vert != nullptr) delete GLSLProgram::vert;
-    if (GLSLProgram::tesc != nullptr) delete GLSLProgram::tesc;
-    if (GLSLProgram::tese != nullptr) delete GLSLProgram::tese;
-    if (GLSLProgram::geom != nullptr) delete GLSLProgram::geom;
-    if (GLSLProgram::frag != nullptr) delete GLSLProgram::frag;
-
-	// Load shaders
-	GLSLProgram::vert = (!vert.empty() ? new Shader(vert, GL_VERTEX_SHADER)          : nullptr);
-	GLSLProgram::tesc = (!tesc.empty() ? new Shader(tesc, GL_TESS_CONTROL_SHADER)    : nullptr);
-	GLSLProgram::tese = (!tese.empty() ? new Shader(tese, GL_TESS_EVALUATION_SHADER) : nullptr);
-	GLSLProgram::geom = (!geom.empty() ? new Shader(geom, GL_GEOMETRY_SHADER)        : nullptr);
-	GLSLProgram::frag = (!frag.empty() ? new Shader(frag, GL_FRAGMENT_SHADER)        : nullptr);
+// Reload the shader without blocking, the current program is used until the new one is ready
+void SceneProgram::reload(const std::function<void()> &callback) {
+    // Cancel the previous reload
+    Loader::cancel(reload_job);
+    reload_job = 0U;
+    delete reload_program;
+    reload_program = nullptr;
+
+    // Submit the compilation in this context and poll it on later frames
+    if (GLSLProgram::isParallel() || !Loader::isEnabled()) {
+        reload_program = new GLSLProgram(vert, tesc, tese, geom, frag);
+        reload_callback = callback;
+        return;
+    }
 
+    // Compile and link the new program in the loader context
+    std::shared_ptr<GLSLProgram *> result = std::make_shared<GLSLProgram *>(nullptr);
+    const std::string vert_path = vert;
+    const std::string tesc_path = tesc;
+    const std::string tese_path = tese;
+    const std::string geom_path = geom;
+    const std::string frag_path = frag;
+
+    reload_job = Loader::push(
+        [result, vert_path, tesc_path, tese_path, geom_path, frag_path]() {
+            // The current program is kept if the new one can not be created
+            try {
+                *result = new GLSLProgram(vert_path, tesc_path, tese_path, geom_path, frag_path);
+                (*result)->wait();
+            } catch (std::exception &exception) {
+                std::cerr << exception.what() << std::endl;
+            }
+        },
+        [this, result, callback]() {
+            reload_job = 0U;
+            if (*result != nullptr)
+                replace(*result, callback);
+        },
+        [result]() {
+            delete *result;
+        });
+}
 
-    // Link program
-    try {
-        link();
-    } catch (GLSLException &exception) {
-        std::cerr << exception.what() << std::endl;
-    }
+// Take the reloaded program, reset the label and run the reload callback
+void SceneProgram::replace(GLSLProgram *const source, const std::function<void()> &callback) {
+    // Replace the program
+    GLSLProgram::assign(source);
+    delete source;
 
     // Reset label
     label.clear();
@@ -116,12 +144,22 @@ void SceneProgram::reload() {
         .append(GLSLProgram::geom != nullptr ? GLSLProgram::geom->getName() + SceneProgram::ARROW : "")
         .append(GLSLProgram::frag != nullptr ? GLSLProgram::frag->getName() : "");
 
-    // Count the number of shaders
-    shaders = (GLSLProgram::vert != nullptr)
-            + (GLSLProgram::tesc != nullptr)
-            + (GLSLProgram::tese != nullptr)
-            + (GLSLProgram::geom != nullptr)
-            + (GLSLProgram::frag != nullptr);
+    if (callback)
+        callback();
+}
+
+// Check the pending compilation of the program and the reload
+void SceneProgram::updateReload() {
+    GLSLProgram::update();
+
+    // Replace the program once the reload is ready
+    if ((reload_program != nullptr) && reload_program->update()) {
+        GLSLProgram *const source = reload_program;
+        const std::function<void()> callback = reload_callback;
+        reload_program = nullptr;
+        reload_callback = nullptr;
+        replace(source, callback);
+    }
 }
 
 
@@ -152,6 +190,11 @@ void SceneProgram::removeAllRelated() {
 }
 
 
+// Get the reloading status
+bool SceneProgram::isReloading() const {
+    return (reload_job != 0U) || (reload_program != nullptr);
+}
+
 // Get the GUI ID
 std::uint32_t SceneProgram::getGUIID() {
     return gui_id;
@@ -199,6 +242,10 @@ void SceneProgram::setDefault(SceneProgram *default_program) {
 
 // Scene program destructor
 SceneProgram::~SceneProgram() {
+    // Cancel the reload
+    Loader::cancel(reload_job);
+    delete reload_program;
+
 	// Reset GLSL program for all related models
 	for (SceneModel *const model : related_model)
 		model->setProgram(nullptr);
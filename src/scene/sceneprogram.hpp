@@ -7,6 +7,7 @@
 
 #include "../glad/glad.h"
 
+#include <functional>
 #include <string>
 #include <unordered_set>
 
@@ -31,10 +32,18 @@ class SceneProgram : public GLSLProgram {
 		// Related models
 		std::unordered_set<SceneModel *>related_model;
 
+		// Loader job or program of the reload
+		std::size_t reload_job;
+		GLSLProgram *reload_program;
+		std::function<void()> reload_callback;
+
 		// Disable copy and assignation
 		SceneProgram(const SceneProgram &) = delete;
 		SceneProgram &operator = (const SceneProgram &) = delete;
 
+		// Take the reloaded program
+		void replace(GLSLProgram *const source, const std::function<void()> &callback);
+
         // Static attributes
         static std::uint32_t count;
         static SceneProgram *default_program;
@@ -48,12 +57,15 @@ class SceneProgram : public GLSLProgram {
 		SceneProgram(const std::string &vert_path, const std::string &geom_path, const std::string &frag_path);
 		SceneProgram(const std::string &vert_path, const std::string &tesc_path, const std::string &tese_path, const std::string &geom_path, const std::string &frag_path);
 
-		void reload();
+		void reload(const std::function<void()> &callback = nullptr);
+		void updateReload();
 
 		void addRelated(SceneModel *const related);
 		void removeRelated(SceneModel *const related);
 		void removeAllRelated();
 
+        bool isReloading() const;
+
         std::uint32_t getGUIID();
         std::string &getLabel();
 		std::string &getShaderPath(const GLenum &type);
@@ -0,0 +1,229 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+// Static definitions
+Scheduler *Scheduler::default_scheduler = nullptr;
+thread_local const Scheduler *Scheduler::current = nullptr;
+thread_local std::size_t Scheduler::current_index = 0U;
+
+
+// Scheduler constructor, the calling thread helps while waiting so only threads - 1 workers are created
+Scheduler::Scheduler(const std::size_t &threads) :
+    // Queues
+    queued(0U),
+
+    // Status
+    stop(false) {
+    // Use the hardware concurrency by default
+    std::size_t total = (threads == 0U ? std::thread::hardware_concurrency() : threads);
+    total = std::max<std::size_t>(total, 1U);
+
+    // Create a deque for each worker and the external deque
+    for (std::size_t i = 0U; i < total; i++)
+        queue.emplace_back(new Scheduler::queue_data());
+
+    // Start workers
+    for (std::size_t i = 0U; i < total - 1U; i++)
+        worker.emplace_back(&Scheduler::run, this, i);
+}
+
+
+// Worker thread main loop
+void Scheduler::run(const std::size_t &index) {
+    // Identify the thread
+    Scheduler::current = this;
+    Scheduler::current_index = index;
+
+    while (true) {
+        // Execute the own or stolen tasks
+        const Scheduler::Task task = take(index);
+        if (task) {
+            execute(task);
+            continue;
+        }
+
+        // Sleep until there are queued tasks
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_condition.wait(lock, [this]() { return stop || (queued > 0U); });
+        if (stop)
+            break;
+    }
+}
+
+
+// Queue a task without pending dependencies
+void Scheduler::enqueue(const Scheduler::Task &task) {
+    // Push to the back of the current thread deque
+    {
+        Scheduler::queue_data &target = *queue[getQueueIndex()];
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.task.push_back(task);
+        queued++;
+    }
+
+    // Wake up a worker
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    sleep_condition.notify_one();
+}
+
+// Decrease the remaining dependencies of a task and queue it when they reach zero
+void Scheduler::release(const Scheduler::Task &task) {
+    if (--task->remaining == 0U)
+        enqueue(task);
+}
+
+
+// Take a task from the own deque or steal it from other
+Scheduler::Task Scheduler::take(const std::size_t &index) {
+    // Newest task of the own deque
+    {
+        Scheduler::queue_data &own = *queue[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.task.empty()) {
+            const Scheduler::Task task = own.task.back();
+            own.task.pop_back();
+            queued--;
+            return task;
+        }
+    }
+
+    // Oldest task of the other deques
+    for (std::size_t i = 1U; i < queue.size(); i++) {
+        Scheduler::queue_data &victim = *queue[(index + i) % queue.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.task.empty()) {
+            const Scheduler::Task task = victim.task.front();
+            victim.task.pop_front();
+            queued--;
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+// Execute a task and release its continuations
+void Scheduler::execute(const Scheduler::Task &task) {
+    try {
+        task->work();
+    } catch (std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+    }
+
+    // Mark as finished and take the continuations
+    std::vector<Scheduler::Task> continuation;
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->finished = true;
+        continuation.swap(task->continuation);
+    }
+
+    // Release the work to free the captures
+    task->work = nullptr;
+    for (const Scheduler::Task &next : continuation)
+        release(next);
+}
+
+
+// Deque index of the current thread
+std::size_t Scheduler::getQueueIndex() const {
+    return (Scheduler::current == this ? Scheduler::current_index : queue.size() - 1U);
+}
+
+
+// Push a task that runs when all the dependencies have finished
+Scheduler::Task Scheduler::push(const std::function<void()> &work, const std::vector<Scheduler::Task> &dependencies) {
+    // Create the task, the extra count guards against releases until all the dependencies are registered
+    const Scheduler::Task task = std::make_shared<Scheduler::task_data>();
+    task->work = work;
+    task->remaining = dependencies.size() + 1U;
+    task->finished = false;
+
+    // Register the task as continuation of the unfinished dependencies
+    for (const Scheduler::Task &dependency : dependencies) {
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (dependency->finished)
+            task->remaining--;
+        else
+            dependency->continuation.push_back(task);
+    }
+
+    // Release the guard
+    release(task);
+    return task;
+}
+
+// Wait for a task executing other tasks meanwhile
+void Scheduler::wait(const Scheduler::Task &task) {
+    const std::size_t index = getQueueIndex();
+    while (!task->finished) {
+        const Scheduler::Task other = take(index);
+        if (other)
+            execute(other);
+        else
+            std::this_thread::yield();
+    }
+}
+
+// Split a range in grain sized tasks and wait for all of them
+void Scheduler::parallelFor(const std::size_t &begin, const std::size_t &end, const std::size_t &grain, const std::function<void(const std::size_t &, const std::size_t &)> &body) {
+    if (end <= begin)
+        return;
+
+    // Run in place if there is a single range or a single thread
+    const std::size_t step = std::max<std::size_t>(grain, 1U);
+    if ((end - begin <= step) || (queue.size() == 1U)) {
+        body(begin, end);
+        return;
+    }
+
+    // Push the ranges
+    std::vector<Scheduler::Task> range;
+    for (std::size_t first = begin; first < end; first += step) {
+        const std::size_t last = std::min(first + step, end);
+        range.push_back(push([&body, first, last]() { body(first, last); }));
+    }
+
+    // Wait for all of them
+    for (const Scheduler::Task &task : range)
+        wait(task);
+}
+
+
+// Get the number of threads including the waiting thread
+std::size_t Scheduler::getThreads() const {
+    return queue.size();
+}
+
+
+// Get the default scheduler, it is created on first use if it has not been set
+Scheduler *Scheduler::getDefault() {
+    if (Scheduler::default_scheduler == nullptr)
+        Scheduler::default_scheduler = new Scheduler();
+
+    return Scheduler::default_scheduler;
+}
+
+// Set the new default scheduler
+void Scheduler::setDefault(Scheduler *const scheduler) {
+    Scheduler::default_scheduler = scheduler;
+}
+
+
+// Scheduler destructor, the pending tasks are discarded
+Scheduler::~Scheduler() {
+    // Stop workers
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stop = true;
+    }
+    sleep_condition.notify_all();
+
+    for (std::thread &thread : worker)
+        thread.join();
+}
@@ -0,0 +1,85 @@
+#ifndef __SCHEDULER_HPP_
+#define __SCHEDULER_HPP_
+
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <deque>
+
+class Scheduler {
+    private:
+        struct task_data {
+            // Work and number of unfinished dependencies plus the submission guard
+            std::function<void()> work;
+            std::atomic<std::size_t> remaining;
+
+            // Tasks released when this task finishes
+            std::mutex mutex;
+            std::atomic<bool> finished;
+            std::vector<std::shared_ptr<Scheduler::task_data> > continuation;
+        };
+
+        struct queue_data {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<Scheduler::task_data> > task;
+        };
+
+        // Worker threads and their deques, the last deque receives the tasks of external threads
+        std::vector<std::thread> worker;
+        std::vector<std::unique_ptr<Scheduler::queue_data> > queue;
+
+        // Sleep of the idle workers
+        std::mutex sleep_mutex;
+        std::condition_variable sleep_condition;
+        std::atomic<std::size_t> queued;
+        bool stop;
+
+        // Disable copy and assignation
+        Scheduler(const Scheduler &) = delete;
+        Scheduler &operator = (const Scheduler &) = delete;
+
+        // Worker thread main loop
+        void run(const std::size_t &index);
+
+        // Queue a task without pending dependencies
+        void enqueue(const std::shared_ptr<Scheduler::task_data> &task);
+
+        // Decrease the remaining dependencies of a task and queue it when they reach zero
+        void release(const std::shared_ptr<Scheduler::task_data> &task);
+
+        // Take a task from the own deque or steal it from other
+        std::shared_ptr<Scheduler::task_data> take(const std::size_t &index);
+        void execute(const std::shared_ptr<Scheduler::task_data> &task);
+
+        // Deque index of the current thread
+        std::size_t getQueueIndex() const;
+
+        // Static attributes
+        static Scheduler *default_scheduler;
+        static thread_local const Scheduler *current;
+        static thread_local std::size_t current_index;
+
+    public:
+        typedef std::shared_ptr<Scheduler::task_data> Task;
+
+        Scheduler(const std::size_t &threads = 0U);
+
+        Scheduler::Task push(const std::function<void()> &work, const std::vector<Scheduler::Task> &dependencies = {});
+
+        void wait(const Scheduler::Task &task);
+        void parallelFor(const std::size_t &begin, const std::size_t &end, const std::size_t &grain, const std::function<void(const std::size_t &, const std::size_t &)> &body);
+
+        std::size_t getThreads() const;
+
+
+        static Scheduler *getDefault();
+        static void setDefault(Scheduler *const scheduler);
+
+        ~Scheduler();
+};
+
+#endif // __SCHEDULER_HPP_
\ No newline at end of file
@@ -1,32 +1,35 @@
 #include "shader.hpp"
 #include "glslexception.hpp"
+#include "shaderpreprocessor.hpp"
 #include "dirseparator.hpp"
 
-#include <sstream>
-#include <fstream>
 #include <iostream>
 
-void Shader::load() {
+// Read the source code expanding the includes and insert the defines after the version directive
+void Shader::read(const std::string &defines) {
+    source = ShaderPreprocessor::process(path, stage, defines, files);
+}
+
+// Submit the compilation of the source code without waiting for it, the shader is compiled only once
+void Shader::submit() {
+	if (shader != GL_FALSE)
+		return;
+
 	// Create and check new shader
 	shader = glCreateShader(stage);
 	if (shader == GL_FALSE)
 		throw GLSLException("could not create the shader", path, stage);
 
-    // Open the file and check it
-    std::ifstream file(path);
-    if (!file.is_open())
-        throw GLSLException("could not open the file", path, stage);
-
-    // Read the whole file and close it
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-	const std::string content = buffer.str();
-    const char *const source = content.c_str();
-	file.close();
-
     // Compile shader source code
-    glShaderSource(shader, 1, &source, 0);
+    const char *const code = source.c_str();
+    glShaderSource(shader, 1, &code, 0);
     glCompileShader(shader);
+}
+
+// Check the compilation status, it waits for the compilation
+void Shader::check() {
+	if (shader == GL_FALSE)
+		return;
 
     // Check compilation status
     int status;
@@ -45,7 +48,7 @@ void Shader::load() {
 		if (length > 0) {
 			GLchar *log = new GLchar[length];
             glGetShaderInfoLog(shader, length, 0, log);
-			msg.append(". Log output:\n").append(log);
+			msg.append(". Log output:\n").append(ShaderPreprocessor::mapLog(log, files));
 			delete[] log;
 		}
 
@@ -59,7 +62,7 @@ void Shader::load() {
 }
 
 // Shader constructor
-Shader::Shader(const std::string &file_path, const GLenum &type) {
+Shader::Shader(const std::string &file_path, const GLenum &type, const std::string &defines) {
     // Initialize shader
     shader = GL_FALSE;
 
@@ -70,9 +73,9 @@ Shader::Shader(const std::string &file_path, const GLenum &type) {
     // Set stage
     stage = type;
 
-    // Load shader
+    // Read the source, it is compiled when the program is not in the binary cache
     try {
-        load();
+        read(defines);
     } catch (std::exception &exception) {
         std::cerr << exception.what() << std::endl;
     }
@@ -83,6 +86,16 @@ bool Shader::isValid() const {
     return shader != GL_FALSE;
 }
 
+// Get the source code
+const std::string &Shader::getSource() const {
+    return source;
+}
+
+// Get the files of the source code, the main file and its includes
+const std::vector<std::string> &Shader::getFiles() const {
+    return files;
+}
+
 // Get path
 std::string Shader::getPath() const {
     return path;
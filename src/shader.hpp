@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 #include <map>
 
 class Shader {
@@ -13,6 +14,10 @@ class Shader {
         std::string path;
         std::string name;
 
+        // Source code and its files by source string number
+        std::string source;
+        std::vector<std::string> files;
+
         // Shader ID
         GLuint shader;
 
@@ -24,13 +29,18 @@ class Shader {
         Shader(const Shader &) = delete;
         Shader &operator = (const Shader &) = delete;
 
-        // Load shader
-        void load();
+        // Read the source code
+        void read(const std::string &defines);
 
     public:
-        Shader(const std::string &file_path, const GLenum &type);
+        Shader(const std::string &file_path, const GLenum &type, const std::string &defines = "");
+
+        void submit();
+        void check();
 
         bool isValid() const;
+        const std::string &getSource() const;
+        const std::vector<std::string> &getFiles() const;
         std::string getPath() const;
         std::string getName() const;
 
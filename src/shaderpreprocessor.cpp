@@ -0,0 +1,194 @@
+#include "shaderpreprocessor.hpp"
+#include "glslexception.hpp"
+#include "dirseparator.hpp"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <regex>
+
+// Static definitions
+std::map<std::string, ShaderPreprocessor::file_data> ShaderPreprocessor::cache;
+std::mutex ShaderPreprocessor::mutex;
+
+// Static const definitions
+constexpr const unsigned int ShaderPreprocessor::MAX_DEPTH;
+
+
+// Get the source of a file from the cache, the file is read again if its modification time or size changed
+std::string ShaderPreprocessor::read(const std::string &path, const GLenum &type) {
+    // Check the file
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+        throw GLSLException("could not open the file", path, type);
+
+    // Cached source
+    std::lock_guard<std::mutex> lock(ShaderPreprocessor::mutex);
+    std::map<std::string, file_data>::const_iterator cached = ShaderPreprocessor::cache.find(path);
+    if ((cached != ShaderPreprocessor::cache.end()) && (cached->second.modified == (long long)status.st_mtime) && (cached->second.size == (long long)status.st_size))
+        return cached->second.source;
+
+    // Open the file and check it
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw GLSLException("could not open the file", path, type);
+
+    // Read the whole file
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    file_data &data = ShaderPreprocessor::cache[path];
+    data.source = buffer.str();
+    data.modified = (long long)status.st_mtime;
+    data.size = (long long)status.st_size;
+    return data.source;
+}
+
+// Expand the includes of a file, the line directives keep the line numbers of each file
+void ShaderPreprocessor::expand(const std::string &path, const GLenum &type, const std::string &defines, std::string &output, std::vector<std::string> &files, std::unordered_set<std::string> &once, const unsigned int &depth) {
+    if (depth > ShaderPreprocessor::MAX_DEPTH)
+        throw GLSLException("too many nested includes, check for recursive includes", path, type);
+
+    // Skip the files already included with #pragma once
+    if (once.find(path) != once.end())
+        return;
+
+    const std::string source = ShaderPreprocessor::read(path, type);
+
+    // The source string number of the file is its index
+    std::size_t index = std::find(files.begin(), files.end(), path) - files.begin();
+    if (index == files.size())
+        files.push_back(path);
+
+    if (depth > 0U)
+        output.append("#line 1 ").append(std::to_string(index)).append("\n");
+
+    // Directory of the included files
+    const std::size_t separator = path.find_last_of("/\\");
+    const std::string directory = (separator != std::string::npos ? path.substr(0U, separator + 1U) : "");
+
+    std::istringstream stream(source);
+    std::string line;
+    for (std::size_t number = 1U; std::getline(stream, line); number++) {
+        // Get the directive keyword and argument
+        std::string keyword;
+        std::string argument;
+        const std::size_t begin = line.find_first_not_of(" \t");
+        if ((begin != std::string::npos) && (line[begin] == '#')) {
+            std::istringstream tokens(line.substr(begin + 1U));
+            tokens >> keyword >> argument;
+        }
+
+        // Insert the defines after the version directive of the main file
+        if ((depth == 0U) && (number == 1U) && (keyword == "version")) {
+            output.append(line).append("\n").append(defines).append("#line 2 0\n");
+            continue;
+        }
+
+        // Include guard, the line is kept empty
+        if ((keyword == "pragma") && (argument == "once")) {
+            once.insert(path);
+            output.append("\n");
+            continue;
+        }
+
+        // Include the file relative to the current one
+        if (keyword == "include") {
+            const std::size_t open = line.find_first_of("\"<", begin);
+            const std::size_t close = (open != std::string::npos ? line.find(line[open] == '"' ? '"' : '>', open + 1U) : std::string::npos);
+            if (close == std::string::npos)
+                throw GLSLException("invalid include directive at line " + std::to_string(number), path, type);
+
+            ShaderPreprocessor::expand(ShaderPreprocessor::normalize(directory + line.substr(open + 1U, close - open - 1U)), type, defines, output, files, once, depth + 1U);
+            output.append("#line ").append(std::to_string(number + 1U)).append(" ").append(std::to_string(index)).append("\n");
+            continue;
+        }
+
+        output.append(line).append("\n");
+    }
+}
+
+// Resolve the dot segments of a path so each file has only one key
+std::string ShaderPreprocessor::normalize(const std::string &path) {
+    std::vector<std::string> segment;
+    std::size_t begin = 0U;
+    while (begin <= path.size()) {
+        std::size_t end = path.find_first_of("/\\", begin);
+        if (end == std::string::npos)
+            end = path.size();
+
+        const std::string name = path.substr(begin, end - begin);
+        if ((name == "..") && !segment.empty() && (segment.back() != "..") && !segment.back().empty())
+            segment.pop_back();
+        else if ((name != ".") && (!name.empty() || segment.empty()))
+            segment.push_back(name);
+
+        begin = end + 1U;
+    }
+
+    // Join the segments, an empty first segment is the root
+    std::string result;
+    for (std::size_t i = 0U; i < segment.size(); i++)
+        result.append(i > 0U ? std::string(1U, DIR_SEP) : "").append(segment[i]);
+
+    return (result.empty() && !segment.empty()) ? std::string(1U, DIR_SEP) : result;
+}
+
+
+// Read a shader and expand its includes, the files are listed by their source string number
+std::string ShaderPreprocessor::process(const std::string &path, const GLenum &type, const std::string &defines, std::vector<std::string> &files) {
+    std::string output;
+    std::unordered_set<std::string> once;
+
+    files.clear();
+    ShaderPreprocessor::expand(path, type, defines, output, files, once, 0U);
+
+    return output;
+}
+
+// Replace the source string numbers of a compilation log by the file names
+std::string ShaderPreprocessor::mapLog(const std::string &log, const std::vector<std::string> &files) {
+    // Locations as "0:12(3):" (Mesa), "0(12) :" (NVIDIA) and "ERROR: 0:12:" (AMD and Intel)
+    static const std::regex location("^(\\s*(?:ERROR|WARNING|error|warning)?:?\\s*)([0-9]+)[:(]([0-9]+)\\)?");
+
+    std::string result;
+    std::istringstream stream(log);
+    std::string line;
+    std::smatch match;
+    while (std::getline(stream, line)) {
+        if (std::regex_search(line, match, location)) {
+            const std::size_t index = std::stoul(match[2].str());
+            if (index < files.size()) {
+                result.append(match[1].str()).append(files[index]).append(":").append(match[3].str()).append(match.suffix().str()).append("\n");
+                continue;
+            }
+        }
+
+        result.append(line).append("\n");
+    }
+
+    return result;
+}
+
+
+// Remove a file from the cache
+void ShaderPreprocessor::invalidate(const std::string &path) {
+    std::lock_guard<std::mutex> lock(ShaderPreprocessor::mutex);
+    ShaderPreprocessor::cache.erase(path);
+}
+
+// Remove all the files from the cache
+void ShaderPreprocessor::clear() {
+    std::lock_guard<std::mutex> lock(ShaderPreprocessor::mutex);
+    ShaderPreprocessor::cache.clear();
+}
+
+
+// Get the number of cached files
+std::size_t ShaderPreprocessor::getCached() {
+    std::lock_guard<std::mutex> lock(ShaderPreprocessor::mutex);
+    return ShaderPreprocessor::cache.size();
+}
@@ -0,0 +1,53 @@
+#ifndef __SHADER_PREPROCESSOR_HPP_
+#define __SHADER_PREPROCESSOR_HPP_
+
+#include "glad/glad.h"
+
+#include <unordered_set>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <map>
+
+class ShaderPreprocessor {
+    private:
+        // Cached file
+        struct file_data {
+            std::string source;
+            long long modified;
+            long long size;
+        };
+
+        // Disable constructor, copy and assignation
+        ShaderPreprocessor() = delete;
+        ShaderPreprocessor(const ShaderPreprocessor &) = delete;
+        ShaderPreprocessor &operator = (const ShaderPreprocessor &) = delete;
+
+        // Get the source of a file from the cache, reading it if it changed
+        static std::string read(const std::string &path, const GLenum &type);
+
+        // Expand the includes of a file
+        static void expand(const std::string &path, const GLenum &type, const std::string &defines, std::string &output, std::vector<std::string> &files, std::unordered_set<std::string> &once, const unsigned int &depth);
+
+        // Resolve the dot segments of a path
+        static std::string normalize(const std::string &path);
+
+        // Static attributes
+        static std::map<std::string, file_data> cache;
+        static std::mutex mutex;
+
+        // Static const attributes
+        static constexpr const unsigned int MAX_DEPTH = 32U;
+
+    public:
+        static std::string process(const std::string &path, const GLenum &type, const std::string &defines, std::vector<std::string> &files);
+        static std::string mapLog(const std::string &log, const std::vector<std::string> &files);
+
+        static void invalidate(const std::string &path);
+        static void clear();
+
+        static std::size_t getCached();
+};
+
+#endif // __SHADER_PREPROCESSOR_HPP_
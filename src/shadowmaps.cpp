@@ -0,0 +1,460 @@
+#include "shadowmaps.hpp"
+#include "lightgrid.hpp"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+// Static const definitions
+constexpr const std::int32_t ShadowMaps::ATLAS;
+constexpr const std::int32_t ShadowMaps::TILE;
+constexpr const std::int32_t ShadowMaps::CASCADE;
+constexpr const std::size_t ShadowMaps::MAX_DIRECTIONAL;
+constexpr const float ShadowMaps::BORDER;
+constexpr const float ShadowMaps::SPLIT;
+constexpr const float ShadowMaps::NEAR_PLANE;
+constexpr const float ShadowMaps::MAX_RANGE;
+constexpr const char *const ShadowMaps::SAMPLER[];
+constexpr const std::size_t ShadowMaps::CASCADES;
+constexpr const std::size_t ShadowMaps::TEXELS;
+constexpr const GLenum ShadowMaps::UNIT;
+
+
+// Shadow maps constructor
+ShadowMaps::ShadowMaps() {
+    frame = 0U;
+    rendered = 0U;
+    tile_used.assign((std::size_t)((ShadowMaps::ATLAS / ShadowMaps::TILE) * (ShadowMaps::ATLAS / ShadowMaps::TILE)), 0U);
+    cascade_used.assign(ShadowMaps::MAX_DIRECTIONAL, 0U);
+
+    // Cascades of all the directional lights and atlas of the point and spot lights
+    glGenTextures(1, &cascades);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, cascades);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, ShadowMaps::CASCADE, ShadowMaps::CASCADE, (GLsizei)(ShadowMaps::CASCADES * ShadowMaps::MAX_DIRECTIONAL), 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, ShadowMaps::ATLAS, ShadowMaps::ATLAS, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+    // The samplers compare the depth with bilinear filtering
+    const GLenum targets[] = {GL_TEXTURE_2D_ARRAY, GL_TEXTURE_2D};
+    for (const GLenum &target : targets) {
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(target, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Framebuffer without color targets
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlas, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "error: the shadow maps framebuffer is not complete" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Matrices buffer, empty buffers keep one element
+    glGenBuffers(1, &buffer);
+    glGenTextures(1, &texture);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+
+// Take the free tiles of a light, the point lights take one per cube face and the directional lights a set of cascades
+bool ShadowMaps::allocate(ShadowMaps::map_data &light_map, const Light::Type &type) {
+    std::vector<std::uint8_t> &used = (type == Light::DIRECTIONAL ? cascade_used : tile_used);
+    const std::size_t count = (type == Light::POINT ? 6U : 1U);
+
+    std::vector<std::size_t> tile;
+    for (std::size_t i = 0U; (i < used.size()) && (tile.size() < count); i++)
+        if (used[i] == 0U)
+            tile.push_back(i);
+
+    if (tile.size() < count)
+        return false;
+
+    for (const std::size_t &i : tile)
+        used[i] = 1U;
+
+    const std::size_t tiles = (type == Light::DIRECTIONAL ? ShadowMaps::CASCADES : count);
+    light_map.type = type;
+    light_map.tile = tile;
+    light_map.view_projection.assign(tiles, glm::mat4(1.0F));
+    light_map.valid.assign(tiles, 0U);
+    return true;
+}
+
+// Free the tiles of a light
+void ShadowMaps::release(ShadowMaps::map_data &light_map) {
+    std::vector<std::uint8_t> &used = (light_map.type == Light::DIRECTIONAL ? cascade_used : tile_used);
+    for (const std::size_t &i : light_map.tile)
+        used[i] = 0U;
+
+    light_map.tile.clear();
+    light_map.view_projection.clear();
+    light_map.valid.clear();
+}
+
+
+// Fit the cascades to the slices of the view frustum, snapped to their texels so they do not change while the camera moves inside one
+void ShadowMaps::setCascades(ShadowMaps::map_data &light_map, const glm::vec3 &direction, const Camera *const camera) const {
+    // Corners of the view frustum, the near ones first
+    const glm::mat4 inverse = glm::inverse(camera->getProjectionMatrix() * camera->getViewMatrix());
+    glm::vec3 corner[8];
+    for (std::size_t i = 0U; i < 8U; i++) {
+        const glm::vec4 point = inverse * glm::vec4((i & 1U) ? 1.0F : -1.0F, (i & 2U) ? 1.0F : -1.0F, (i & 4U) ? 1.0F : -1.0F, 1.0F);
+        corner[i] = glm::vec3(point) / point.w;
+    }
+
+    // Light rotation without translation, the snapping is done in its space
+    const glm::vec3 up = (std::fabs(direction.y) > 0.99F ? glm::vec3(0.0F, 0.0F, 1.0F) : glm::vec3(0.0F, 1.0F, 0.0F));
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0F), direction, up);
+
+    // Practical splits, blend of the logarithmic and uniform ones
+    const glm::vec2 clip = camera->getClipping();
+    const auto split = [&clip](const std::size_t &i) {
+        const float t = (float)i / (float)ShadowMaps::CASCADES;
+        return (glm::mix(clip.x + (clip.y - clip.x) * t, clip.x * std::pow(clip.y / clip.x, t), ShadowMaps::SPLIT) - clip.x) / (clip.y - clip.x);
+    };
+
+    for (std::size_t i = 0U; i < ShadowMaps::CASCADES; i++) {
+        // Bounding sphere of the slice, the view depth is linear along the frustum edges
+        const float first = split(i);
+        const float last = split(i + 1U);
+        glm::vec3 slice[8];
+        glm::vec3 center(0.0F);
+        for (std::size_t j = 0U; j < 4U; j++) {
+            slice[j] = glm::mix(corner[j], corner[j + 4U], first);
+            slice[j + 4U] = glm::mix(corner[j], corner[j + 4U], last);
+            center += (slice[j] + slice[j + 4U]) / 8.0F;
+        }
+
+        float radius = 0.0F;
+        for (const glm::vec3 &point : slice)
+            radius = std::max(radius, glm::distance(center, point));
+        radius = std::ceil(radius * 256.0F) / 256.0F;
+
+        // Center snapped to the texels, the depth range keeps one more texel
+        const float texel = 2.0F * radius / (float)ShadowMaps::CASCADE;
+        glm::vec3 origin = glm::vec3(view * glm::vec4(center, 1.0F));
+        origin = glm::floor(origin / texel) * texel;
+
+        // The casters between the light and the slice are kept by the depth clamp
+        light_map.view_projection[i] = glm::ortho(origin.x - radius, origin.x + radius, origin.y - radius, origin.y + radius, -origin.z - radius - texel, -origin.z + radius + texel) * view;
+    }
+}
+
+// Frustums of the spotlight and of the point light cube faces
+void ShadowMaps::setFaces(ShadowMaps::map_data &light_map, const glm::vec3 &position, const glm::vec3 &direction, const float &range, const float &cutoff) const {
+    // Fields of view widened so the filter does not read the neighbour tiles
+    const float widen = (float)ShadowMaps::TILE / ((float)ShadowMaps::TILE - 2.0F * ShadowMaps::BORDER);
+    const float depth = (range > 2.0F * ShadowMaps::NEAR_PLANE ? std::min(range, ShadowMaps::MAX_RANGE) : 2.0F * ShadowMaps::NEAR_PLANE);
+
+    // Spotlight cone
+    if (light_map.type == Light::SPOTLIGHT) {
+        const float angle = std::min(std::acos(glm::clamp(cutoff, -1.0F, 1.0F)), glm::radians(80.0F));
+        const glm::vec3 up = (std::fabs(direction.y) > 0.99F ? glm::vec3(0.0F, 0.0F, 1.0F) : glm::vec3(0.0F, 1.0F, 0.0F));
+        light_map.view_projection[0] = glm::perspective(2.0F * std::atan(std::tan(angle) * widen), 1.0F, ShadowMaps::NEAR_PLANE, depth) * glm::lookAt(position, position + direction, up);
+        return;
+    }
+
+    // Cube faces in the order +X, -X, +Y, -Y, +Z and -Z
+    static const glm::vec3 axis[] = {
+        glm::vec3( 1.0F, 0.0F, 0.0F), glm::vec3(-1.0F,  0.0F, 0.0F),
+        glm::vec3( 0.0F, 1.0F, 0.0F), glm::vec3( 0.0F, -1.0F, 0.0F),
+        glm::vec3( 0.0F, 0.0F, 1.0F), glm::vec3( 0.0F,  0.0F, -1.0F)
+    };
+    static const glm::vec3 up[] = {
+        glm::vec3(0.0F, -1.0F, 0.0F), glm::vec3(0.0F, -1.0F,  0.0F),
+        glm::vec3(0.0F,  0.0F, 1.0F), glm::vec3(0.0F,  0.0F, -1.0F),
+        glm::vec3(0.0F, -1.0F, 0.0F), glm::vec3(0.0F, -1.0F,  0.0F)
+    };
+
+    const glm::mat4 projection = glm::perspective(2.0F * std::atan(widen), 1.0F, ShadowMaps::NEAR_PLANE, depth);
+    for (std::size_t i = 0U; i < 6U; i++)
+        light_map.view_projection[i] = projection * glm::lookAt(position, position + axis[i], up[i]);
+}
+
+
+// Matrix from world space to the texture space of a tile
+glm::mat4 ShadowMaps::getTextureMatrix(const ShadowMaps::map_data &light_map, const std::size_t &index) const {
+    // Cascades fill their layer
+    if (light_map.type == Light::DIRECTIONAL)
+        return glm::translate(glm::vec3(0.5F)) * glm::scale(glm::vec3(0.5F)) * light_map.view_projection[index];
+
+    // Tile rectangle in the atlas
+    const std::size_t row = (std::size_t)(ShadowMaps::ATLAS / ShadowMaps::TILE);
+    const float size = (float)ShadowMaps::TILE / (float)ShadowMaps::ATLAS;
+    const glm::vec2 center = (glm::vec2((float)(light_map.tile[index] % row), (float)(light_map.tile[index] / row)) + 0.5F) * size;
+    return glm::translate(glm::vec3(center, 0.5F)) * glm::scale(glm::vec3(0.5F * size, 0.5F * size, 0.5F)) * light_map.view_projection[index];
+}
+
+
+// Test a bounding sphere against the side and far planes of a frustum, the depth clamp keeps the casters before the near plane
+bool ShadowMaps::intersects(const glm::mat4 &view_projection, const glm::vec4 &sphere) {
+    const glm::vec4 row[] = {
+        glm::vec4(view_projection[0][0], view_projection[1][0], view_projection[2][0], view_projection[3][0]),
+        glm::vec4(view_projection[0][1], view_projection[1][1], view_projection[2][1], view_projection[3][1]),
+        glm::vec4(view_projection[0][2], view_projection[1][2], view_projection[2][2], view_projection[3][2]),
+        glm::vec4(view_projection[0][3], view_projection[1][3], view_projection[2][3], view_projection[3][3])
+    };
+    const glm::vec4 plane[] = {row[3] + row[0], row[3] - row[0], row[3] + row[1], row[3] - row[1], row[3] - row[2]};
+
+    for (const glm::vec4 &side : plane)
+        if (glm::dot(glm::vec3(side), glm::vec3(sphere)) + side.w < -sphere.w * glm::length(glm::vec3(side)))
+            return false;
+
+    return true;
+}
+
+
+// Render the tiles of the lights changed since the last update, and write the first matrix of each light in its last texel
+void ShadowMaps::update(std::vector<glm::vec4> &lights, const std::vector<Light *> &light, const std::vector<Model *> &models, GLSLProgram *const program, const Camera *const camera) {
+    rendered = 0U;
+    frame++;
+
+    // Previous and current bounds of the new, changed and removed casters
+    std::vector<glm::vec4> changed;
+    for (Model *const &model : models) {
+        std::unordered_map<const Model *, ShadowMaps::caster_data>::iterator found = caster.find(model);
+        if (found == caster.end()) {
+            const ShadowMaps::caster_data data = {model->getBoundingSphere(), frame};
+            caster[model] = data;
+            changed.push_back(data.sphere);
+        }
+
+        else {
+            if (model->isShadowDirty()) {
+                changed.push_back(found->second.sphere);
+                found->second.sphere = model->getBoundingSphere();
+                changed.push_back(found->second.sphere);
+            }
+            found->second.frame = frame;
+        }
+
+        model->setShadowDirty(false);
+    }
+
+    for (std::unordered_map<const Model *, ShadowMaps::caster_data>::iterator it = caster.begin(); it != caster.end();) {
+        if (it->second.frame == frame) {
+            it++;
+            continue;
+        }
+
+        changed.push_back(it->second.sphere);
+        it = caster.erase(it);
+    }
+
+    // The maps not used in this update are released at the end
+    for (std::pair<const Light *const, ShadowMaps::map_data> &entry : map)
+        entry.second.used = false;
+
+    matrix_data.clear();
+    bool bound = false;
+    GLint viewport[4];
+
+    for (std::size_t i = 0U; i < light.size(); i++) {
+        if (light[i] == nullptr)
+            continue;
+
+        glm::vec4 *const texel = &lights[i * LightGrid::TEXELS];
+        const Light::Type type = (Light::Type)(std::uint32_t)texel[0].w;
+        ShadowMaps::map_data &light_map = map[light[i]];
+        light_map.used = true;
+
+        // Lights changed by their setters, the grabbed ones move with the camera without them
+        bool dirty = light[i]->isShadowDirty() || (light_map.position != texel[0]) || (light_map.direction != texel[1]);
+
+        // Take the tiles again if the type has changed, the lights without free tiles have no shadows
+        if (!light_map.tile.empty() && (light_map.type != type))
+            release(light_map);
+        if (light_map.tile.empty()) {
+            if (!allocate(light_map, type))
+                continue;
+            dirty = true;
+        }
+
+        light[i]->setShadowDirty(false);
+        if (dirty) {
+            std::fill(light_map.valid.begin(), light_map.valid.end(), 0U);
+            light_map.position = texel[0];
+            light_map.direction = texel[1];
+            if (type != Light::DIRECTIONAL)
+                setFaces(light_map, glm::vec3(texel[0]), -glm::vec3(texel[1]), LightGrid::getRadius(texel), texel[5].w);
+        }
+
+        // The cascades follow the camera, only the moved ones are rendered again
+        if (type == Light::DIRECTIONAL) {
+            const std::vector<glm::mat4> previous = light_map.view_projection;
+            setCascades(light_map, -glm::vec3(texel[1]), camera);
+            for (std::size_t j = 0U; j < previous.size(); j++)
+                if (previous[j] != light_map.view_projection[j])
+                    light_map.valid[j] = 0U;
+        }
+
+        // Tiles reached by the changed casters
+        for (std::size_t j = 0U; j < light_map.valid.size(); j++)
+            for (std::size_t k = 0U; (k < changed.size()) && (light_map.valid[j] != 0U); k++)
+                if (ShadowMaps::intersects(light_map.view_projection[j], changed[k]))
+                    light_map.valid[j] = 0U;
+
+        for (std::size_t j = 0U; j < light_map.valid.size(); j++) {
+            if (light_map.valid[j] != 0U)
+                continue;
+
+            // Depth only state, the slope offset avoids the self shadowing
+            if (!bound) {
+                glGetIntegerv(GL_VIEWPORT, viewport);
+                glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+                glEnable(GL_DEPTH_CLAMP);
+                glEnable(GL_SCISSOR_TEST);
+                glEnable(GL_POLYGON_OFFSET_FILL);
+                glPolygonOffset(2.0F, 4.0F);
+                glDepthMask(GL_TRUE);
+                program->use();
+                program->setUniform("view_mat", glm::mat4(1.0F));
+                bound = true;
+            }
+
+            // Cascade layer or atlas tile
+            if (type == Light::DIRECTIONAL) {
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, cascades, 0, (GLint)(light_map.tile[0] * ShadowMaps::CASCADES + j));
+                glViewport(0, 0, ShadowMaps::CASCADE, ShadowMaps::CASCADE);
+                glScissor(0, 0, ShadowMaps::CASCADE, ShadowMaps::CASCADE);
+            }
+
+            else {
+                const std::size_t row = (std::size_t)(ShadowMaps::ATLAS / ShadowMaps::TILE);
+                const GLint x = (GLint)(light_map.tile[j] % row) * ShadowMaps::TILE;
+                const GLint y = (GLint)(light_map.tile[j] / row) * ShadowMaps::TILE;
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlas, 0);
+                glViewport(x, y, ShadowMaps::TILE, ShadowMaps::TILE);
+                glScissor(x, y, ShadowMaps::TILE, ShadowMaps::TILE);
+            }
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+            // Casters inside the tile frustum
+            program->use();
+            program->setUniform("projection_mat", light_map.view_projection[j]);
+            for (Model *const &model : models)
+                if (ShadowMaps::intersects(light_map.view_projection[j], caster[model].sphere))
+                    model->drawDepth(program);
+
+            light_map.valid[j] = 1U;
+            rendered++;
+        }
+
+        // First matrix and cascade layer of the light
+        texel[6] = glm::vec4((float)(matrix_data.size() / ShadowMaps::TEXELS), (float)(type == Light::DIRECTIONAL ? light_map.tile[0] * ShadowMaps::CASCADES : 0U), 0.0F, 0.0F);
+        for (std::size_t j = 0U; j < light_map.view_projection.size(); j++) {
+            const glm::mat4 matrix = getTextureMatrix(light_map, j);
+            matrix_data.insert(matrix_data.end(), {matrix[0], matrix[1], matrix[2], matrix[3]});
+        }
+    }
+
+    // Release the maps of the removed lights and of the lights without shadows
+    for (std::unordered_map<const Light *, ShadowMaps::map_data>::iterator it = map.begin(); it != map.end();) {
+        if (it->second.used) {
+            it++;
+            continue;
+        }
+
+        release(it->second);
+        it = map.erase(it);
+    }
+
+    // Restore the state of the scene passes
+    if (bound) {
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glDisable(GL_SCISSOR_TEST);
+        glDisable(GL_DEPTH_CLAMP);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    }
+
+    // Orphan the previous matrices
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)std::max(matrix_data.size(), (std::size_t)1U) * (GLsizeiptr)sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+    if (!matrix_data.empty())
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, (GLsizeiptr)(matrix_data.size() * sizeof(glm::vec4)), matrix_data.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Bind the cascades, the atlas and the matrices
+void ShadowMaps::bind(GLSLProgram *const program) const {
+    if (!program->isValid())
+        return;
+
+    program->use();
+    const GLenum target[] = {GL_TEXTURE_2D_ARRAY, GL_TEXTURE_2D, GL_TEXTURE_BUFFER};
+    const GLuint name[] = {cascades, atlas, texture};
+    for (std::size_t i = 0U; i < 3U; i++) {
+        glActiveTexture(GL_TEXTURE0 + ShadowMaps::UNIT + (GLenum)i);
+        glBindTexture(target[i], name[i]);
+        program->setUniform(ShadowMaps::SAMPLER[i], (GLint)(ShadowMaps::UNIT + i));
+    }
+}
+
+
+// Get the number of tiles and cascades rendered in the last update
+std::size_t ShadowMaps::getRenderedTiles() const {
+    return rendered;
+}
+
+// Get the number of atlas tiles in use
+std::size_t ShadowMaps::getUsedTiles() const {
+    return (std::size_t)std::count(tile_used.begin(), tile_used.end(), 1U);
+}
+
+// Get the number of atlas tiles
+std::size_t ShadowMaps::getTiles() const {
+    return tile_used.size();
+}
+
+// Get the number of directional lights with cascades
+std::size_t ShadowMaps::getUsedCascades() const {
+    return (std::size_t)std::count(cascade_used.begin(), cascade_used.end(), 1U);
+}
+
+// Get the memory of the cascades and the atlas in bytes
+std::size_t ShadowMaps::getMemory() const {
+    const std::size_t cascade = (std::size_t)ShadowMaps::CASCADE * (std::size_t)ShadowMaps::CASCADE * ShadowMaps::CASCADES * ShadowMaps::MAX_DIRECTIONAL;
+    return 4U * (cascade + (std::size_t)ShadowMaps::ATLAS * (std::size_t)ShadowMaps::ATLAS);
+}
+
+
+// Check that there are texture units for the shadow samplers after the light grid ones
+bool ShadowMaps::isSupported() {
+    GLint units = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units);
+    return units >= (GLint)(ShadowMaps::UNIT + 3U);
+}
+
+// Get the defines of the shadowed variants
+std::string ShadowMaps::getDefines() {
+    return "#define SHADOWS\n#define SHADOW_CASCADES " + std::to_string(ShadowMaps::CASCADES) + "\n";
+}
+
+
+// Shadow maps destructor
+ShadowMaps::~ShadowMaps() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &cascades);
+    glDeleteTextures(1, &atlas);
+    glDeleteTextures(1, &texture);
+    glDeleteBuffers(1, &buffer);
+}
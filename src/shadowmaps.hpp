@@ -0,0 +1,111 @@
+#ifndef __SHADOW_MAPS_HPP_
+#define __SHADOW_MAPS_HPP_
+
+#include "camera.hpp"
+#include "light.hpp"
+#include "model.hpp"
+#include "glslprogram.hpp"
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ShadowMaps {
+    private:
+        // Shadow map of a light, its atlas tiles or first cascade layer, and the view projection and status of each tile
+        struct map_data {
+            Light::Type type;
+            std::vector<std::size_t> tile;
+            std::vector<glm::mat4> view_projection;
+            std::vector<std::uint8_t> valid;
+            glm::vec4 position;
+            glm::vec4 direction;
+            bool used;
+        };
+
+        // Bounding sphere of a caster when the maps were updated and last frame where it was a caster
+        struct caster_data {
+            glm::vec4 sphere;
+            std::size_t frame;
+        };
+
+        // Disable copy and assignation
+        ShadowMaps(const ShadowMaps &) = delete;
+        ShadowMaps &operator = (const ShadowMaps &) = delete;
+
+        // Framebuffer, cascades array, atlas, and matrices buffer and its buffer texture
+        GLuint fbo;
+        GLuint cascades;
+        GLuint atlas;
+        GLuint buffer;
+        GLuint texture;
+
+        // Maps of the lights, used atlas tiles and used cascades
+        std::unordered_map<const Light *, ShadowMaps::map_data> map;
+        std::vector<std::uint8_t> tile_used;
+        std::vector<std::uint8_t> cascade_used;
+
+        // Casters of the last update
+        std::unordered_map<const Model *, ShadowMaps::caster_data> caster;
+        std::size_t frame;
+
+        // Matrices from world space to each tile texture space
+        std::vector<glm::vec4> matrix_data;
+
+        // Tiles rendered in the last update
+        std::size_t rendered;
+
+        // Allocate and release the tiles of a map
+        bool allocate(ShadowMaps::map_data &light_map, const Light::Type &type);
+        void release(ShadowMaps::map_data &light_map);
+
+        // View projection matrices of the tiles
+        void setCascades(ShadowMaps::map_data &light_map, const glm::vec3 &direction, const Camera *const camera) const;
+        void setFaces(ShadowMaps::map_data &light_map, const glm::vec3 &position, const glm::vec3 &direction, const float &range, const float &cutoff) const;
+
+        // Texture matrix of a tile
+        glm::mat4 getTextureMatrix(const ShadowMaps::map_data &light_map, const std::size_t &index) const;
+
+        // Static methods
+        static bool intersects(const glm::mat4 &view_projection, const glm::vec4 &sphere);
+
+        // Static const attributes
+        static constexpr const std::int32_t ATLAS = 4096;
+        static constexpr const std::int32_t TILE = 512;
+        static constexpr const std::int32_t CASCADE = 1024;
+        static constexpr const std::size_t MAX_DIRECTIONAL = 2U;
+        static constexpr const float BORDER = 2.0F;
+        static constexpr const float SPLIT = 0.75F;
+        static constexpr const float NEAR_PLANE = 0.01F;
+        static constexpr const float MAX_RANGE = 100.0F;
+        static constexpr const char *const SAMPLER[] = {"shadow_cascades", "shadow_atlas", "shadow_data"};
+
+    public:
+        // Cascades of each directional light, texels per matrix and first texture unit
+        static constexpr const std::size_t CASCADES = 4U;
+        static constexpr const std::size_t TEXELS = 4U;
+        static constexpr const GLenum UNIT = 16U;
+
+        ShadowMaps();
+
+        void update(std::vector<glm::vec4> &lights, const std::vector<Light *> &light, const std::vector<Model *> &models, GLSLProgram *const program, const Camera *const camera);
+        void bind(GLSLProgram *const program) const;
+
+        std::size_t getRenderedTiles() const;
+        std::size_t getUsedTiles() const;
+        std::size_t getTiles() const;
+        std::size_t getUsedCascades() const;
+        std::size_t getMemory() const;
+
+
+        static bool isSupported();
+        static std::string getDefines();
+
+        ~ShadowMaps();
+};
+
+#endif // __SHADOW_MAPS_HPP_
@@ -0,0 +1,226 @@
+#ifndef __SLOT_MAP_HPP_
+#define __SLOT_MAP_HPP_
+
+#include <cstdint>
+#include <vector>
+
+template <typename T>
+class SlotMap {
+    public:
+        // Stable reference to an element, the generation tells apart the elements that reused the same slot
+        struct Handle {
+            std::uint32_t index;
+            std::uint32_t generation;
+
+            Handle(const std::uint32_t &slot_index = SlotMap::NONE, const std::uint32_t &slot_generation = 0U) : index(slot_index), generation(slot_generation) {}
+
+            bool operator == (const Handle &handle) const { return (index == handle.index) && (generation == handle.generation); }
+            bool operator != (const Handle &handle) const { return !(*this == handle); }
+        };
+
+        typedef typename std::vector<T>::iterator iterator;
+        typedef typename std::vector<T>::const_iterator const_iterator;
+
+    private:
+        // Position of the element in the dense array, or the next free slot, and current generation of the slot
+        struct slot_data {
+            std::uint32_t position;
+            std::uint32_t generation;
+        };
+
+        // Dense elements and the slot of each one
+        std::vector<T> element;
+        std::vector<std::uint32_t> owner;
+
+        // Slots and head of the free slots list
+        std::vector<SlotMap::slot_data> slot;
+        std::uint32_t free_slot;
+
+        // Static const attributes
+        static constexpr const std::uint32_t NONE = 0xFFFFFFFFU;
+
+    public:
+        SlotMap();
+
+        SlotMap::Handle insert(const T &value);
+        bool erase(const SlotMap::Handle &handle);
+        void clear();
+        void reserve(const std::size_t &capacity);
+
+        T *find(const SlotMap::Handle &handle);
+        const T *find(const SlotMap::Handle &handle) const;
+        bool contains(const SlotMap::Handle &handle) const;
+
+        SlotMap::Handle getHandle(const std::size_t &position) const;
+        std::size_t getPosition(const SlotMap::Handle &handle) const;
+
+        T &operator [] (const std::size_t &position);
+        const T &operator [] (const std::size_t &position) const;
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        std::size_t size() const;
+        bool empty() const;
+};
+
+
+// Static const definitions
+template <typename T>
+constexpr const std::uint32_t SlotMap<T>::NONE;
+
+
+// Slot map constructor
+template <typename T>
+SlotMap<T>::SlotMap() : free_slot(SlotMap::NONE) {}
+
+
+// Append the element to the dense array and take a free slot, or a new one if there is none
+template <typename T>
+typename SlotMap<T>::Handle SlotMap<T>::insert(const T &value) {
+    std::uint32_t index = free_slot;
+    if (index != SlotMap::NONE)
+        free_slot = slot[index].position;
+
+    // The generations start at one, so the default handle never matches a slot
+    else {
+        index = (std::uint32_t)slot.size();
+        slot.push_back(SlotMap::slot_data{SlotMap::NONE, 1U});
+    }
+
+    slot[index].position = (std::uint32_t)element.size();
+    element.push_back(value);
+    owner.push_back(index);
+
+    return SlotMap::Handle(index, slot[index].generation);
+}
+
+// Move the last element into the place of the erased one and release its slot
+template <typename T>
+bool SlotMap<T>::erase(const SlotMap::Handle &handle) {
+    if (!contains(handle))
+        return false;
+
+    // Fill the hole with the last element
+    const std::uint32_t position = slot[handle.index].position;
+    if (position + 1U != element.size()) {
+        element[position] = element.back();
+        owner[position] = owner.back();
+        slot[owner[position]].position = position;
+    }
+    element.pop_back();
+    owner.pop_back();
+
+    // Invalidate the handles of the slot and push it to the free list
+    slot[handle.index].generation++;
+    slot[handle.index].position = free_slot;
+    free_slot = handle.index;
+
+    return true;
+}
+
+// Remove all the elements, the handles of the old elements stay invalid
+template <typename T>
+void SlotMap<T>::clear() {
+    for (const std::uint32_t &index : owner) {
+        slot[index].generation++;
+        slot[index].position = free_slot;
+        free_slot = index;
+    }
+
+    element.clear();
+    owner.clear();
+}
+
+// Reserve room for the elements and their slots
+template <typename T>
+void SlotMap<T>::reserve(const std::size_t &capacity) {
+    element.reserve(capacity);
+    owner.reserve(capacity);
+    slot.reserve(capacity);
+}
+
+
+// Get the element of a handle, null if it was erased
+template <typename T>
+T *SlotMap<T>::find(const SlotMap::Handle &handle) {
+    return (contains(handle) ? &element[slot[handle.index].position] : nullptr);
+}
+
+// Get the element of a handle, null if it was erased
+template <typename T>
+const T *SlotMap<T>::find(const SlotMap::Handle &handle) const {
+    return (contains(handle) ? &element[slot[handle.index].position] : nullptr);
+}
+
+// Check if the handle references a stored element
+template <typename T>
+bool SlotMap<T>::contains(const SlotMap::Handle &handle) const {
+    return (handle.index < slot.size()) && (slot[handle.index].generation == handle.generation);
+}
+
+
+// Get the handle of the element at a position of the dense array
+template <typename T>
+typename SlotMap<T>::Handle SlotMap<T>::getHandle(const std::size_t &position) const {
+    const std::uint32_t index = owner[position];
+    return SlotMap::Handle(index, slot[index].generation);
+}
+
+// Get the position of an element in the dense array, the size if it was erased
+template <typename T>
+std::size_t SlotMap<T>::getPosition(const SlotMap::Handle &handle) const {
+    return (contains(handle) ? slot[handle.index].position : element.size());
+}
+
+
+// Get the element at a position of the dense array
+template <typename T>
+T &SlotMap<T>::operator [] (const std::size_t &position) {
+    return element[position];
+}
+
+// Get the element at a position of the dense array
+template <typename T>
+const T &SlotMap<T>::operator [] (const std::size_t &position) const {
+    return element[position];
+}
+
+
+// Iterators of the dense array
+template <typename T>
+typename SlotMap<T>::iterator SlotMap<T>::begin() {
+    return element.begin();
+}
+
+template <typename T>
+typename SlotMap<T>::iterator SlotMap<T>::end() {
+    return element.end();
+}
+
+template <typename T>
+typename SlotMap<T>::const_iterator SlotMap<T>::begin() const {
+    return element.begin();
+}
+
+template <typename T>
+typename SlotMap<T>::const_iterator SlotMap<T>::end() const {
+    return element.end();
+}
+
+
+// Get the number of elements
+template <typename T>
+std::size_t SlotMap<T>::size() const {
+    return element.size();
+}
+
+// Check if there are no elements
+template <typename T>
+bool SlotMap<T>::empty() const {
+    return element.empty();
+}
+
+#endif // __SLOT_MAP_HPP_
@@ -0,0 +1,705 @@
+#include "streammodel.hpp"
+#include "dirseparator.hpp"
+
+#include <glm/gtx/transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+// Static const definitions
+constexpr const char *const StreamModel::MAGIC;
+constexpr const std::size_t StreamModel::NONE;
+constexpr const std::size_t StreamModel::UPLOADS;
+constexpr const std::size_t StreamModel::CHUNK_TRIANGLES;
+constexpr const std::size_t StreamModel::GRID;
+constexpr const std::size_t StreamModel::PAGE_ELEMENTS;
+constexpr const std::size_t StreamModel::PAGES;
+constexpr const std::size_t StreamModel::BUFFER_BYTES;
+constexpr const std::uint64_t StreamModel::HEADER_BYTES;
+constexpr const std::uint64_t StreamModel::ENTRY_BYTES;
+
+
+// Attribute cache constructor
+StreamModel::attribute_cache::attribute_cache(const std::string &path, const std::size_t &element_stride, const std::size_t &elements) :
+    file(path, std::ios::binary),
+    stride(element_stride),
+    size(elements),
+    data(StreamModel::PAGES * StreamModel::PAGE_ELEMENTS * element_stride),
+    tag(StreamModel::PAGES, StreamModel::NONE) {
+    if (!file.is_open())
+        throw std::runtime_error("error: could not open the temporary file `" + path + "'");
+}
+
+// Get an element reading its page if it is not cached
+const char *StreamModel::attribute_cache::get(const std::size_t &element) {
+    // Page and cache slot
+    const std::size_t page = element / StreamModel::PAGE_ELEMENTS;
+    const std::size_t slot = page % StreamModel::PAGES;
+    char *const page_data = &data[slot * StreamModel::PAGE_ELEMENTS * stride];
+
+    // Read the page
+    if (tag[slot] != page) {
+        const std::size_t first = page * StreamModel::PAGE_ELEMENTS;
+        const std::size_t count = std::min(StreamModel::PAGE_ELEMENTS, size - first);
+        file.clear();
+        file.seekg((std::streamoff)(first * stride));
+        file.read(page_data, (std::streamsize)(count * stride));
+        tag[slot] = page;
+    }
+
+    return page_data + (element % StreamModel::PAGE_ELEMENTS) * stride;
+}
+
+
+// Read the chunks table
+void StreamModel::readChunks() {
+    // Open file and check the magic number
+    file.open(Model::path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("error: could not open the chunks file `" + Model::path + "'");
+
+    // File size
+    file.seekg(0, std::ios::end);
+    const std::uint64_t size = (std::uint64_t)file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    char magic[8];
+    file.read(magic, sizeof(magic));
+    if (!file || (std::memcmp(magic, StreamModel::MAGIC, sizeof(magic)) != 0))
+        throw std::runtime_error("error: `" + Model::path + "' is not a chunks file");
+
+    // Header
+    std::uint32_t chunks = 0U;
+    file.read((char *)&chunks, sizeof(chunks));
+    file.read((char *)&this->min, sizeof(glm::vec3));
+    file.read((char *)&this->max, sizeof(glm::vec3));
+
+    // The chunks table must fit in the file
+    const std::uint64_t table_end = StreamModel::HEADER_BYTES + (std::uint64_t)chunks * StreamModel::ENTRY_BYTES;
+    if (!file || (table_end > size))
+        throw std::runtime_error("error: the chunks file `" + Model::path + "' is truncated");
+
+    // Chunks table, the data of each chunk must be inside the file and fit in a slot
+    const std::uint64_t limit = 3U * StreamModel::CHUNK_TRIANGLES;
+    std::size_t max_vertices = 0U;
+    chunk_stock.resize(chunks);
+    for (StreamModel::chunk_data &chunk : chunk_stock) {
+        file.read((char *)&chunk.min, sizeof(glm::vec3));
+        file.read((char *)&chunk.max, sizeof(glm::vec3));
+        file.read((char *)&chunk.offset, sizeof(chunk.offset));
+        file.read((char *)&chunk.vertices, sizeof(chunk.vertices));
+        chunk.slot = StreamModel::NONE;
+        chunk.used = 0U;
+        chunk.visible = false;
+
+        if ((chunk.vertices > limit) || (chunk.offset < table_end) || (chunk.offset > size) || (sizeof(StreamModel::vertex_data) * (std::uint64_t)chunk.vertices > size - chunk.offset)) {
+            chunk_stock.clear();
+            throw std::runtime_error("error: the chunks file `" + Model::path + "' has a chunk out of bounds");
+        }
+
+        max_vertices = std::max(max_vertices, (std::size_t)chunk.vertices);
+    }
+
+    if (!file) {
+        chunk_stock.clear();
+        throw std::runtime_error("error: the chunks file `" + Model::path + "' is truncated");
+    }
+
+    // Every slot fits the largest chunk, bounded by the triangles limit of the chunks
+    slot_vertices = std::max(max_vertices, (std::size_t)3U);
+    for (const StreamModel::chunk_data &chunk : chunk_stock)
+        Model::polygons += chunk.vertices / 3U;
+    Model::elements = Model::polygons * 3U;
+    Model::vertices = Model::elements;
+    Model::materials = 1U;
+}
+
+// Allocate the buffer pool
+void StreamModel::loadPool() {
+    // Evict all chunks
+    for (StreamModel::chunk_data &chunk : chunk_stock)
+        chunk.slot = StreamModel::NONE;
+
+    // Number of slots that fits in the budget, none if the budget is smaller than a slot
+    const std::size_t slot_size = sizeof(StreamModel::vertex_data) * slot_vertices;
+    slot_stock.assign(std::min(budget / slot_size, chunk_stock.size()), StreamModel::NONE);
+    resident = 0U;
+
+    // Vertex array object
+    if (Model::vao == GL_FALSE)
+        glGenVertexArrays(1, &this->vao);
+    glBindVertexArray(Model::vao);
+
+    // Vertex buffer object
+    if (Model::vbo == GL_FALSE)
+        glGenBuffers(1, &this->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, Model::vbo);
+    glBufferData(GL_ARRAY_BUFFER, slot_size * slot_stock.size(), NULL, GL_DYNAMIC_DRAW);
+
+    // Position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(StreamModel::vertex_data), (void *)offsetof(StreamModel::vertex_data, position));
+    glEnableVertexAttribArray(0);
+
+    // Texture attribute
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(StreamModel::vertex_data), (void *)offsetof(StreamModel::vertex_data, uv_coord));
+    glEnableVertexAttribArray(1);
+
+    // Normal attribute
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(StreamModel::vertex_data), (void *)offsetof(StreamModel::vertex_data, normal));
+    glEnableVertexAttribArray(2);
+
+    // Unbind array object
+    glBindVertexArray(0);
+}
+
+// Load a chunk in a slot of the pool
+void StreamModel::loadChunk(const std::size_t &chunk, const std::size_t &slot) {
+    StreamModel::chunk_data &data = chunk_stock[chunk];
+
+    // Evict the previous chunk
+    if (slot_stock[slot] != StreamModel::NONE) {
+        chunk_stock[slot_stock[slot]].slot = StreamModel::NONE;
+        resident--;
+    }
+
+    // Read vertices
+    staging.resize(data.vertices);
+    file.clear();
+    file.seekg((std::streamoff)data.offset);
+    file.read((char *)staging.data(), (std::streamsize)(sizeof(StreamModel::vertex_data) * data.vertices));
+    if (!file) {
+        std::cerr << "error: could not read the chunk " << chunk << " of `" << Model::path << "'" << std::endl;
+        slot_stock[slot] = StreamModel::NONE;
+        return;
+    }
+
+    // Upload to the slot
+    const std::size_t slot_size = sizeof(StreamModel::vertex_data) * slot_vertices;
+    glBindBuffer(GL_ARRAY_BUFFER, Model::vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(slot_size * slot), (GLsizeiptr)(sizeof(StreamModel::vertex_data) * data.vertices), staging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Update residency
+    slot_stock[slot] = chunk;
+    data.slot = slot;
+    data.used = frame;
+    resident++;
+    uploaded++;
+}
+
+
+// Stream model constructor
+StreamModel::StreamModel(const std::string &file_path, const std::size_t &budget_bytes) : Model("") {
+    // Set path and name
+    Model::path = file_path;
+    Model::name = Model::path.substr(Model::path.find_last_of(DIR_SEP) + 1);
+
+    // Buffers
+    Model::vao = GL_FALSE;
+    Model::vbo = GL_FALSE;
+    Model::ebo = GL_FALSE;
+
+    // Pool and statistics
+    budget = budget_bytes;
+    slot_vertices = 3U;
+    frame = 0U;
+    resident = 0U;
+    drawn = 0U;
+    uploaded = 0U;
+
+    // Material
+    material = new Material("Default");
+
+    try {
+        readChunks();
+        loadPool();
+        Model::open = true;
+    } catch (std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+    }
+
+    // Initialize matrices
+    Model::reset();
+}
+
+// Select the chunks to keep resident and stream the missing ones
+void StreamModel::update(const Camera *const camera) {
+    frame++;
+    uploaded = 0U;
+    if (!Model::open || chunk_stock.empty())
+        return;
+
+    // Visibility of every chunk
+    cull(camera);
+
+    // Model matrix and scale
+    const glm::mat4 model_mat = Model::getModelMatrix();
+    const glm::vec3 scale = glm::abs(Model::getScale()) * Model::getOriginMatrix()[0][0];
+    const float max_scale = glm::max(glm::max(scale.x, scale.y), scale.z);
+
+    // Distance of every chunk
+    const glm::vec3 eye = camera->getPosition();
+    std::vector<std::pair<float, std::size_t> > order;
+    order.reserve(chunk_stock.size());
+    for (std::size_t i = 0; i < chunk_stock.size(); i++) {
+        const StreamModel::chunk_data &chunk = chunk_stock[i];
+        const glm::vec3 center = glm::vec3(model_mat * glm::vec4((chunk.min + chunk.max) / 2.0F, 1.0F));
+        const float radius = glm::length(chunk.max - chunk.min) / 2.0F * max_scale;
+
+        // Visible chunks first, then the nearest ones
+        const float distance = glm::max(glm::distance(eye, center) - radius, 0.0F);
+        order.push_back(std::make_pair(chunk.visible ? distance : distance + std::numeric_limits<float>::max() / 2.0F, i));
+    }
+
+    // Chunks wanted in the pool
+    const std::size_t wanted = std::min(slot_stock.size(), order.size());
+    std::partial_sort(order.begin(), order.begin() + wanted, order.end());
+    for (std::size_t i = 0; i < wanted; i++) {
+        StreamModel::chunk_data &chunk = chunk_stock[order[i].second];
+        if (chunk.slot != StreamModel::NONE)
+            chunk.used = frame;
+    }
+
+    // Stream the missing chunks by priority
+    for (std::size_t i = 0; (i < wanted) && (uploaded < StreamModel::UPLOADS); i++) {
+        const std::size_t chunk = order[i].second;
+        if (chunk_stock[chunk].slot != StreamModel::NONE)
+            continue;
+
+        // Free slot or the least recently used one
+        std::size_t slot = StreamModel::NONE;
+        std::uint64_t oldest = frame;
+        for (std::size_t s = 0; s < slot_stock.size(); s++) {
+            if (slot_stock[s] == StreamModel::NONE) {
+                slot = s;
+                break;
+            }
+
+            const std::uint64_t used = chunk_stock[slot_stock[s]].used;
+            if (used < oldest) {
+                oldest = used;
+                slot = s;
+            }
+        }
+
+        // Every slot is in use this frame
+        if (slot == StreamModel::NONE)
+            break;
+
+        loadChunk(chunk, slot);
+    }
+}
+
+// Mark the chunks inside the frustum of a camera, without changing the resident ones
+void StreamModel::cull(const Camera *const camera) {
+    // Model and view projection matrices
+    const glm::mat4 model_mat = Model::getModelMatrix();
+    const glm::mat4 vp = camera->getProjectionMatrix() * camera->getViewMatrix();
+    const glm::vec3 scale = glm::abs(Model::getScale()) * Model::getOriginMatrix()[0][0];
+    const float max_scale = glm::max(glm::max(scale.x, scale.y), scale.z);
+
+    // World frustum planes
+    glm::vec4 plane[6];
+    for (int i = 0; i < 3; i++) {
+        const glm::vec4 row(vp[0][i], vp[1][i], vp[2][i], vp[3][i]);
+        const glm::vec4 row_w(vp[0][3], vp[1][3], vp[2][3], vp[3][3]);
+        plane[2 * i]     = row_w + row;
+        plane[2 * i + 1] = row_w - row;
+    }
+    for (glm::vec4 &p : plane)
+        p /= glm::length(glm::vec3(p));
+
+    // Visibility of every chunk
+    for (StreamModel::chunk_data &chunk : chunk_stock) {
+        const glm::vec3 center = glm::vec3(model_mat * glm::vec4((chunk.min + chunk.max) / 2.0F, 1.0F));
+        const float radius = glm::length(chunk.max - chunk.min) / 2.0F * max_scale;
+
+        chunk.visible = true;
+        for (const glm::vec4 &p : plane)
+            chunk.visible &= (glm::dot(glm::vec3(p), center) + p.w + radius >= 0.0F);
+    }
+}
+
+// Draw the resident and visible chunks
+void StreamModel::draw(GLSLProgram *const program) const {
+    // Check program
+    if (!program->isValid() || !Model::open) return;
+
+    // Use GLSL program
+    program->use();
+
+    // Set model uniforms
+    program->setUniform("model_mat", Model::getModelMatrix());
+    program->setUniform("normal_mat", Model::getNormalMatrix());
+
+    // Bind material and vertex array object
+    material->use(program);
+    glBindVertexArray(Model::vao);
+
+    // Draw chunks
+    std::size_t count = 0U;
+    for (const StreamModel::chunk_data &chunk : chunk_stock) {
+        if ((chunk.slot != StreamModel::NONE) && chunk.visible) {
+            glDrawArrays(GL_TRIANGLES, (GLint)(chunk.slot * slot_vertices), (GLsizei)chunk.vertices);
+            count++;
+        }
+    }
+
+    // Unbind vertex array object
+    glBindVertexArray(0);
+
+    // Statistics
+    drawn = count;
+}
+
+
+// Set the GPU memory budget
+void StreamModel::setBudget(const std::size_t &budget_bytes) {
+    budget = budget_bytes;
+    if (Model::open)
+        loadPool();
+}
+
+
+// Get the GPU memory budget
+std::size_t StreamModel::getBudget() const {
+    return budget;
+}
+
+// Get the GPU memory allocated by the pool
+std::size_t StreamModel::getUsedMemory() const {
+    return sizeof(StreamModel::vertex_data) * slot_vertices * slot_stock.size();
+}
+
+// Get the number of slots in the pool
+std::size_t StreamModel::getSlots() const {
+    return slot_stock.size();
+}
+
+// Get the number of chunks
+std::size_t StreamModel::getChunks() const {
+    return chunk_stock.size();
+}
+
+// Get the number of resident chunks
+std::size_t StreamModel::getResidentChunks() const {
+    return resident;
+}
+
+// Get the number of chunks drawn in the last frame
+std::size_t StreamModel::getDrawnChunks() const {
+    return drawn;
+}
+
+// Get the number of chunks uploaded in the last frame
+std::size_t StreamModel::getUploadedChunks() const {
+    return uploaded;
+}
+
+
+// Read the position, texture and normal indices of a face vertex
+void StreamModel::readFaceVertex(const std::string &vertex_str, std::int32_t *const vertex_attrib) {
+    vertex_attrib[0] = vertex_attrib[1] = vertex_attrib[2] = 0;
+
+    for (std::string::size_type i = 0, begin = 0, end = 0; (i < 3) && (end != std::string::npos); i++, begin = end + 1) {
+        end = vertex_str.find('/', begin);
+
+        if (begin < vertex_str.size() && begin < end)
+            vertex_attrib[i] = std::stoi(vertex_str.substr(begin));
+    }
+}
+
+// Convert an OBJ file to a spatially chunked file in bounded memory, the temporary files are removed if it fails or is cancelled
+void StreamModel::convert(const std::string &obj_path, const std::string &chunks_path, const std::atomic<bool> *const cancel) {
+    const std::string output_path = chunks_path + ".tmp";
+    try {
+        StreamModel::convertFiles(obj_path, chunks_path, output_path, cancel);
+
+        // The rename does not replace an existing file in every platform
+        if ((std::rename(output_path.c_str(), chunks_path.c_str()) != 0) && ((std::remove(chunks_path.c_str()) != 0) || (std::rename(output_path.c_str(), chunks_path.c_str()) != 0)))
+            throw std::runtime_error("error: could not move the chunks file to `" + chunks_path + "'");
+    } catch (...) {
+        for (const char *const suffix : {".v.tmp", ".vt.tmp", ".vn.tmp", ".f.tmp", ".spill.tmp"})
+            std::remove((chunks_path + suffix).c_str());
+        std::remove(output_path.c_str());
+        throw;
+    }
+}
+
+// Write the chunks file of an OBJ file through the temporary files, checking the cancel flag while it runs
+void StreamModel::convertFiles(const std::string &obj_path, const std::string &chunks_path, const std::string &output_path, const std::atomic<bool> *const cancel) {
+    std::ifstream obj(obj_path);
+    if (!obj.is_open())
+        throw std::runtime_error("error: could not open the model `" + obj_path + "'");
+
+    // Stop when the conversion is cancelled
+    const auto check_cancel = [cancel, &obj_path]() {
+        if ((cancel != nullptr) && cancel->load(std::memory_order_relaxed))
+            throw std::runtime_error("warning: the conversion of `" + obj_path + "' has been cancelled");
+    };
+
+    // Temporary files
+    const std::string position_path = chunks_path + ".v.tmp";
+    const std::string uv_coord_path = chunks_path + ".vt.tmp";
+    const std::string normal_path   = chunks_path + ".vn.tmp";
+    const std::string face_path     = chunks_path + ".f.tmp";
+    const std::string spill_path    = chunks_path + ".spill.tmp";
+
+    // Limits and counters
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(-std::numeric_limits<float>::max());
+    std::size_t positions = 0U;
+    std::size_t uv_coords = 0U;
+    std::size_t normals = 0U;
+    std::size_t triangles = 0U;
+
+    // First pass: split the attributes and triangulate the faces
+    {
+        std::ofstream position_file(position_path, std::ios::binary);
+        std::ofstream uv_coord_file(uv_coord_path, std::ios::binary);
+        std::ofstream normal_file(normal_path, std::ios::binary);
+        std::ofstream face_file(face_path, std::ios::binary);
+        if (!position_file.is_open() || !uv_coord_file.is_open() || !normal_file.is_open() || !face_file.is_open())
+            throw std::runtime_error("error: could not create the temporary files for `" + chunks_path + "'");
+
+        std::vector<std::string> face;
+        std::string token;
+        std::string line;
+        glm::vec3 data;
+
+        while (std::getline(obj, line)) {
+            check_cancel();
+
+            // Skip comments
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            // String stream and read first token
+            std::istringstream stream(line);
+            stream >> token;
+
+            // Store vertex
+            if (token == "v") {
+                stream >> data.x >> data.y >> data.z;
+                position_file.write((const char *)&data, sizeof(glm::vec3));
+                min = glm::min(min, data);
+                max = glm::max(max, data);
+                positions++;
+            }
+
+            // Store normal
+            else if (token == "vn") {
+                stream >> data.x >> data.y >> data.z;
+                normal_file.write((const char *)&data, sizeof(glm::vec3));
+                normals++;
+            }
+
+            // Store texture coordinate
+            else if (token == "vt") {
+                stream >> data.x >> data.y;
+                uv_coord_file.write((const char *)&data, sizeof(glm::vec2));
+                uv_coords++;
+            }
+
+            // Store triangulated face
+            else if (token == "f") {
+                while (stream >> token)
+                    face.push_back(token);
+
+                std::int32_t triangle[9];
+                for (std::size_t i = 2; i < face.size(); i++) {
+                    StreamModel::readFaceVertex(face[0],     &triangle[0]);
+                    StreamModel::readFaceVertex(face[i - 1], &triangle[3]);
+                    StreamModel::readFaceVertex(face[i],     &triangle[6]);
+                    face_file.write((const char *)&triangle[0], sizeof(triangle));
+                    triangles++;
+                }
+
+                face.clear();
+            }
+        }
+    }
+    obj.close();
+
+    // Grid resolution for the target chunk size
+    const std::size_t target = std::max(triangles / StreamModel::CHUNK_TRIANGLES, (std::size_t)1U);
+    const std::size_t grid = std::min((std::size_t)std::ceil(std::cbrt((double)target)), StreamModel::GRID);
+    const std::size_t cells = grid * grid * grid;
+    const glm::vec3 cell_size = glm::max((max - min) / (float)grid, glm::vec3(std::numeric_limits<float>::epsilon()));
+
+    // Spilled blocks of cell vertices
+    struct block_data {
+        std::size_t cell;
+        std::uint64_t offset;
+        std::size_t vertices;
+    };
+    std::vector<block_data> block_stock;
+
+    // Second pass: bin the triangles in the grid cells
+    {
+        StreamModel::attribute_cache position_cache(position_path, sizeof(glm::vec3), positions);
+        StreamModel::attribute_cache uv_coord_cache(uv_coord_path, sizeof(glm::vec2), uv_coords);
+        StreamModel::attribute_cache normal_cache(normal_path, sizeof(glm::vec3), normals);
+
+        std::ifstream face_file(face_path, std::ios::binary);
+        std::ofstream spill_file(spill_path, std::ios::binary);
+        if (!face_file.is_open() || !spill_file.is_open())
+            throw std::runtime_error("error: could not open the temporary files for `" + chunks_path + "'");
+
+        std::vector<std::vector<StreamModel::vertex_data> > cell_buffer(cells);
+        std::size_t buffered = 0U;
+        std::uint64_t spilled = 0U;
+
+        std::int32_t triangle[9];
+        while (face_file.read((char *)&triangle[0], sizeof(triangle))) {
+            check_cancel();
+
+            // Build the triangle vertices
+            StreamModel::vertex_data vertex[3];
+            bool valid = true;
+            for (int i = 0; i < 3; i++) {
+                const std::int32_t *const attrib = &triangle[3 * i];
+                if ((attrib[0] < 1) || ((std::size_t)attrib[0] > positions)) {
+                    valid = false;
+                    break;
+                }
+
+                std::memcpy(&vertex[i].position, position_cache.get(attrib[0] - 1), sizeof(glm::vec3));
+                vertex[i].uv_coord = glm::vec2(0.0F);
+                vertex[i].normal = glm::vec3(0.0F);
+                if ((attrib[1] > 0) && ((std::size_t)attrib[1] <= uv_coords)) std::memcpy(&vertex[i].uv_coord, uv_coord_cache.get(attrib[1] - 1), sizeof(glm::vec2));
+                if ((attrib[2] > 0) && ((std::size_t)attrib[2] <= normals))   std::memcpy(&vertex[i].normal,   normal_cache.get(attrib[2] - 1),   sizeof(glm::vec3));
+            }
+            if (!valid) continue;
+
+            // Triangle cell by centroid
+            const glm::vec3 centroid = (vertex[0].position + vertex[1].position + vertex[2].position) / 3.0F;
+            const glm::ivec3 coord = glm::clamp(glm::ivec3((centroid - min) / cell_size), glm::ivec3(0), glm::ivec3((int)grid - 1));
+            const std::size_t cell = ((std::size_t)coord.z * grid + (std::size_t)coord.y) * grid + (std::size_t)coord.x;
+
+            // Buffer vertices
+            for (int i = 0; i < 3; i++)
+                cell_buffer[cell].push_back(vertex[i]);
+            buffered += 3U * sizeof(StreamModel::vertex_data);
+
+            // Spill the buffered cells when the buffer is full
+            if (buffered >= StreamModel::BUFFER_BYTES) {
+                for (std::size_t c = 0; c < cells; c++) {
+                    if (cell_buffer[c].empty()) continue;
+
+                    const std::size_t bytes = sizeof(StreamModel::vertex_data) * cell_buffer[c].size();
+                    spill_file.write((const char *)cell_buffer[c].data(), (std::streamsize)bytes);
+                    block_stock.push_back(block_data{c, spilled, cell_buffer[c].size()});
+                    spilled += bytes;
+                    std::vector<StreamModel::vertex_data>().swap(cell_buffer[c]);
+                }
+                buffered = 0U;
+            }
+        }
+
+        // Spill the remaining vertices
+        for (std::size_t c = 0; c < cells; c++) {
+            if (cell_buffer[c].empty()) continue;
+
+            const std::size_t bytes = sizeof(StreamModel::vertex_data) * cell_buffer[c].size();
+            spill_file.write((const char *)cell_buffer[c].data(), (std::streamsize)bytes);
+            block_stock.push_back(block_data{c, spilled, cell_buffer[c].size()});
+            spilled += bytes;
+        }
+
+        if (!spill_file)
+            throw std::runtime_error("error: could not write the temporary file `" + spill_path + "'");
+    }
+
+    // Remove the attribute files
+    std::remove(position_path.c_str());
+    std::remove(uv_coord_path.c_str());
+    std::remove(normal_path.c_str());
+    std::remove(face_path.c_str());
+
+    // Third pass: write the chunks file
+    {
+        std::ofstream output(output_path, std::ios::binary);
+        std::ifstream spill_file(spill_path, std::ios::binary);
+        if (!output.is_open() || !spill_file.is_open())
+            throw std::runtime_error("error: could not create the chunks file `" + chunks_path + "'");
+
+        // Spilled blocks in cell order
+        std::stable_sort(block_stock.begin(), block_stock.end(), [](const block_data &a, const block_data &b) { return a.cell < b.cell; });
+
+        // Split the cells in chunks of consecutive triangles up to the limit, so every chunk fits in a slot
+        struct piece_data {
+            glm::vec3 min;
+            glm::vec3 max;
+            std::uint32_t vertices;
+        };
+        std::vector<piece_data> piece_stock;
+        std::vector<StreamModel::vertex_data> buffer;
+        std::size_t cell = StreamModel::NONE;
+        for (const block_data &block : block_stock) {
+            check_cancel();
+            buffer.resize(block.vertices);
+            spill_file.seekg((std::streamoff)block.offset);
+            spill_file.read((char *)buffer.data(), (std::streamsize)(sizeof(StreamModel::vertex_data) * block.vertices));
+
+            for (const StreamModel::vertex_data &vertex : buffer) {
+                if ((block.cell != cell) || (piece_stock.back().vertices == 3U * StreamModel::CHUNK_TRIANGLES)) {
+                    piece_stock.push_back(piece_data{glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()), 0U});
+                    cell = block.cell;
+                }
+
+                piece_data &piece = piece_stock.back();
+                piece.min = glm::min(piece.min, vertex.position);
+                piece.max = glm::max(piece.max, vertex.position);
+                piece.vertices++;
+            }
+        }
+
+        if (!spill_file)
+            throw std::runtime_error("error: could not read the temporary file `" + spill_path + "'");
+
+        // Header
+        const std::uint32_t chunks = (std::uint32_t)piece_stock.size();
+        output.write(StreamModel::MAGIC, 8);
+        output.write((const char *)&chunks, sizeof(chunks));
+        output.write((const char *)&min, sizeof(glm::vec3));
+        output.write((const char *)&max, sizeof(glm::vec3));
+
+        // Chunks table
+        std::uint64_t offset = StreamModel::HEADER_BYTES + (std::uint64_t)chunks * StreamModel::ENTRY_BYTES;
+        for (const piece_data &piece : piece_stock) {
+            output.write((const char *)&piece.min, sizeof(glm::vec3));
+            output.write((const char *)&piece.max, sizeof(glm::vec3));
+            output.write((const char *)&offset, sizeof(offset));
+            output.write((const char *)&piece.vertices, sizeof(piece.vertices));
+            offset += sizeof(StreamModel::vertex_data) * piece.vertices;
+        }
+
+        // Chunks data gathered from the spilled blocks, in the same order as the table
+        for (const block_data &block : block_stock) {
+            check_cancel();
+            buffer.resize(block.vertices);
+            spill_file.seekg((std::streamoff)block.offset);
+            spill_file.read((char *)buffer.data(), (std::streamsize)(sizeof(StreamModel::vertex_data) * block.vertices));
+            output.write((const char *)buffer.data(), (std::streamsize)(sizeof(StreamModel::vertex_data) * block.vertices));
+        }
+
+        if (!output)
+            throw std::runtime_error("error: could not write the chunks file `" + chunks_path + "'");
+    }
+
+    // Remove the spill file
+    std::remove(spill_path.c_str());
+}
+
+
+// Delete stream model
+StreamModel::~StreamModel() {
+    delete material;
+}
@@ -0,0 +1,125 @@
+#ifndef __STREAM_MODEL_HPP_
+#define __STREAM_MODEL_HPP_
+
+#include "model.hpp"
+#include "material.hpp"
+#include "camera.hpp"
+#include "glslprogram.hpp"
+
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class StreamModel : public Model {
+    private:
+        struct vertex_data {
+            glm::vec3 position;
+            glm::vec2 uv_coord;
+            glm::vec3 normal;
+        };
+
+        struct chunk_data {
+            glm::vec3 min;
+            glm::vec3 max;
+            std::uint64_t offset;
+            std::uint32_t vertices;
+
+            // Residency
+            std::size_t slot;
+            std::uint64_t used;
+            bool visible;
+        };
+
+        // Direct mapped page cache over a temporary attribute file
+        struct attribute_cache {
+            std::ifstream file;
+            std::size_t stride;
+            std::size_t size;
+            std::vector<char> data;
+            std::vector<std::size_t> tag;
+
+            attribute_cache(const std::string &path, const std::size_t &element_stride, const std::size_t &elements);
+            const char *get(const std::size_t &element);
+        };
+
+        // Chunks file
+        std::ifstream file;
+        std::vector<StreamModel::chunk_data> chunk_stock;
+
+        // Buffer pool
+        std::size_t budget;
+        std::size_t slot_vertices;
+        std::vector<std::size_t> slot_stock;
+
+        // Material used for the whole model
+        Material *material;
+
+        // Upload staging data
+        std::vector<StreamModel::vertex_data> staging;
+
+        // Frame counter and statistics
+        std::uint64_t frame;
+        std::size_t resident;
+        mutable std::size_t drawn;
+        std::size_t uploaded;
+
+        // Disable copy and assignation
+        StreamModel() = delete;
+        StreamModel(const StreamModel &) = delete;
+        StreamModel &operator = (const StreamModel &) = delete;
+
+        // Read the chunks table
+        void readChunks();
+
+        // Allocate the buffer pool
+        void loadPool();
+
+        // Load a chunk in a slot of the pool
+        void loadChunk(const std::size_t &chunk, const std::size_t &slot);
+
+        // Static methods
+        static void readFaceVertex(const std::string &vertex_str, std::int32_t *const vertex_attrib);
+        static void convertFiles(const std::string &obj_path, const std::string &chunks_path, const std::string &output_path, const std::atomic<bool> *const cancel);
+
+        // Static const attributes
+        static constexpr const char *const MAGIC = "OBJVCHK1";
+        static constexpr const std::size_t NONE = static_cast<std::size_t>(-1);
+        static constexpr const std::size_t UPLOADS = 2U;
+        static constexpr const std::size_t CHUNK_TRIANGLES = 65536U;
+        static constexpr const std::size_t GRID = 16U;
+        static constexpr const std::size_t PAGE_ELEMENTS = 16384U;
+        static constexpr const std::size_t PAGES = 64U;
+        static constexpr const std::size_t BUFFER_BYTES = 64U << 20U;
+        static constexpr const std::uint64_t HEADER_BYTES = 8U + sizeof(std::uint32_t) + 2U * sizeof(glm::vec3);
+        static constexpr const std::uint64_t ENTRY_BYTES = 2U * sizeof(glm::vec3) + sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+    public:
+        StreamModel(const std::string &file_path, const std::size_t &budget_bytes = 256U << 20U);
+
+        void update(const Camera *const camera);
+        void cull(const Camera *const camera);
+        void draw(GLSLProgram *const program) const;
+
+        void setBudget(const std::size_t &budget_bytes);
+
+        std::size_t getBudget() const;
+        std::size_t getUsedMemory() const;
+        std::size_t getSlots() const;
+        std::size_t getChunks() const;
+        std::size_t getResidentChunks() const;
+        std::size_t getDrawnChunks() const;
+        std::size_t getUploadedChunks() const;
+
+
+        static void convert(const std::string &obj_path, const std::string &chunks_path, const std::atomic<bool> *const cancel = nullptr);
+
+        ~StreamModel();
+};
+
+#endif // __STREAM_MODEL_HPP_
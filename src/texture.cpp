@@ -1,4 +1,5 @@
 #include "texture.hpp"
+#include "loader.hpp"
 #include "dirseparator.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -6,11 +7,15 @@
 #include "stb/stb_image.h"
 
 #include <stdexcept>
+#include <algorithm>
 #include <iostream>
+#include <utility>
+#include <memory>
 
 // Static definition
 GLuint Texture::default_id = GL_FALSE;
 unsigned int Texture::default_count = 0;
+std::size_t Texture::total_memory = 0U;
 
 // Static constants
 const std::string Texture::AMBIENT_STR      = "Ambient";
@@ -28,6 +33,10 @@ const std::string Texture::ANY_STR          = "Any";
 Texture::Texture(const bool &load_default) {
 	// Set the dafault name
 	name = "Default";
+	id = GL_FALSE;
+	type = Texture::ANY;
+	job = 0U;
+	memory = 0U;
 
 	// Load the default texture
     if (load_default)
@@ -36,6 +45,12 @@ Texture::Texture(const bool &load_default) {
 
 // Read and load texture
 void Texture::load() {
+    id = Texture::upload(path, memory);
+    Texture::total_memory += memory;
+}
+
+// Read and upload a texture in the current context, the memory counts the whole mipmap chain
+GLuint Texture::upload(const std::string &file_path, std::size_t &memory) {
     // Image properties
     int width;
     int height;
@@ -43,15 +58,16 @@ void Texture::load() {
 
     // Open image as RGBA
     stbi_set_flip_vertically_on_load(true);
-    stbi_uc *data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    stbi_uc *data = stbi_load(file_path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
 
     // Check data
     if (data == NULL)
-        throw std::runtime_error("error: could not open the texture `" + path + "'");
+        throw std::runtime_error("error: could not open the texture `" + file_path + "'");
 
     // Generate new texture
-    glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
 
     // Texture parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -62,9 +78,22 @@ void Texture::load() {
     // Load texture and generate mipmap
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
 
     // Free memory
     stbi_image_free(data);
+
+    // Four bytes per texel in each level
+    std::size_t level_width = (std::size_t)width;
+    std::size_t level_height = (std::size_t)height;
+    memory = 4U * level_width * level_height;
+    while ((level_width > 1U) || (level_height > 1U)) {
+        level_width = std::max<std::size_t>(level_width / 2U, 1U);
+        level_height = std::max<std::size_t>(level_height / 2U, 1U);
+        memory += 4U * level_width * level_height;
+    }
+
+    return texture;
 }
 
 // Create default texture;
@@ -97,6 +126,10 @@ void Texture::loadDefault() {
 
 // Destroy texture
 void Texture::destroy() {
+    // Memory of the image
+    Texture::total_memory -= memory;
+    memory = 0U;
+
     // Non default texture
     if (id != Texture::default_id)
         glDeleteTextures(1, &id);
@@ -110,15 +143,24 @@ void Texture::destroy() {
 
 
 // Texture constructor
-Texture::Texture(const std::string &file_path, const Texture::Type &value) {
+Texture::Texture(const std::string &file_path, const Texture::Type &value, const std::function<void()> &callback) {
     // Initialize texture and type
     id = GL_FALSE;
     type = value;
+    job = 0U;
+    memory = 0U;
     
     // Set path and name
     path = file_path;
     name = path.substr(path.find_last_of(DIR_SEP) + 1);
 
+    // Load texture in the loader context using the default texture meanwhile
+    if (Loader::isEnabled()) {
+        loadDefault();
+        reload(callback);
+        return;
+    }
+
     // Load texture
     try {
         load();
@@ -126,6 +168,61 @@ Texture::Texture(const std::string &file_path, const Texture::Type &value) {
         std::cerr << exception.what() << std::endl;
         loadDefault();
     }
+
+    if (callback)
+        callback();
+}
+
+// Read and upload the image again, the current texture is kept until the new one is ready
+void Texture::reload(const std::function<void()> &callback) {
+    // Cancel the previous upload
+    Loader::cancel(job);
+    job = 0U;
+
+    // Upload in the loader context
+    if (Loader::isEnabled()) {
+        std::shared_ptr<std::pair<GLuint, std::size_t> > result = std::make_shared<std::pair<GLuint, std::size_t> >(GL_FALSE, 0U);
+        const std::string file_path = path;
+        job = Loader::push(
+            [result, file_path]() {
+                // The default texture is kept if the image can not be read
+                try {
+                    result->first = Texture::upload(file_path, result->second);
+                } catch (std::exception &exception) {
+                    std::cerr << exception.what() << std::endl;
+                }
+            },
+            [this, result, callback]() {
+                job = 0U;
+                if (result->first != GL_FALSE) {
+                    destroy();
+                    id = result->first;
+                    memory = result->second;
+                    Texture::total_memory += memory;
+                }
+                if (callback)
+                    callback();
+            },
+            [result]() {
+                glDeleteTextures(1, &result->first);
+            });
+        return;
+    }
+
+    // Upload in the current context
+    try {
+        std::size_t result_memory;
+        const GLuint result = Texture::upload(path, result_memory);
+        destroy();
+        id = result;
+        memory = result_memory;
+        Texture::total_memory += memory;
+    } catch (std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+    }
+
+    if (callback)
+        callback();
 }
 
 // Bind texture
@@ -139,6 +236,16 @@ bool Texture::isOpen() const {
     return id != GL_FALSE;
 }
 
+// Get the default texture status
+bool Texture::isDefault() const {
+    return id == Texture::default_id;
+}
+
+// Get the loading status
+bool Texture::isLoading() const {
+    return job != 0U;
+}
+
 // Get the ID
 GLuint Texture::getID() const {
 	return id;
@@ -159,12 +266,22 @@ std::string Texture::getName() const {
     return name;
 }
 
+// Get the GPU memory in bytes
+std::size_t Texture::getMemory() const {
+    return memory;
+}
+
 
 // Create a white texture
 Texture *Texture::white() {
 	return new Texture(true);
 }
 
+// Get the GPU memory in bytes of all the loaded textures
+std::size_t Texture::getTotalMemory() {
+    return Texture::total_memory;
+}
+
 // Type to string
 const std::string &Texture::to_string(const Texture::Type &value) {
     switch (value) {
@@ -184,5 +301,6 @@ const std::string &Texture::to_string(const Texture::Type &value) {
 
 // Delete texture
 Texture::~Texture() {
+    Loader::cancel(job);
     destroy();
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "glad/glad.h"
 
+#include <functional>
+#include <cstdint>
 #include <string>
 #include <map>
 
@@ -30,6 +32,12 @@ class Texture {
         GLuint id;
         Texture::Type type;
 
+        // GPU memory of the image and its mipmaps, zero for the default texture
+        std::size_t memory;
+
+        // Loader job
+        std::size_t job;
+
         // Path and name
         std::string path;
         std::string name;
@@ -44,9 +52,13 @@ class Texture {
         // Destroy texture
         void destroy();
 
+        // Read and upload a texture in the current context
+        static GLuint upload(const std::string &file_path, std::size_t &memory);
+
 		// Static variables
 		static GLuint default_id;
 		static unsigned int default_count;
+		static std::size_t total_memory;
 
         // Static const variables
         static const std::string AMBIENT_STR;
@@ -60,18 +72,23 @@ class Texture {
         static const std::string ANY_STR;
 
     public:
-        Texture(const std::string &file_path, const Texture::Type &value = Texture::ANY);
+        Texture(const std::string &file_path, const Texture::Type &value = Texture::ANY, const std::function<void()> &callback = nullptr);
 
+        void reload(const std::function<void()> &callback = nullptr);
         void bind(const GLenum &unit) const;
 
         bool isOpen() const;
+        bool isDefault() const;
+        bool isLoading() const;
 		GLuint getID() const;
         Texture::Type getType() const;
         std::string getPath() const;
         std::string getName() const;
+        std::size_t getMemory() const;
 
 
 		static Texture *white();
+        static std::size_t getTotalMemory();
         static const std::string &to_string(const Texture::Type &value);
 
         ~Texture();
@@ -0,0 +1,145 @@
+#include "transparencybuffer.hpp"
+
+#include <iostream>
+
+// Static const definitions
+constexpr const GLenum TransparencyBuffer::FORMAT[];
+constexpr const GLenum TransparencyBuffer::CHANNELS[];
+constexpr const std::size_t TransparencyBuffer::BYTES[];
+constexpr const char *const TransparencyBuffer::SAMPLER[];
+constexpr const std::size_t TransparencyBuffer::TARGETS;
+
+
+// Transparency buffer constructor
+TransparencyBuffer::TransparencyBuffer(const int &width_res, const int &height_res) {
+    width = width_res;
+    height = height_res;
+
+    // Textures sampled per pixel
+    glGenTextures((GLsizei)TransparencyBuffer::TARGETS, texture);
+    glGenTextures(1, &depth);
+    for (const GLuint &target : {texture[0], texture[1], depth}) {
+        glBindTexture(GL_TEXTURE_2D, target);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    allocate();
+
+    // Framebuffer with both targets and the depth of the opaque models
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    for (std::size_t i = 0U; i < TransparencyBuffer::TARGETS; i++)
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum)i, GL_TEXTURE_2D, texture[i], 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+
+    const GLenum attachment[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers((GLsizei)TransparencyBuffer::TARGETS, attachment);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "error: the transparency framebuffer is not complete" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // The screen triangle has no attributes
+    glGenVertexArrays(1, &vao);
+}
+
+
+// Allocate the textures with the current resolution
+void TransparencyBuffer::allocate() {
+    for (std::size_t i = 0U; i < TransparencyBuffer::TARGETS; i++) {
+        glBindTexture(GL_TEXTURE_2D, texture[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, TransparencyBuffer::FORMAT[i], width, height, 0, TransparencyBuffer::CHANNELS[i], GL_FLOAT, nullptr);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, depth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+// Start the transparent pass, the fragments are tested against the opaque depth and accumulated in any order
+void TransparencyBuffer::begin() const {
+    // Copy the depth of the opaque models
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    // Nothing accumulated and all the background revealed
+    const GLfloat accum[] = {0.0F, 0.0F, 0.0F, 1.0F};
+    const GLfloat weight[] = {0.0F, 0.0F, 0.0F, 0.0F};
+    glClearBufferfv(GL_COLOR, 0, accum);
+    glClearBufferfv(GL_COLOR, 1, weight);
+
+    // The colors and weights are added and the alpha keeps the product of the transmittances, one blend function serves both targets
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// Blend the average transparent color over the default framebuffer and restore the state of the opaque passes
+void TransparencyBuffer::composite(GLSLProgram *const program) const {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDisable(GL_DEPTH_TEST);
+    glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+
+    if (program->isValid()) {
+        program->use();
+        for (std::size_t i = 0U; i < TransparencyBuffer::TARGETS; i++) {
+            program->setUniform(TransparencyBuffer::SAMPLER[i], (GLint)i);
+            glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+            glBindTexture(GL_TEXTURE_2D, texture[i]);
+        }
+
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+    }
+
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+}
+
+
+// Get the memory of the targets in bytes
+std::size_t TransparencyBuffer::getMemory() const {
+    std::size_t bytes = 4U;
+    for (std::size_t i = 0U; i < TransparencyBuffer::TARGETS; i++)
+        bytes += TransparencyBuffer::BYTES[i];
+
+    return (std::size_t)width * (std::size_t)height * bytes;
+}
+
+
+// Set the resolution and allocate the textures again
+void TransparencyBuffer::setResolution(const int &width_res, const int &height_res) {
+    if ((width_res == width) && (height_res == height))
+        return;
+
+    width = width_res;
+    height = height_res;
+    allocate();
+}
+
+
+// Check that the default framebuffer depth can be copied to the transparency buffer
+bool TransparencyBuffer::isSupported() {
+    GLint depth_bits = 0;
+    GLint stencil_bits = 0;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depth_bits);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencil_bits);
+    return (depth_bits == 24) && (stencil_bits == 8);
+}
+
+
+// Transparency buffer destructor
+TransparencyBuffer::~TransparencyBuffer() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures((GLsizei)TransparencyBuffer::TARGETS, texture);
+    glDeleteTextures(1, &depth);
+}
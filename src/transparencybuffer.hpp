@@ -0,0 +1,54 @@
+#ifndef __TRANSPARENCY_BUFFER_HPP_
+#define __TRANSPARENCY_BUFFER_HPP_
+
+#include "glslprogram.hpp"
+
+#include "glad/glad.h"
+
+#include <string>
+
+class TransparencyBuffer {
+    private:
+        // Framebuffer, accumulation and weight targets, depth copied from the opaque passes and vertex array of the screen triangle
+        GLuint fbo;
+        GLuint texture[2];
+        GLuint depth;
+        GLuint vao;
+
+        // Resolution
+        int width;
+        int height;
+
+        // Disable copy and assignation
+        TransparencyBuffer(const TransparencyBuffer &) = delete;
+        TransparencyBuffer &operator = (const TransparencyBuffer &) = delete;
+
+        // Allocate the textures with the current resolution
+        void allocate();
+
+        // Static const attributes
+        static constexpr const GLenum FORMAT[] = {GL_RGBA16F, GL_R16F};
+        static constexpr const GLenum CHANNELS[] = {GL_RGBA, GL_RED};
+        static constexpr const std::size_t BYTES[] = {8U, 2U};
+        static constexpr const char *const SAMPLER[] = {"transparency_accum", "transparency_weight"};
+
+    public:
+        // Color targets
+        static constexpr const std::size_t TARGETS = 2U;
+
+        TransparencyBuffer(const int &width_res, const int &height_res);
+
+        void begin() const;
+        void composite(GLSLProgram *const program) const;
+
+        std::size_t getMemory() const;
+
+        void setResolution(const int &width_res, const int &height_res);
+
+
+        static bool isSupported();
+
+        ~TransparencyBuffer();
+};
+
+#endif // __TRANSPARENCY_BUFFER_HPP_